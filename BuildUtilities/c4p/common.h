@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <set>
 #include <stack>
 #include <string>
 #include <vector>
@@ -229,6 +230,12 @@ void declare_fast_var_macro(unsigned);
 void forget_fast_vars();
 void remember_fast_var(const char *);
 void new_type(const char *, pascal_type, void *, const char *);
+void begin_branch_condition();
+void end_branch_condition();
+void end_branch();
+void begin_nested_statement();
+void end_nested_statement();
+void note_procedure_call(const symbol_t *);
 
 extern symbol_t * prog_symbol;
 extern unsigned curly_brace_level;
@@ -265,6 +272,9 @@ extern bool legacy_flag;
 extern std::string integer_literal_suffix;
 extern bool relational_cast_expressions;
 extern bool other_cast_expressions;
+extern bool optimizing;
+extern std::set<std::string> hot_procedures;
+extern std::set<std::string> cold_procedures;
 
 int yyparse();
 void yyerror(const char *);
@@ -1109,6 +1109,7 @@ procedure_statement:
                   {
                     c4p_warning("`%s' is not a procedure identifier", $1->s_repr);
                   }
+                  note_procedure_call($1);
                   cppout.out_s(std::string($1->s_repr) + " (");
                   push_parameter_node (last_parameter);
                   if ($1->s_kind == PROCEDURE_IDENTIFIER)
@@ -1364,14 +1365,24 @@ conditional_statement:
 if_statement:
           IF
                 {
+                  begin_nested_statement();
                   cppout.out_s("if (");
+                  begin_branch_condition();
                 }
           boolean_expression THEN
                 {
+                  end_branch_condition();
                   cppout.out_s(")\n");
                   extra_indent += 1;
                 }
-          statement else_part
+          statement
+                {
+                  end_branch();
+                }
+          else_part
+                {
+                  end_nested_statement();
+                }
         ;
 
 else_part:
@@ -1394,6 +1405,7 @@ else_part:
 case_statement:
           CASE
                 {
+                  begin_nested_statement();
                   cppout.out_s("switch (");
                 }
           case_index OF
@@ -1405,6 +1417,7 @@ case_statement:
                 {
                   curly_brace_level -= 1;
                   cppout.out_s("}\n");
+                  end_nested_statement();
                 }
         ;
 
@@ -1465,6 +1478,7 @@ repetitive_statement:
 while_statement:
           WHILE
                 {
+                  begin_nested_statement();
                   cppout.out_s("while (");
                 }
           expression DO
@@ -1475,12 +1489,14 @@ while_statement:
           statement
                 {
                   extra_indent -= 1;
+                  end_nested_statement();
                 }
         ;
 
 repeat_statement:
           REPEAT
                 {
+                  begin_nested_statement();
                   cppout.out_s("do {\n");
                   curly_brace_level += 1;
                 }
@@ -1492,6 +1508,7 @@ repeat_statement:
           expression
                 {
                   cppout.out_s("));\n");
+                  end_nested_statement();
                 }
         ;
 
@@ -1499,6 +1516,7 @@ repeat_statement:
 for_statement:
           FOR IDENTIFIER ASSIGN
                 {
+                  begin_nested_statement();
                   cppout.out_s("C4P_FOR_BEGIN (");
                   if ($2->s_block_level == 0 && $2->s_kind == VARIABLE_IDENTIFIER && ! ($2->s_flags & S_PREDEFINED))
                   {
@@ -1532,6 +1550,7 @@ for_statement:
                     cppout.out_s(var_name_prefix);
                   }
                   cppout.out_s(std::string($2->s_repr) + ", " + ($6 > 0 ? "++" : "--") + ")\n");
+                  end_nested_statement();
                 }
         ;
 
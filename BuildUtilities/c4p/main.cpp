@@ -23,6 +23,9 @@
 #include <cstdlib>
 #include <climits>
 
+#include <fstream>
+#include <sstream>
+
 #include <getopt.h>
 
 #include "common.h"
@@ -69,6 +72,9 @@ bool legacy_flag;
 string integer_literal_suffix;
 bool relational_cast_expressions = false;
 bool other_cast_expressions = true;
+bool optimizing;
+set<string> hot_procedures;
+set<string> cold_procedures;
 
 int yyparse();
 extern int yylineno;
@@ -127,6 +133,8 @@ Options:\n\
   --class-include=FILENAME\n\
   --emit-optimize-pragmas\n\
   --entry-name=NAME\n\
+  --optimize\n\
+  --profile=FILENAME\n\
   --declare-c-type=NAME\n\
   --var-name-prefix=PREFIX\n\
   --var-struct=NAME\n\
@@ -160,6 +168,8 @@ Options:\n\
 #define OPT_DECLARE_C_TYPE 15
 #define OPT_NAMESPACE 16
 #define OPT_EMIT_OPTIMIZE_PRAGMAS 17
+#define OPT_OPTIMIZE 18
+#define OPT_PROFILE 19
 
 namespace {
   const struct option longopts[] =
@@ -182,7 +192,9 @@ namespace {
     "lines", required_argument, nullptr, 'l',
     "namespace", required_argument, nullptr, OPT_NAMESPACE,
     "one", optional_argument, nullptr, '1',
+    "optimize", no_argument, nullptr, OPT_OPTIMIZE,
     "output-prefix", required_argument, nullptr, 'p',
+    "profile", required_argument, nullptr, OPT_PROFILE,
     "rename", required_argument, nullptr, 'r',
     "using-namespace", required_argument, nullptr, OPT_USING_NAMESPACE,
     "var-name-prefix", required_argument, nullptr, OPT_VAR_NAME_PREFIX,
@@ -195,6 +207,42 @@ namespace {
   };
 }
 
+/* A profile names procedures which are known to be hot or cold, one
+   per line:
+
+     hot NAME
+     cold NAME
+
+   Empty lines and lines starting with `%' are ignored. */
+void read_profile(const char * file_name)
+{
+  ifstream stream(file_name);
+  if (!stream.is_open())
+  {
+    fprintf(stderr, T_("%s: can't open %s\n"), myname.c_str(), file_name);
+    exit(5);
+  }
+  string line;
+  unsigned line_num = 0;
+  while (getline(stream, line))
+  {
+    ++line_num;
+    istringstream words(line);
+    string kind;
+    string name;
+    if (!(words >> kind) || kind[0] == '%')
+    {
+      continue;
+    }
+    if (!(words >> name) || (kind != "hot" && kind != "cold"))
+    {
+      fprintf(stderr, T_("%s:%u: invalid profile entry\n"), file_name, line_num);
+      exit(5);
+    }
+    (kind == "hot" ? hot_procedures : cold_procedures).insert(name);
+  }
+}
+
 void option_handler(int argc, char ** argv)
 {
   myname = argv[0];
@@ -242,6 +290,12 @@ void option_handler(int argc, char ** argv)
     case OPT_EMIT_OPTIMIZE_PRAGMAS:
       emit_optimize_pragmas = true;
       break;
+    case OPT_OPTIMIZE:
+      optimizing = true;
+      break;
+    case OPT_PROFILE:
+      read_profile(optarg);
+      break;
     case OPT_ENTRY_NAME:
       entry_name = optarg;
       break;
@@ -24,6 +24,7 @@
 #include <cctype>
 #include <climits>
 #include <memory>
+#include <stack>
 
 #include "c4p-version.h"
 #include "common.h"
@@ -38,6 +39,33 @@ namespace {
   std::string current_fast_vars;
 }
 
+/* In optimizing mode, conditions of if statements are emitted with
+   room for a branch hint:
+
+     if (             (CONDITION) )
+
+   If the then part calls a cold procedure directly, i.e., not from
+   within a nested if, case or loop statement, the room is filled:
+
+     if (C4P_UNLIKELY((CONDITION)))  */
+namespace {
+  const char * const BRANCH_HINT_OPEN = "C4P_UNLIKELY(";
+  const char * const BRANCH_HINT_CLOSE = ")";
+  const unsigned BRANCH_HINT_OPEN_LEN = 13;
+  const unsigned BRANCH_HINT_CLOSE_LEN = 1;
+  struct branch_hint
+  {
+    unsigned long char_mark;
+    unsigned open_mark;
+    unsigned close_mark;
+    unsigned cold_calls;
+  };
+  std::stack<branch_hint> branch_hints;
+  // cold calls made directly in the current statement sequence
+  unsigned cold_calls;
+  std::stack<unsigned> outer_cold_calls;
+}
+
 const size_t MY_PATH_MAX = 8192;
 
 void generate_file_header()
@@ -301,6 +329,83 @@ void declare_fast_var_macro(unsigned routine_handle)
   cppout.redir_file(C_FILE_NUM);
 }
 
+void begin_branch_condition()
+{
+  if (!optimizing || cold_procedures.empty())
+  {
+    return;
+  }
+  branch_hint hint;
+  hint.char_mark = cppout.get_char_mark();
+  hint.open_mark = cppout.get_buf_mark();
+  cppout.out_s(std::string(BRANCH_HINT_OPEN_LEN, ' ') + "(");
+  branch_hints.push(hint);
+}
+
+void end_branch_condition()
+{
+  if (!optimizing || cold_procedures.empty())
+  {
+    return;
+  }
+  cppout.out_s(")");
+  branch_hints.top().close_mark = cppout.get_buf_mark();
+  cppout.out_s(std::string(BRANCH_HINT_CLOSE_LEN, ' '));
+  branch_hints.top().cold_calls = cold_calls;
+}
+
+void end_branch()
+{
+  if (!optimizing || cold_procedures.empty())
+  {
+    return;
+  }
+  branch_hint hint = branch_hints.top();
+  branch_hints.pop();
+  if (cold_calls == hint.cold_calls || !cppout.is_buffered(hint.char_mark))
+  {
+    return;
+  }
+  std::string open_text;
+  std::string close_text;
+  cppout.get_buf_text(open_text, hint.open_mark, BRANCH_HINT_OPEN_LEN);
+  cppout.get_buf_text(close_text, hint.close_mark, BRANCH_HINT_CLOSE_LEN);
+  if (open_text != std::string(BRANCH_HINT_OPEN_LEN, ' ') || close_text != std::string(BRANCH_HINT_CLOSE_LEN, ' '))
+  {
+    return;
+  }
+  cppout.out_buf_over(hint.open_mark, BRANCH_HINT_OPEN, BRANCH_HINT_OPEN_LEN);
+  cppout.out_buf_over(hint.close_mark, BRANCH_HINT_CLOSE, BRANCH_HINT_CLOSE_LEN);
+}
+
+void begin_nested_statement()
+{
+  if (!optimizing || cold_procedures.empty())
+  {
+    return;
+  }
+  outer_cold_calls.push(cold_calls);
+}
+
+void end_nested_statement()
+{
+  if (!optimizing || cold_procedures.empty())
+  {
+    return;
+  }
+  // calls in nested statements are conditional
+  cold_calls = outer_cold_calls.top();
+  outer_cold_calls.pop();
+}
+
+void note_procedure_call(const symbol_t * sym)
+{
+  if (optimizing && cold_procedures.find(sym->s_repr) != cold_procedures.end())
+  {
+    ++cold_calls;
+  }
+}
+
 void begin_routine(prototype_node * proto, unsigned handle)
 {
   cppout.redir_file(DEF_FILE_NUM);
@@ -324,6 +429,14 @@ void begin_routine(prototype_node * proto, unsigned handle)
     cppout.out_s("#pragma optimize (\"\", off)\n");
     cppout.out_s("#endif\n");
   }
+  if (optimizing && hot_procedures.find(proto->name->s_repr) != hot_procedures.end())
+  {
+    cppout.out_s("C4P_HOT");
+  }
+  else if (optimizing && cold_procedures.find(proto->name->s_repr) != cold_procedures.end())
+  {
+    cppout.out_s("C4P_COLD");
+  }
   generate_routine_head(proto);
   cppout.out_s("\n");
   cppout.out_s("{\n");
@@ -125,6 +125,7 @@ void output::put_char(int c)
   }
   out_buf[buf_ptr] = (char)c;
   buf_ptr = (buf_ptr + 1) % BUF_SIZE;
+  ++char_count;
 }
 
 void output::out_char(int c)
@@ -29,6 +29,19 @@ public:
     return buf_ptr;
   }
 
+public:
+  unsigned long get_char_mark()
+  {
+    return char_count;
+  }
+
+  // true, if nothing has been written out since char_mark was taken
+public:
+  bool is_buffered(unsigned long char_mark)
+  {
+    return char_count - char_mark <= chars_in_buf;
+  }
+
 public:
   void get_buf_text(std::string & str, unsigned buf_mark, unsigned count);
 
@@ -95,6 +108,9 @@ private:
 private:
   unsigned chars_in_buf;
 
+private:
+  unsigned long char_count;
+
 private:
   int last_char;
 };
@@ -0,0 +1,64 @@
+## branchhints.cmake: check the branch hints emitted by c4p  -*- CMake -*-
+##
+## Copyright (C) 2026 agent
+## 
+## This file is free software; you can redistribute it and/or modify
+## it under the terms of the GNU General Public License as published
+## by the Free Software Foundation; either version 2, or (at your
+## option) any later version.
+## 
+## This file is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+## General Public License for more details.
+## 
+## You should have received a copy of the GNU General Public License
+## along with this file; if not, write to the Free Software
+## Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+## USA.
+
+## Translates branchhints.p in optimizing mode and checks that exactly
+## the if statements which call the cold procedure directly in their
+## then part are hinted.
+
+cmake_minimum_required(VERSION 3.12)
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+execute_process(
+  COMMAND ${C4P} -C --def-filename=branchhintsdefs.h --one=branchhints --optimize --profile=${SOURCE_DIR}/branchhints.profile ${SOURCE_DIR}/branchhints.p
+  WORKING_DIRECTORY ${WORK_DIR}
+  RESULT_VARIABLE exit_code
+)
+if(NOT exit_code EQUAL 0)
+  message(FATAL_ERROR "c4p failed: ${exit_code}")
+endif()
+
+file(STRINGS ${WORK_DIR}/branchhints.cc conditions REGEX "if \\(")
+
+set(hinted 1 3 8)
+set(not_hinted 2 4 6 7 9 10 12)
+
+foreach(n ${hinted} ${not_hinted})
+  set(found FALSE)
+  foreach(line IN LISTS conditions)
+    if(line MATCHES "> ${n}[^0-9]")
+      set(found TRUE)
+      if(line MATCHES "C4P_UNLIKELY")
+        set(is_hinted TRUE)
+      else()
+        set(is_hinted FALSE)
+      endif()
+    endif()
+  endforeach()
+  if(NOT found)
+    message(FATAL_ERROR "condition ${n} not found")
+  endif()
+  if(n IN_LIST hinted AND NOT is_hinted)
+    message(FATAL_ERROR "condition ${n} should be hinted")
+  endif()
+  if(n IN_LIST not_hinted AND is_hinted)
+    message(FATAL_ERROR "condition ${n} should not be hinted")
+  endif()
+endforeach()
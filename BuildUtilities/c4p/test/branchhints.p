@@ -0,0 +1,44 @@
+{ branchhints.p: test input for c4p's branch hints }
+{ The conditions of the if statements are numbered: the if statements
+  with conditions 1, 3 and 8 call the cold procedure directly in their
+  then part; all others must not be hinted. }
+program branchhints;
+var i, j: integer;
+procedure oops;
+begin
+  i := 0;
+end;
+procedure direct;
+begin
+  if i > 1 then begin j := 1; oops; end;
+end;
+procedure nested;
+begin
+  if i > 2 then begin if j > 3 then oops; end;
+end;
+procedure inloop;
+begin
+  if i > 4 then while j > 5 do begin oops; j := j - 1; end;
+end;
+procedure incase;
+begin
+  if i > 6 then case j of 1: oops; 2: j := 0; end;
+end;
+procedure inelse;
+begin
+  if i > 7 then j := 0 else oops;
+end;
+procedure afternested;
+begin
+  if i > 8 then begin if j > 9 then j := 0; oops; end;
+end;
+procedure inrepeat;
+begin
+  if i > 10 then repeat oops; until j > 11;
+end;
+procedure infor;
+begin
+  if i > 12 then for j := 1 to 13 do oops;
+end;
+begin
+end.
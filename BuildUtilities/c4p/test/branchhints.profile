@@ -0,0 +1 @@
+cold oops
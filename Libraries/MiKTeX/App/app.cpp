@@ -25,6 +25,7 @@
 #include <cstdlib>
 #include <ctime>
 
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <memory>
@@ -773,23 +774,39 @@ bool Application::TryCreateFile(const PathName& fileName, FileType fileType)
   default:
     return false;
   }
-  LOG4CXX_INFO(logger, "going to create file: " << fileName);
-  ProcessOutput<50000> processOutput;
-  int exitCode;
-  args[0] = makeUtility.GetFileNameWithoutExtension().ToString();
-  if (!Process::Run(makeUtility, args, &processOutput, &exitCode, nullptr))
+  auto create = [&]()
   {
-    LOG4CXX_ERROR(logger, makeUtility << " could not be started");
-    return false;
-  }
-  if (exitCode != 0)
-  {
-    LOG4CXX_ERROR(logger, makeUtility << " did not succeed; exitCode: " << exitCode);
-    LOG4CXX_ERROR(logger, "output:");
-    LOG4CXX_ERROR(logger, processOutput.StdoutToString());
-    return false;
-  }
-  return true;
+    LOG4CXX_INFO(logger, "going to create file: " << fileName);
+    ProcessOutput<50000> processOutput;
+    int exitCode;
+    args[0] = makeUtility.GetFileNameWithoutExtension().ToString();
+    if (!Process::Run(makeUtility, args, &processOutput, &exitCode, nullptr))
+    {
+      LOG4CXX_ERROR(logger, makeUtility << " could not be started");
+      return false;
+    }
+    if (exitCode != 0)
+    {
+      LOG4CXX_ERROR(logger, makeUtility << " did not succeed; exitCode: " << exitCode);
+      LOG4CXX_ERROR(logger, "output:");
+      LOG4CXX_ERROR(logger, processOutput.StdoutToString());
+      return false;
+    }
+    return true;
+  };
+  if (fileType == FileType::BASE || fileType == FileType::FMT)
+  {
+    // only one process (re)builds a memory dump file: the others keep
+    // using the previous one or wait until the new one is ready
+    string lockName = baseName.ToString() + (fileType == FileType::FMT ? "-" + pimpl->session->GetEngineName() : "") + ".lock";
+    const chrono::minutes timeout(10);
+    return LockFile::CreateOnce(
+      pimpl->session->GetSpecialPath(SpecialPath::DataRoot) / PathName(MIKTEX_PATH_MIKTEX_LOCK_DIR) / PathName(lockName),
+      [&](PathName& existing) { return pimpl->session->FindFile(fileName.ToString(), fileType, existing); },
+      create,
+      timeout);
+  }
+  return create();
 }
 
 void Application::EnableInstaller(TriState tri)
@@ -288,10 +288,8 @@ void File::Move(const PathName& source, const PathName& dest, FileMoveOptionSet
   bool sameDevice = sourceStat.st_dev == destStat.st_dev;
   if (sameDevice)
   {
-    if (options[FileMoveOption::ReplaceExisting] && File::Exists(dest))
-    {
-      File::Delete(dest);
-    }
+    // rename() replaces an existing file atomically; readers never see
+    // a missing destination
     if (rename(source.GetData(), dest.GetData()) != 0)
     {
       MIKTEX_FATAL_CRT_ERROR_2("rename", "source", source.ToString(), "dest", dest.ToString());
@@ -131,18 +131,31 @@ MIKTEXSTATICFUNC(bool) Match(const char* pathPattern, const char* path)
 
 bool FileNameDatabase::Search(const PathName& relativePath, const string& pathPattern_, bool all, vector<Fndb::Record>& result)
 {
-  string pathPattern = pathPattern_;
-
+  // the change file must be applied first: it is the only source of
+  // file names the filter doesn't know about yet
   ApplyChangeFile();
 
-  trace_fndb->WriteLine("core", fmt::format(T_("fndb search: rootDirectory={0}, relativePath={1}, pathpattern={2}"), Q_(rootDirectory), Q_(relativePath), Q_(pathPattern)));
+  if (trace_fndb->IsEnabled("core", TraceLevel::Trace))
+  {
+    trace_fndb->WriteLine("core", fmt::format(T_("fndb search: rootDirectory={0}, relativePath={1}, pathpattern={2}"), Q_(rootDirectory), Q_(relativePath), Q_(pathPattern_)));
+  }
 
   MIKTEX_ASSERT(result.size() == 0);
   MIKTEX_ASSERT(!PathNameUtil::IsAbsolutePath(relativePath));
   MIKTEX_ASSERT(!IsExplicitlyRelativePath(relativePath.GetData()));
 
-  PathName dir = relativePath.GetDirectoryName();
   PathName fileName = relativePath.GetFileName();
+  string key = MakeKey(fileName);
+
+  // most searches are misses
+  if (!FilterMayContain(key))
+  {
+    return false;
+  }
+
+  string pathPattern = pathPattern_;
+
+  PathName dir = relativePath.GetDirectoryName();
 
   PathName scratch1;
 
@@ -160,7 +173,7 @@ bool FileNameDatabase::Search(const PathName& relativePath, const string& pathPa
   }
 
   // check to see whether we have this file name
-  pair<FileNameHashTable::const_iterator, FileNameHashTable::const_iterator> range = fileNames.equal_range(MakeKey(fileName));
+  pair<FileNameHashTable::const_iterator, FileNameHashTable::const_iterator> range = fileNames.equal_range(key);
   if (range.first == range.second)
   {
     return false;
@@ -276,7 +289,12 @@ bool FileNameDatabase::FileExists(const PathName& path)
   string fileName;
   string directory;
   std::tie(fileName, directory) = SplitPath(path);
-  pair<FileNameHashTable::const_iterator, FileNameHashTable::const_iterator> range = fileNames.equal_range(MakeKey(fileName));
+  string key = MakeKey(fileName);
+  if (!FilterMayContain(key))
+  {
+    return false;
+  }
+  pair<FileNameHashTable::const_iterator, FileNameHashTable::const_iterator> range = fileNames.equal_range(key);
   for (FileNameHashTable::const_iterator it = range.first; it != range.second; ++it)
   {
     if (PathName::Compare(it->second.GetDirectory(), directory) == 0)
@@ -314,7 +332,9 @@ tuple<string, string> FileNameDatabase::SplitPath(const PathName& path_) const
 
 void FileNameDatabase::FastInsertRecord(FileNameDatabase::Record&& record)
 {
-  fileNames.insert(pair<string, Record>(MakeKey(record.fileName), std::move(record)));
+  string key = MakeKey(record.fileName);
+  AddToFilter(key);
+  fileNames.insert(pair<string, Record>(std::move(key), std::move(record)));
 }
 
 bool FileNameDatabase::InsertRecord(FileNameDatabase::Record&& record)
@@ -328,6 +348,7 @@ bool FileNameDatabase::InsertRecord(FileNameDatabase::Record&& record)
       return false;
     }
   }
+  AddToFilter(key);
   fileNames.insert(pair<string, Record>(std::move(key), std::move(record)));
   return true;
 }
@@ -374,10 +395,77 @@ void FileNameDatabase::EraseRecord(const FileNameDatabase::Record& record)
   }
 }
 
+// 10 bits per file name and 4 probes: about 1% false positives
+constexpr size_t FILTER_BITS_PER_KEY = 10;
+constexpr int FILTER_PROBES = 4;
+
+inline uint64_t FilterHash(const string& key)
+{
+  // FNV-1a
+  uint64_t h = 0xcbf29ce484222325;
+  for (unsigned char ch : key)
+  {
+    h ^= ch;
+    h *= 0x100000001b3;
+  }
+  return h;
+}
+
+void FileNameDatabase::RebuildFilter(size_t capacity)
+{
+  // leave room for the records of the change file
+  filterCapacity = std::max(capacity + capacity / 8, static_cast<size_t>(1024));
+  filter.assign((filterCapacity * FILTER_BITS_PER_KEY + 63) / 64, 0);
+  filterCount = 0;
+  for (const auto& kv : fileNames)
+  {
+    AddToFilter(kv.first);
+  }
+}
+
+void FileNameDatabase::AddToFilter(const string& key)
+{
+  if (filterCount >= filterCapacity)
+  {
+    // the false positive rate would go up
+    RebuildFilter(2 * filterCount);
+  }
+  uint64_t h = FilterHash(key);
+  uint64_t delta = (h >> 33) | 1;
+  size_t numBits = filter.size() * 64;
+  for (int i = 0; i < FILTER_PROBES; ++i, h += delta)
+  {
+    size_t bit = h % numBits;
+    filter[bit / 64] |= uint64_t(1) << (bit % 64);
+  }
+  filterCount++;
+}
+
+bool FileNameDatabase::FilterMayContain(const string& key) const
+{
+  if (filter.empty())
+  {
+    return !fileNames.empty();
+  }
+  uint64_t h = FilterHash(key);
+  uint64_t delta = (h >> 33) | 1;
+  size_t numBits = filter.size() * 64;
+  for (int i = 0; i < FILTER_PROBES; ++i, h += delta)
+  {
+    size_t bit = h % numBits;
+    if ((filter[bit / 64] & (uint64_t(1) << (bit % 64))) == 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 void FileNameDatabase::ReadFileNames()
 {
   fileNames.clear();
   fileNames.rehash(fndbHeader->numFiles);
+  RebuildFilter(fndbHeader->numFiles);
   CoreStopWatch stopWatch(fmt::format("fndb read file names {}", Q_(rootDirectory)));
   ReadFileNames(GetTable());
 }
@@ -25,7 +25,9 @@
 #define BA15DC038D4549859111D4B075360D81
 
 #include <chrono>
+#include <cstdint>
 #include <tuple>
+#include <vector>
 
 #include <miktex/Core/Debug>
 #include <miktex/Core/DirectoryLister>
@@ -151,6 +153,15 @@ private:
 
 private:
   void EraseRecord(const Record& record);
+
+private:
+  void RebuildFilter(std::size_t capacity);
+
+private:
+  void AddToFilter(const std::string& key);
+
+private:
+  bool FilterMayContain(const std::string& key) const;
   
 private:
   void ReadFileNames();
@@ -231,6 +242,17 @@ private:
 private:
   FileNameHashTable fileNames;
 
+  // Bloom filter over the keys of fileNames; a negative answer means
+  // that the file name is not in the database
+private:
+  std::vector<std::uint64_t> filter;
+
+private:
+  std::size_t filterCapacity = 0;
+
+private:
+  std::size_t filterCount = 0;
+
 private:
   MiKTeX::Core::PathName changeFile;
   
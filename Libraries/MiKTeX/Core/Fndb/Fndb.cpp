@@ -60,6 +60,7 @@ void Fndb::Add(const vector<Fndb::Record>& records)
       MIKTEX_UNEXPECTED();
     }
     fndb->Add(records);
+    session->ResetExecutableCache();
   }
   else
   {
@@ -90,6 +91,7 @@ void Fndb::Remove(const vector<PathName>& paths)
     MIKTEX_UNEXPECTED();
   }
   fndb->Remove(paths);
+  session->ResetExecutableCache();
 }
 
 bool Fndb::FileExists(const PathName& path)
@@ -443,6 +443,7 @@ bool FndbManager::Create(const PathName& fndbPath, const PathName& rootPath, ICr
       MIKTEX_FATAL_ERROR(T_("fndb cannot be unloaded"));
     }
     // </fixme>
+    SessionImpl::GetSession()->ResetExecutableCache();
     
     PathName tmpFndbPath(fndbPath);
     tmpFndbPath.AppendExtension(".tmp");
@@ -22,11 +22,16 @@
 #include "config.h"
 
 #include <chrono>
+#include <ctime>
+#include <functional>
+#include <stdexcept>
 #include <thread>
 
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
+#include <miktex/Core/Directory>
+#include <miktex/Core/FileStream>
 #include <miktex/Core/LockFile>
 #include <miktex/Core/Process>
 #include <miktex/Core/StreamReader>
@@ -86,6 +91,8 @@ private:
   tuple<int, string> ReadLockFile();
 private:
   tuple<bool, int, string> CheckLockFile();
+private:
+  bool IsAbandoned();
 private:
   PathName path;
 private:
@@ -103,6 +110,37 @@ unique_ptr<MiKTeX::Core::LockFile> LockFile::Create(const PathName& path)
   return make_unique<LockFileImpl>(path);
 }
 
+bool LockFile::CreateOnce(const PathName& lockPath, function<bool(PathName&)> find, function<bool()> create, chrono::milliseconds timeout)
+{
+  shared_ptr<SessionImpl> session = SessionImpl::TryGetSession();
+  unique_ptr<TraceStream> trace_lockfile = TraceStream::Open(MIKTEX_TRACE_LOCKFILE, session == nullptr ? nullptr : session->GetInitInfo().GetTraceCallback());
+  PathName existing;
+  bool exists = find(existing);
+  time_t lastWriteTime = exists ? File::GetLastWriteTime(existing) : static_cast<time_t>(0);
+  unique_ptr<LockFile> lockFile = LockFile::Create(lockPath);
+  if (!lockFile->TryLock(0ms))
+  {
+    if (exists)
+    {
+      trace_lockfile->WriteLine("core", fmt::format(T_("{0} is being recreated by another process"), Q_(existing)));
+      return true;
+    }
+    trace_lockfile->WriteLine("core", fmt::format(T_("waiting for lock file {0}"), Q_(lockPath)));
+    if (!lockFile->TryLock(timeout))
+    {
+      trace_lockfile->WriteLine("core", TraceLevel::Error, fmt::format(T_("gave up waiting for lock file {0}"), Q_(lockPath)));
+      return false;
+    }
+  }
+  // another process may have done the job in the meantime
+  if (find(existing) && (!exists || File::GetLastWriteTime(existing) > lastWriteTime))
+  {
+    trace_lockfile->WriteLine("core", fmt::format(T_("{0} has been created by another process"), Q_(existing)));
+    return true;
+  }
+  return create();
+}
+
 bool LockFileImpl::TryLock(chrono::milliseconds timeout)
 {
   trace_lockfile->WriteLine("core", fmt::format(T_("trying to create lock file {0}"), Q_(path)));
@@ -119,11 +157,19 @@ bool LockFileImpl::TryLock(chrono::milliseconds timeout)
     {
       try
       {
-        ofstream os = File::CreateOutputStream(path);
-        os
-          << Process::GetCurrentProcess()->GetSystemId() << "\n"
-          << Process::GetCurrentProcess()->get_ProcessName() << "\n";
-        os.close();
+        PathName dir(path);
+        dir.MakeAbsolute();
+        dir.RemoveFileSpec();
+        if (!Directory::Exists(dir))
+        {
+          Directory::Create(dir);
+        }
+        // the file must be created exclusively: several processes may
+        // have seen a missing lock file
+        FileStream stream(File::Open(path, FileMode::CreateNew, FileAccess::Write, false));
+        string owner = fmt::format("{}\n{}\n", Process::GetCurrentProcess()->GetSystemId(), Process::GetCurrentProcess()->get_ProcessName());
+        stream.Write(owner.c_str(), owner.length());
+        stream.Close();
         trace_lockfile->WriteLine("core", fmt::format(T_("lock file {0} successfully created"), Q_(path)));
         locked = true;
       }
@@ -187,6 +233,31 @@ tuple<int, string> LockFileImpl::ReadLockFile()
   return make_tuple(std::stoi(pid), processName);
 }
 
+// a lock file without a valid process id is being written by its owner,
+// unless it is older than this: then the owner crashed before writing
+// (or the disk was full)
+const time_t ABANDONED_LOCK_FILE_AGE = 5;
+
+bool LockFileImpl::IsAbandoned()
+{
+  time_t lastWriteTime;
+  try
+  {
+    lastWriteTime = File::GetLastWriteTime(path);
+  }
+  catch (const exception&)
+  {
+    return false;
+  }
+  if (time(nullptr) - lastWriteTime < ABANDONED_LOCK_FILE_AGE)
+  {
+    // the owner has not yet written its process id
+    return false;
+  }
+  trace_lockfile->WriteLine("core", fmt::format(T_("lock file {0} has no valid owner"), Q_(path)));
+  return true;
+}
+
 tuple<bool, int, string> LockFileImpl::CheckLockFile()
 {
   int pid;
@@ -205,6 +276,14 @@ tuple<bool, int, string> LockFileImpl::CheckLockFile()
     trace_lockfile->WriteLine("core", fmt::format(T_("could not read lock file {0}"), Q_(path)));
     return make_tuple(false, pid, processName);
   }
+  catch (const invalid_argument&)
+  {
+    return make_tuple(IsAbandoned(), -1, processName);
+  }
+  catch (const out_of_range&)
+  {
+    return make_tuple(IsAbandoned(), -1, processName);
+  }
   if (pid == -1)
   {
     // permanently locked
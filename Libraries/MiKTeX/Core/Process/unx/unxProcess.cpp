@@ -28,6 +28,11 @@
 #include <sys/wait.h>
 #include <unistd.h>
 
+#if defined(HAVE_POSIX_SPAWN)
+#  include <spawn.h>
+extern char** environ;
+#endif
+
 #if defined(__APPLE__)
 #  include <libproc.h>
 #  include <sys/proc.h>
@@ -44,6 +49,7 @@
 #   include <fcntl.h>
 #endif
 
+#include <algorithm>
 #include <thread>
 
 #include <miktex/Core/Directory>
@@ -191,6 +197,120 @@ private:
   int twofd[2] = { -1, -1 };
 };
 
+#if defined(HAVE_POSIX_SPAWN)
+class SpawnFileActions
+{
+public:
+  SpawnFileActions()
+  {
+    int err = posix_spawn_file_actions_init(&actions);
+    if (err != 0)
+    {
+      errno = err;
+      MIKTEX_FATAL_CRT_ERROR("posix_spawn_file_actions_init");
+    }
+  }
+
+public:
+  ~SpawnFileActions() noexcept
+  {
+    posix_spawn_file_actions_destroy(&actions);
+  }
+
+public:
+  // make fd the child's fd2 and close the original
+  void Redirect(int fd, int fd2)
+  {
+    if (fd < 0)
+    {
+      return;
+    }
+    posix_spawn_file_actions_adddup2(&actions, fd, fd2);
+    closeAfterwards.push_back(fd);
+  }
+
+public:
+  void Close(int fd)
+  {
+    if (fd >= 0)
+    {
+      closeAfterwards.push_back(fd);
+    }
+  }
+
+public:
+  posix_spawn_file_actions_t* Get()
+  {
+    sort(closeAfterwards.begin(), closeAfterwards.end());
+    closeAfterwards.erase(unique(closeAfterwards.begin(), closeAfterwards.end()), closeAfterwards.end());
+    for (int fd : closeAfterwards)
+    {
+      if (fd > filenoStderr)
+      {
+        posix_spawn_file_actions_addclose(&actions, fd);
+      }
+    }
+    closeAfterwards.clear();
+    return &actions;
+  }
+
+private:
+  posix_spawn_file_actions_t actions;
+
+private:
+  vector<int> closeAfterwards;
+};
+
+MIKTEXSTATICFUNC(bool) Spawn(const ProcessStartInfo& startinfo, const Argv& argv, const Pipe& pipeStdout, const Pipe& pipeStderr, const Pipe& pipeStdin, int fdChildStdin, int fdChildStderr, pid_t& pid)
+{
+  shared_ptr<SessionImpl> session = SessionImpl::TryGetSession();
+  SpawnFileActions fileActions;
+  fileActions.Redirect(pipeStdout.GetWriteEnd(), filenoStdout);
+  if (pipeStderr.GetWriteEnd() >= 0)
+  {
+    fileActions.Redirect(pipeStderr.GetWriteEnd(), filenoStderr);
+  }
+  else
+  {
+    fileActions.Redirect(fdChildStderr, filenoStderr);
+  }
+  if (pipeStdin.GetReadEnd() >= 0)
+  {
+    fileActions.Redirect(pipeStdin.GetReadEnd(), filenoStdin);
+  }
+  else
+  {
+    fileActions.Redirect(fdChildStdin, filenoStdin);
+  }
+  // the parent's pipe ends must not leak into the child
+  fileActions.Close(pipeStdout.GetReadEnd());
+  fileActions.Close(pipeStderr.GetReadEnd());
+  fileActions.Close(pipeStdin.GetWriteEnd());
+  if (session != nullptr)
+  {
+    // the child inherits our environment
+    session->SetEnvironmentVariables();
+    session->trace_process->WriteLine("core", TraceLevel::Info, fmt::format("posix_spawn: {0}", startinfo.FileName));
+    for (int idx = 0; argv[idx] != nullptr; ++idx)
+    {
+      session->trace_process->WriteLine("core", TraceLevel::Info, fmt::format(" argv[{0}]: {1}", idx, argv[idx]));
+    }
+  }
+  pid_t childPid;
+  int err = posix_spawn(&childPid, startinfo.FileName.c_str(), fileActions.Get(), nullptr, const_cast<char*const*>(argv.GetArgv()), environ);
+  if (err != 0)
+  {
+    if (session != nullptr)
+    {
+      session->trace_process->WriteLine("core", TraceLevel::Warning, fmt::format("posix_spawn failed ({0}); falling back to fork", err));
+    }
+    return false;
+  }
+  pid = childPid;
+  return true;
+}
+#endif
+
 unique_ptr<Process> Process::Start(const ProcessStartInfo& startinfo)
 {
   return make_unique<unxProcess>(startinfo);
@@ -258,85 +378,99 @@ void unxProcess::Create()
   tmpFile = TemporaryFile::Create();
   tmpEnv.Set(MIKTEX_ENV_EXCEPTION_PATH, tmpFile->GetPathName().ToString());
 
-  // fork
-  if (session != nullptr)
-  {
-    session->trace_process->WriteLine("core", TraceLevel::Info, "forking...");
-  }
-  if (pipeStdout.GetReadEnd() >= 0
-    || pipeStderr.GetReadEnd() >= 0
-    || pipeStdin.GetReadEnd() >= 0
-    || fdChildStdin >= 0
-    || fdChildStderr >= 0)
-  {
-    pid = FORK();
-  }
-  else
-  {
-    pid = VFORK();
-  }
-  if (pid < 0)
+  bool spawned = false;
+
+#if defined(HAVE_POSIX_SPAWN)
+  // posix_spawn cannot change the working directory or start a new
+  // session in a portable way
+  if (startinfo.WorkingDirectory.empty() && !startinfo.Daemonize)
   {
-    MIKTEX_FATAL_CRT_ERROR("fork");
+    spawned = Spawn(startinfo, argv, pipeStdout, pipeStderr, pipeStdin, fdChildStdin, fdChildStderr, pid);
   }
+#endif
 
-  if (pid == 0)
+  if (!spawned)
   {
-    try
+    // fork
+    if (session != nullptr)
     {
-      // I'm a child
-      if (pipeStdout.GetWriteEnd() >= 0)
-      {
-        Dup2(pipeStdout.GetWriteEnd(), filenoStdout);
-      }
-      if (pipeStderr.GetWriteEnd() >= 0)
-      {
-        Dup2(pipeStderr.GetWriteEnd(), filenoStderr);
-      }
-      else if (fdChildStderr >= 0)
-      {
-        Dup2(fdChildStderr, filenoStderr);
-        ::Close_(fdChildStderr);
-      }
-      if (pipeStdin.GetReadEnd() >= 0)
-      {
-        Dup2(pipeStdin.GetReadEnd(), filenoStdin);
-      }
-      else if (fdChildStdin >= 0)
-      {
-        Dup2(fdChildStdin, filenoStdin);
-        ::Close_(fdChildStdin);
-      }
-      pipeStdout.Dispose();
-      pipeStderr.Dispose();
-      pipeStdin.Dispose();
-      if (session != nullptr)
+      session->trace_process->WriteLine("core", TraceLevel::Info, "forking...");
+    }
+    if (pipeStdout.GetReadEnd() >= 0
+      || pipeStderr.GetReadEnd() >= 0
+      || pipeStdin.GetReadEnd() >= 0
+      || fdChildStdin >= 0
+      || fdChildStderr >= 0)
+    {
+      pid = FORK();
+    }
+    else
+    {
+      pid = VFORK();
+    }
+    if (pid < 0)
+    {
+      MIKTEX_FATAL_CRT_ERROR("fork");
+    }
+
+    if (pid == 0)
+    {
+      try
       {
-        session->SetEnvironmentVariables();
-        session->trace_process->WriteLine("core", TraceLevel::Info, fmt::format("execv: {0}", startinfo.FileName));
-        for (int idx = 0; argv[idx] != nullptr; ++idx)
+        // I'm a child
+        if (pipeStdout.GetWriteEnd() >= 0)
         {
-          session->trace_process->WriteLine("core", TraceLevel::Info, fmt::format(" argv[{0}]: {1}", idx, argv[idx]));
+          Dup2(pipeStdout.GetWriteEnd(), filenoStdout);
         }
-      }
-      if (!startinfo.WorkingDirectory.empty())
-      {
-        Directory::SetCurrent(PathName(startinfo.WorkingDirectory));
-      }
-      if (startinfo.Daemonize)
-      {
-        if (setsid() == -1)
+        if (pipeStderr.GetWriteEnd() >= 0)
+        {
+          Dup2(pipeStderr.GetWriteEnd(), filenoStderr);
+        }
+        else if (fdChildStderr >= 0)
+        {
+          Dup2(fdChildStderr, filenoStderr);
+          ::Close_(fdChildStderr);
+        }
+        if (pipeStdin.GetReadEnd() >= 0)
+        {
+          Dup2(pipeStdin.GetReadEnd(), filenoStdin);
+        }
+        else if (fdChildStdin >= 0)
+        {
+          Dup2(fdChildStdin, filenoStdin);
+          ::Close_(fdChildStdin);
+        }
+        pipeStdout.Dispose();
+        pipeStderr.Dispose();
+        pipeStdin.Dispose();
+        if (session != nullptr)
+        {
+          session->SetEnvironmentVariables();
+          session->trace_process->WriteLine("core", TraceLevel::Info, fmt::format("execv: {0}", startinfo.FileName));
+          for (int idx = 0; argv[idx] != nullptr; ++idx)
+          {
+            session->trace_process->WriteLine("core", TraceLevel::Info, fmt::format(" argv[{0}]: {1}", idx, argv[idx]));
+          }
+        }
+        if (!startinfo.WorkingDirectory.empty())
         {
-          MIKTEX_FATAL_CRT_ERROR("setsid");
+          Directory::SetCurrent(PathName(startinfo.WorkingDirectory));
         }
+        if (startinfo.Daemonize)
+        {
+          if (setsid() == -1)
+          {
+            MIKTEX_FATAL_CRT_ERROR("setsid");
+          }
+        }
+        execv(startinfo.FileName.c_str(), const_cast<char*const*>(argv.GetArgv()));
+        perror("execv failed");
       }
-      execv(startinfo.FileName.c_str(), const_cast<char*const*>(argv.GetArgv()));
-      perror("execv failed");
-    }
-    catch (const exception&)
-    {
+      catch (const exception&)
+      {
+      }
+      _exit(127);
     }
-    _exit(127);
   }
 
   MIKTEX_ASSERT(pid > 0);
@@ -0,0 +1,210 @@
+/* OpenFileTable.cpp: registry of open files
+
+   Copyright (C) 2026 agent
+
+   This file is part of the MiKTeX Core Library.
+
+   The MiKTeX Core Library is free software; you can redistribute it
+   and/or modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2, or
+   (at your option) any later version.
+
+   The MiKTeX Core Library is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the MiKTeX Core Library; if not, write to the Free
+   Software Foundation, 59 Temple Place - Suite 330, Boston, MA
+   02111-1307, USA. */
+
+#include "config.h"
+
+#include <cstdint>
+
+#include "internal.h"
+
+#include "Session/OpenFileTable.h"
+
+using namespace std;
+
+using namespace MiKTeX::Core;
+
+const size_t INITIAL_CAPACITY = 64;
+
+BEGIN_ANONYMOUS_NAMESPACE;
+
+const char tombstoneMarker = 0;
+const char reservedMarker = 0;
+
+// slot keys which are not files
+#define TOMBSTONE reinterpret_cast<const FILE*>(&tombstoneMarker)
+#define RESERVED reinterpret_cast<const FILE*>(&reservedMarker)
+
+inline bool IsFile(const FILE* file)
+{
+  return file != nullptr && file != TOMBSTONE && file != RESERVED;
+}
+
+inline size_t Hash(const FILE* file)
+{
+  uint64_t h = reinterpret_cast<uintptr_t>(file);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return static_cast<size_t>(h);
+}
+
+END_ANONYMOUS_NAMESPACE;
+
+OpenFileTable::OpenFileTable() :
+  head(new Table(INITIAL_CAPACITY, nullptr))
+{
+}
+
+OpenFileTable::~OpenFileTable()
+{
+  Table* table = head.load();
+  while (table != nullptr)
+  {
+    for (size_t idx = 0; idx < table->capacity; ++idx)
+    {
+      delete table->slots[idx].info.load();
+    }
+    Table* next = table->next;
+    delete table;
+    table = next;
+  }
+}
+
+void OpenFileTable::Insert(const Session::OpenFileInfo& info)
+{
+  MIKTEX_ASSERT(IsFile(info.file));
+  unique_ptr<Session::OpenFileInfo> newInfo = make_unique<Session::OpenFileInfo>(info);
+  bool isOutput = info.mode != FileMode::Command && info.access == FileAccess::Write;
+  for (;;)
+  {
+    Table* table = head.load(memory_order_acquire);
+    if (TryInsert(table, newInfo, isOutput))
+    {
+      return;
+    }
+    Grow(table);
+  }
+}
+
+bool OpenFileTable::TryInsert(Table* table, unique_ptr<Session::OpenFileInfo>& info, bool isOutput)
+{
+  const FILE* file = info->file;
+  const size_t mask = table->capacity - 1;
+  size_t idx = Hash(file) & mask;
+  for (size_t n = 0; n < table->capacity; ++n, idx = (idx + 1) & mask)
+  {
+    Slot& slot = table->slots[idx];
+    const FILE* key = slot.file.load(memory_order_relaxed);
+    if (key == nullptr)
+    {
+      // keep the load factor below 3/4; empty slots terminate lookups
+      if (table->used.load(memory_order_relaxed) >= table->capacity / 4 * 3)
+      {
+        return false;
+      }
+      if (!slot.file.compare_exchange_strong(key, RESERVED, memory_order_acquire))
+      {
+        continue;
+      }
+      table->used.fetch_add(1, memory_order_relaxed);
+    }
+    else if (key != TOMBSTONE || !slot.file.compare_exchange_strong(key, RESERVED, memory_order_acquire))
+    {
+      continue;
+    }
+    slot.info.store(info.release(), memory_order_relaxed);
+    slot.isOutput.store(isOutput, memory_order_relaxed);
+    slot.file.store(file, memory_order_release);
+    return true;
+  }
+  return false;
+}
+
+void OpenFileTable::Grow(Table* table)
+{
+  Table* newTable = new Table(table->capacity * 2, table);
+  if (!head.compare_exchange_strong(table, newTable, memory_order_acq_rel))
+  {
+    // another thread was faster
+    delete newTable;
+  }
+}
+
+OpenFileTable::Slot* OpenFileTable::Find(const FILE* file) const
+{
+  for (Table* table = head.load(memory_order_acquire); table != nullptr; table = table->next)
+  {
+    const size_t mask = table->capacity - 1;
+    size_t idx = Hash(file) & mask;
+    for (size_t n = 0; n < table->capacity; ++n, idx = (idx + 1) & mask)
+    {
+      const FILE* key = table->slots[idx].file.load(memory_order_acquire);
+      if (key == file)
+      {
+        return &table->slots[idx];
+      }
+      if (key == nullptr)
+      {
+        break;
+      }
+    }
+  }
+  return nullptr;
+}
+
+unique_ptr<Session::OpenFileInfo> OpenFileTable::Remove(const FILE* file)
+{
+  Slot* slot = Find(file);
+  if (slot == nullptr)
+  {
+    return nullptr;
+  }
+  unique_ptr<Session::OpenFileInfo> info(slot->info.exchange(nullptr, memory_order_relaxed));
+  slot->file.store(TOMBSTONE, memory_order_release);
+  return info;
+}
+
+bool OpenFileTable::TryGet(const FILE* file, Session::OpenFileInfo& info) const
+{
+  Slot* slot = Find(file);
+  if (slot == nullptr)
+  {
+    return false;
+  }
+  info = *slot->info.load(memory_order_relaxed);
+  return true;
+}
+
+bool OpenFileTable::IsOutputFile(const FILE* file) const
+{
+  Slot* slot = Find(file);
+  return slot != nullptr && slot->isOutput.load(memory_order_relaxed);
+}
+
+vector<Session::OpenFileInfo> OpenFileTable::GetAll() const
+{
+  vector<Session::OpenFileInfo> result;
+  for (Table* table = head.load(memory_order_acquire); table != nullptr; table = table->next)
+  {
+    for (size_t idx = 0; idx < table->capacity; ++idx)
+    {
+      if (IsFile(table->slots[idx].file.load(memory_order_acquire)))
+      {
+        const Session::OpenFileInfo* info = table->slots[idx].info.load(memory_order_relaxed);
+        if (info != nullptr)
+        {
+          result.push_back(*info);
+        }
+      }
+    }
+  }
+  return result;
+}
@@ -0,0 +1,125 @@
+/* OpenFileTable.h:                                     -*- C++ -*-
+
+   Copyright (C) 2026 agent
+
+   This file is part of the MiKTeX Core Library.
+
+   The MiKTeX Core Library is free software; you can redistribute it
+   and/or modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2, or
+   (at your option) any later version.
+
+   The MiKTeX Core Library is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the MiKTeX Core Library; if not, write to the Free
+   Software Foundation, 59 Temple Place - Suite 330, Boston, MA
+   02111-1307, USA. */
+
+#pragma once
+
+#if !defined(B3A4D3F8E1F1447C9C0D5E6F2B7A8C91)
+#define B3A4D3F8E1F1447C9C0D5E6F2B7A8C91
+
+#include <cstddef>
+#include <cstdio>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <miktex/Core/Session>
+
+CORE_INTERNAL_BEGIN_NAMESPACE;
+
+/// Registry of the files opened by the session, keyed by `FILE*`.
+///
+/// This is an open-addressing hash table which can be used by several
+/// threads without locking.  Removed slots become tombstones and are
+/// reused by later insertions; when a table gets too full, a table of
+/// twice the size is put in front of it.  Older tables are kept until
+/// the registry is destroyed.
+///
+/// Operations on one and the same `FILE*` must not run concurrently;
+/// this holds naturally, because a file is opened before it is used
+/// and closed when nobody uses it any more.
+class OpenFileTable
+{
+public:
+  OpenFileTable();
+
+public:
+  OpenFileTable(const OpenFileTable& other) = delete;
+
+public:
+  OpenFileTable& operator=(const OpenFileTable& other) = delete;
+
+public:
+  OpenFileTable(OpenFileTable&& other) = delete;
+
+public:
+  OpenFileTable& operator=(OpenFileTable&& other) = delete;
+
+public:
+  ~OpenFileTable();
+
+public:
+  void Insert(const MiKTeX::Core::Session::OpenFileInfo& info);
+
+public:
+  std::unique_ptr<MiKTeX::Core::Session::OpenFileInfo> Remove(const FILE* file);
+
+public:
+  bool TryGet(const FILE* file, MiKTeX::Core::Session::OpenFileInfo& info) const;
+
+public:
+  bool IsOutputFile(const FILE* file) const;
+
+  /// Gets all registered files.  Must not run concurrently with
+  /// Remove().
+public:
+  std::vector<MiKTeX::Core::Session::OpenFileInfo> GetAll() const;
+
+private:
+  struct Slot
+  {
+    std::atomic<const FILE*> file{ nullptr };
+    std::atomic<MiKTeX::Core::Session::OpenFileInfo*> info{ nullptr };
+    std::atomic<bool> isOutput{ false };
+  };
+
+private:
+  struct Table
+  {
+    Table(std::size_t capacity, Table* next) :
+      capacity(capacity),
+      slots(new Slot[capacity]),
+      next(next)
+    {
+    }
+    const std::size_t capacity;
+    const std::unique_ptr<Slot[]> slots;
+    // number of slots which are not empty (tombstones included)
+    std::atomic<std::size_t> used{ 0 };
+    Table* const next;
+  };
+
+private:
+  bool TryInsert(Table* table, std::unique_ptr<MiKTeX::Core::Session::OpenFileInfo>& info, bool isOutput);
+
+private:
+  void Grow(Table* table);
+
+private:
+  Slot* Find(const FILE* file) const;
+
+private:
+  std::atomic<Table*> head;
+};
+
+CORE_INTERNAL_END_NAMESPACE;
+
+#endif
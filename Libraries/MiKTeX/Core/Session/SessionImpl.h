@@ -27,7 +27,9 @@
 #include <deque>
 #include <fstream>
 #include <map>
+#include <mutex>
 #include <set>
+#include <unordered_set>
 
 #if defined(HAVE_ATLBASE_H)
 #  define _ATL_FREE_THREADED
@@ -48,6 +50,7 @@
 #include <miktex/Core/hash_icase>
 
 #include "Fndb/FileNameDatabase.h"
+#include "OpenFileTable.h"
 #include "RootDirectoryInternals.h"
 
 #if defined(MIKTEX_WINDOWS) && USE_LOCAL_SERVER
@@ -292,6 +295,9 @@ public:
 public:
   void RecordFileInfo(const MiKTeX::Core::PathName& path, MiKTeX::Core::FileAccess access) override;
 
+public:
+  void FlushFileInfoRecorder();
+
 public:
   std::vector<MiKTeX::Core::FileInfoRecord> GetFileInfoRecords() override;
 
@@ -334,6 +340,9 @@ public:
     return FindFile(fileName, fileType, {}, result);
   }
 
+public:
+  std::size_t FindFiles(const std::vector<std::string>& fileNames, MiKTeX::Core::FileType fileType, FindFileOptionSet options, std::vector<MiKTeX::Core::PathName>& result) override;
+
 public:
   bool FindPkFile(const std::string& fontName, const std::string& mfMode, int dpi, MiKTeX::Core::PathName& result) override;
 
@@ -761,6 +770,9 @@ private:
 private:
   bool FindFileInternal(const std::string& fileName, const std::vector<MiKTeX::Core::PathName>& vec, bool all, bool useFndb, bool searchFileSystem, std::vector<MiKTeX::Core::PathName>& result);
 
+private:
+  std::vector<MiKTeX::Core::PathName> GetFileNamesToTry(const std::string& fileName, const InternalFileTypeInfo* fti);
+
 private:
   bool FindFileInternal(const std::string& fileName, MiKTeX::Core::FileType fileType, bool all, bool tryHard, bool create, bool renew, std::vector<MiKTeX::Core::PathName>& result);
 
@@ -933,6 +945,9 @@ private:
 private:
   void WritePackageHistory();
 
+private:
+  void ResolvePackageNames();
+
 private:
   std::string ExpandValues(const std::string& toBeExpanded, MiKTeX::Core::HasNamedValues* callback);
 
@@ -984,9 +999,9 @@ private:
 private:
   std::vector<MiKTeX::Core::MIKTEXMFMODE> metafontModes;
 
-  // caching open files
+  // open files
 private:
-  std::map<const FILE*, OpenFileInfo> openFilesMap;
+  OpenFileTable openFiles;
 
   // caching path patterns
 private:
@@ -995,10 +1010,56 @@ private:
 private:
   SearchPathDictionary expandedPathPatterns;
 
+  // caching root and brace expansions across processes
+private:
+  SearchPathDictionary searchPathCache;
+
+private:
+  std::mutex searchPathCacheMutex;
+
+private:
+  bool searchPathCacheLoaded = false;
+
+private:
+  bool searchPathCacheDirty = false;
+
+private:
+  std::string searchPathCacheDigest;
+
+private:
+  MiKTeX::Core::PathName GetSearchPathCacheFile();
+
+private:
+  std::string GetRootDirectoriesDigest();
+
+private:
+  void LoadSearchPathCache();
+
+private:
+  void SaveSearchPathCache();
+
+private:
+  void ResetSearchPathCache();
+
+  // caching executable locations; key: file name + PATH
+private:
+  std::unordered_map<std::string, MiKTeX::Core::PathName> executableCache;
+
+public:
+  void ResetExecutableCache();
+
   // file access history
 private:
   std::vector<MiKTeX::Core::FileInfoRecord> fileInfoRecords;
 
+  // recorded files (access mode + file name)
+private:
+  std::unordered_set<std::string> recordedFiles;
+
+  // number of file info records with a resolved package name
+private:
+  std::size_t packageNamesResolved = 0;
+
   // true, if we record a file history
 private:
   bool recordingFileNames = false;
@@ -1010,6 +1071,10 @@ private:
 private:
   std::ofstream fileNameRecorderStream;
 
+  // number of recorder lines written since the last flush
+private:
+  std::size_t recorderLinesPending = 0;
+
   // package history file
 private:
   std::string packageHistoryFile;
@@ -865,6 +865,7 @@ void SessionImpl::SetAdminMode(bool adminMode, bool force)
   trace_config->WriteLine("core", TraceLevel::Info, fmt::format(T_("turning {0} administrator mode"), (adminMode ? "on" : "off")));
   // reinitialize
   fileTypes.clear();
+  ResetExecutableCache();
   UnloadFilenameDatabase();
   this->adminMode = adminMode;
   if (!rootDirectories.empty())
@@ -66,6 +66,7 @@ void Session::FatalMiKTeXError(const string& message, const string& description,
   }
   if (session != nullptr)
   {
+    session->FlushFileInfoRecorder();
     programInvocationName = session->initInfo.GetProgramInvocationName();
   }
 #if 1
@@ -115,6 +116,7 @@ void Session::FatalCrtError(const string& functionName, int errorCode, const MiK
     session->trace_error->WriteLine("core", TraceLevel::Fatal, fmt::format(T_("Result: {0}"), errorCode));
     session->trace_error->WriteLine("core", TraceLevel::Fatal, fmt::format(T_("Data: {0}"), infoString.empty() ? "<no data>" : infoString));
     session->trace_error->WriteLine("core", TraceLevel::Fatal, fmt::format(T_("Source: {0}"), sourceLocation));
+    session->FlushFileInfoRecorder();
     programInvocationName = session->initInfo.GetProgramInvocationName();
   }
 #if 1
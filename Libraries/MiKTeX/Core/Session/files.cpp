@@ -23,8 +23,11 @@
 
 #include <fcntl.h>
 
+#include <cerrno>
+#include <cstring>
 #include <fstream>
 #include <thread>
+#include <vector>
 
 #include <fmt/format.h>
 #include <fmt/ostream.h>
@@ -136,31 +139,69 @@ void SessionImpl::RecordFileInfo(const PathName& path, FileAccess access)
   {
     return;
   }
-  fileInfoRecords.reserve(50);
   FileInfoRecord fir;
   fir.fileName = path.ToString();
   fir.access = access;
-  if (recordingPackageNames || !packageHistoryFile.empty())
+  // record each file only once per access mode
+  if (!recordedFiles.insert((access == FileAccess::Read ? "r:" : "w:") + fir.fileName).second)
   {
+    return;
+  }
+  // package names are resolved later, see ResolvePackageNames()
+  fileInfoRecords.push_back(fir);
+  if (fileNameRecorderStream.is_open())
+  {
+    fileNameRecorderStream << (fir.access == FileAccess::Read ? "INPUT" : "OUTPUT") << " " << PathName(fir.fileName).ToUnix() << "\n";
+    // bound what a crash can lose
+    if (++recorderLinesPending >= RECORDER_FLUSH_LINES)
+    {
+      fileNameRecorderStream.flush();
+      recorderLinesPending = 0;
+    }
+  }
+}
+
+void SessionImpl::FlushFileInfoRecorder()
+{
+  if (!fileNameRecorderStream.is_open())
+  {
+    return;
+  }
+  // called on the way out of a fatal error: must not throw
+  try
+  {
+    fileNameRecorderStream.flush();
+  }
+  catch (const ios_base::failure&)
+  {
+  }
+  recorderLinesPending = 0;
+}
+
+void SessionImpl::ResolvePackageNames()
+{
+  if (!(recordingPackageNames || !packageHistoryFile.empty()) || packageNamesResolved >= fileInfoRecords.size())
+  {
+    return;
+  }
+  shared_ptr<FileNameDatabase> fndb = GetFileNameDatabase(GetMpmRoot());
+  if (fndb == nullptr)
+  {
+    return;
+  }
+  for (; packageNamesResolved < fileInfoRecords.size(); ++packageNamesResolved)
+  {
+    FileInfoRecord& fir = fileInfoRecords[packageNamesResolved];
     PathName pathRelPath;
-    if (IsTEXMFFile(path, pathRelPath))
+    if (IsTEXMFFile(PathName(fir.fileName), pathRelPath))
     {
-      shared_ptr<FileNameDatabase> fndb = GetFileNameDatabase(GetMpmRoot());
-      if (fndb != nullptr)
+      vector<Fndb::Record> records;
+      if (fndb->Search(pathRelPath, MPM_ROOT_PATH, false, records))
       {
-        vector<Fndb::Record> records;
-        if (fndb->Search(pathRelPath, MPM_ROOT_PATH, false, records))
-        {
-          fir.packageName = records[0].fileNameInfo;
-        }
+        fir.packageName = records[0].fileNameInfo;
       }
     }
   }
-  fileInfoRecords.push_back(fir);
-  if (fileNameRecorderStream.is_open())
-  {
-    fileNameRecorderStream << (fir.access == FileAccess::Read ? "INPUT" : "OUTPUT") << " " << PathName(fir.fileName).ToUnix() << std::endl;
-  }
 }
 
 FILE* SessionImpl::TryOpenFile(const PathName& path, FileMode mode, FileAccess access, bool text)
@@ -209,7 +250,7 @@ FILE* SessionImpl::OpenFile(const PathName& path, FileMode mode, FileAccess acce
     info.fileName = path.ToString();
     info.mode = mode;
     info.access = access;
-    openFilesMap.insert(pair<FILE*, OpenFileInfo>(pFile, info));
+    openFiles.Insert(info);
     if (setvbuf(pFile, 0, _IOFBF, 1024 * 4) != 0)
     {
       trace_error->WriteLine("core", TraceLevel::Error, "setvbuf() failed for some reason");
@@ -259,6 +300,163 @@ FILE* SessionImpl::InitiateProcessPipe(const string& command, FileAccess access,
   }
 }
 
+#if defined(HAVE_FOPENCOOKIE) || defined(HAVE_FUNOPEN)
+
+// a FILE which reads directly from a stream; the cookie owns the
+// stream and keeps the first bytes, so that the FILE can be rewound
+// to the start (e.g., after looking for a byte order mark)
+struct StreamCookie
+{
+  unique_ptr<Stream> stream;
+  vector<char> head;
+  long position = 0;
+  long streamPosition = 0;
+};
+
+const size_t COOKIE_HEAD_SIZE = 4096;
+
+MIKTEXSTATICFUNC(long) ReadCookie(void* cookie, char* buf, size_t size)
+{
+  StreamCookie* streamCookie = reinterpret_cast<StreamCookie*>(cookie);
+  if (streamCookie->position < streamCookie->streamPosition)
+  {
+    size_t n = min(size, static_cast<size_t>(streamCookie->streamPosition - streamCookie->position));
+    memcpy(buf, &streamCookie->head[streamCookie->position], n);
+    streamCookie->position += static_cast<long>(n);
+    return static_cast<long>(n);
+  }
+  bool inHead = streamCookie->head.size() < COOKIE_HEAD_SIZE;
+  if (inHead)
+  {
+    // do not read past the head, so that the FILE can still be rewound
+    size = min(size, COOKIE_HEAD_SIZE - streamCookie->head.size());
+  }
+  try
+  {
+    size_t n = streamCookie->stream->Read(buf, size);
+    if (inHead)
+    {
+      streamCookie->head.insert(streamCookie->head.end(), buf, buf + n);
+    }
+    streamCookie->streamPosition += static_cast<long>(n);
+    streamCookie->position = streamCookie->streamPosition;
+    return static_cast<long>(n);
+  }
+  catch (const exception&)
+  {
+    errno = EIO;
+    return -1;
+  }
+}
+
+// compressed streams cannot seek: go back only as far as the head
+// reaches and skip forward by reading
+MIKTEXSTATICFUNC(bool) SeekCookie(void* cookie, long& offset, int whence)
+{
+  StreamCookie* streamCookie = reinterpret_cast<StreamCookie*>(cookie);
+  long newPosition;
+  switch (whence)
+  {
+  case SEEK_SET:
+    newPosition = offset;
+    break;
+  case SEEK_CUR:
+    newPosition = streamCookie->position + offset;
+    break;
+  default:
+    errno = ESPIPE;
+    return false;
+  }
+  if (newPosition < streamCookie->position)
+  {
+    if (newPosition < 0 || streamCookie->streamPosition > static_cast<long>(streamCookie->head.size()))
+    {
+      errno = ESPIPE;
+      return false;
+    }
+    streamCookie->position = newPosition;
+  }
+  char buf[PIPE_SIZE];
+  while (newPosition > streamCookie->position)
+  {
+    long n = ReadCookie(cookie, buf, static_cast<size_t>(min<long>(newPosition - streamCookie->position, PIPE_SIZE)));
+    if (n <= 0)
+    {
+      break;
+    }
+  }
+  if (newPosition != streamCookie->position)
+  {
+    errno = ESPIPE;
+    return false;
+  }
+  offset = newPosition;
+  return true;
+}
+
+MIKTEXSTATICFUNC(int) CloseCookie(void* cookie)
+{
+  delete reinterpret_cast<StreamCookie*>(cookie);
+  return 0;
+}
+
+#if defined(HAVE_FOPENCOOKIE)
+MIKTEXSTATICFUNC(ssize_t) CookieRead(void* cookie, char* buf, size_t size)
+{
+  return ReadCookie(cookie, buf, size);
+}
+
+MIKTEXSTATICFUNC(int) CookieSeek(void* cookie, off64_t* offset, int whence)
+{
+  long pos = static_cast<long>(*offset);
+  if (!SeekCookie(cookie, pos, whence))
+  {
+    return -1;
+  }
+  *offset = pos;
+  return 0;
+}
+#else
+MIKTEXSTATICFUNC(int) CookieRead(void* cookie, char* buf, int size)
+{
+  return static_cast<int>(ReadCookie(cookie, buf, static_cast<size_t>(size)));
+}
+
+MIKTEXSTATICFUNC(fpos_t) CookieSeek(void* cookie, fpos_t offset, int whence)
+{
+  long pos = static_cast<long>(offset);
+  if (!SeekCookie(cookie, pos, whence))
+  {
+    return -1;
+  }
+  return pos;
+}
+#endif
+
+FILE* SessionImpl::OpenFileOnStream(std::unique_ptr<Stream> stream)
+{
+  StreamCookie* cookie = new StreamCookie;
+  cookie->stream = move(stream);
+#if defined(HAVE_FOPENCOOKIE)
+  cookie_io_functions_t functions = { CookieRead, nullptr, CookieSeek, CloseCookie };
+  FILE* file = fopencookie(cookie, "rb", functions);
+#else
+  FILE* file = funopen(cookie, CookieRead, nullptr, CookieSeek, CloseCookie);
+#endif
+  if (file == nullptr)
+  {
+    delete cookie;
+#if defined(HAVE_FOPENCOOKIE)
+    MIKTEX_FATAL_CRT_ERROR("fopencookie");
+#else
+    MIKTEX_FATAL_CRT_ERROR("funopen");
+#endif
+  }
+  return file;
+}
+
+#else
+
 MIKTEXSTATICFUNC(void) ReaderThread(unique_ptr<Stream> inStream, unique_ptr<Stream> outStream)
 {
   try
@@ -283,30 +481,21 @@ FILE* SessionImpl::OpenFileOnStream(std::unique_ptr<Stream> stream)
   return files[0]->Detach();
 }
 
+#endif
+
 pair<bool, Session::OpenFileInfo> SessionImpl::TryGetOpenFileInfo(FILE* file)
 {
-  map<const FILE*, OpenFileInfo>::const_iterator it = openFilesMap.find(file);
-  if (it == openFilesMap.end())
-  {
-    return make_pair<bool, Session::OpenFileInfo>(false, Session::OpenFileInfo());
-  }
-  else
-  {
-    return make_pair<bool, Session::OpenFileInfo>(true, Session::OpenFileInfo(it->second));
-  }
+  Session::OpenFileInfo info;
+  bool found = openFiles.TryGet(file, info);
+  return make_pair(found, info);
 }
 
 void SessionImpl::CloseFile(FILE* pFile)
 {
   MIKTEX_ASSERT_BUFFER(pFile, sizeof(*pFile));
   trace_files->WriteLine("core", fmt::format("CloseFile({0})", static_cast<void*>(pFile)));
-  map<const FILE*, OpenFileInfo>::iterator it = openFilesMap.find(pFile);
-  bool isCommand = false;
-  if (it != openFilesMap.end())
-  {
-    isCommand = (it->second.mode == FileMode::Command);
-    openFilesMap.erase(it);
-  }
+  unique_ptr<OpenFileInfo> info = openFiles.Remove(pFile);
+  bool isCommand = info != nullptr && info->mode == FileMode::Command;
   if (isCommand)
   {
     PClose(pFile);
@@ -320,12 +509,7 @@ void SessionImpl::CloseFile(FILE* pFile)
 bool SessionImpl::IsOutputFile(const FILE* pFile)
 {
   MIKTEX_ASSERT(pFile != nullptr);
-  map<const FILE*, OpenFileInfo>::const_iterator it = openFilesMap.find(pFile);
-  if (it == openFilesMap.end())
-  {
-    return false;
-  }
-  return (it->second.mode != FileMode::Command && it->second.access == FileAccess::Write);
+  return openFiles.IsOutputFile(pFile);
 }
 
 bool SessionImpl::StartFileInfoRecorder()
@@ -360,24 +544,25 @@ void SessionImpl::SetRecorderPath(const PathName& path)
   PathName cwd;
   cwd.SetToCurrentDirectory();
   fileNameRecorderStream << "PWD " << cwd.ToUnix() << "\n";
-  vector<FileInfoRecord> fileInfoRecords = GetFileInfoRecords();
   for (vector<FileInfoRecord>::const_iterator it = fileInfoRecords.begin(); it != fileInfoRecords.end(); ++it)
   {
     fileNameRecorderStream << (it->access == FileAccess::Read ? "INPUT" : "OUTPUT") << " " << PathName(it->fileName).ToUnix() << "\n";
   }
   fileNameRecorderStream.flush();
+  recorderLinesPending = 0;
 }
 
 vector<FileInfoRecord> SessionImpl::GetFileInfoRecords()
 {
+  ResolvePackageNames();
   return fileInfoRecords;
 }
 
 void SessionImpl::CheckOpenFiles()
 {
-  for (map<const FILE*, OpenFileInfo>::const_iterator it = openFilesMap.begin(); it != openFilesMap.end(); ++it)
+  for (const OpenFileInfo& info : openFiles.GetAll())
   {
-    trace_error->WriteLine("core", TraceLevel::Error, fmt::format("still open: {0}", Q_(it->second.fileName)));
+    trace_error->WriteLine("core", TraceLevel::Error, fmt::format("still open: {0}", Q_(info.fileName)));
   }
 }
 
@@ -387,6 +572,7 @@ void SessionImpl::WritePackageHistory()
   {
     return;
   }
+  ResolvePackageNames();
   ofstream stream = File::CreateOutputStream(PathName(packageHistoryFile), ios_base::app);
   for (vector<FileInfoRecord>::const_iterator it = fileInfoRecords.begin(); it != fileInfoRecords.end(); ++it)
   {
@@ -36,6 +36,7 @@
 using namespace std;
 
 using namespace MiKTeX::Core;
+using namespace MiKTeX::Trace;
 using namespace MiKTeX::Util;
 
 void SessionImpl::SetFindFileCallback(IFindFileCallback* callback)
@@ -164,7 +165,10 @@ bool SessionImpl::FindFileInternal(const string& fileName, const vector<PathName
   {
     for (vector<PathName>::const_iterator it = directoryPatterns.begin(); (!found || all) && it != directoryPatterns.end(); ++it)
     {
-      trace_filesearch->WriteLine("core", fmt::format(T_("going to search in FNDB: filename={0}, directory={1}"), Q_(fileName), Q_(it->ToString())));
+      if (trace_filesearch->IsEnabled("core", TraceLevel::Trace))
+      {
+        trace_filesearch->WriteLine("core", fmt::format(T_("going to search in FNDB: filename={0}, directory={1}"), Q_(fileName), Q_(it->ToString())));
+      }
 #if FIND_FILE_DONT_TRIGGER_INSTALLER_IF_ALL
       if (found && all && IsMpmFile(it->GetData()))
       {
@@ -249,6 +253,31 @@ inline bool IsNewer(const PathName& path1, const PathName& path2)
   return File::Exists(path1) && File::Exists(path2) && File::GetLastWriteTime(path1) > File::GetLastWriteTime(path2);
 }
 
+vector<PathName> SessionImpl::GetFileNamesToTry(const string& fileName, const InternalFileTypeInfo* fti)
+{
+  // check to see whether the file name has a registered file name extension
+  PathName extension(PathName(fileName).GetExtension());
+  bool hasRegisteredExtension = !extension.Empty()
+    && (std::find_if(fti->fileNameExtensions.begin(), fti->fileNameExtensions.end(), [extension](const string& ext) { return extension == PathName(ext); }) != fti->fileNameExtensions.end()
+      || std::find_if(fti->alternateExtensions.begin(), fti->alternateExtensions.end(), [extension](const string& ext) { return extension == PathName(ext); }) != fti->alternateExtensions.end());
+
+  vector<PathName> fileNamesToTry;
+
+  // try each registered file name extension, if none was specified
+  if (!hasRegisteredExtension)
+  {
+    for (const string& ext : fti->fileNameExtensions)
+    {
+      fileNamesToTry.push_back(PathName(fileName).AppendExtension(ext));
+    }
+  }
+
+  // try it with the given file name
+  fileNamesToTry.push_back(PathName(fileName));
+
+  return fileNamesToTry;
+}
+
 bool SessionImpl::FindFileInternal(const string& fileName, FileType fileType, bool all, bool searchFileSystem, bool create, bool renew, vector<PathName>& result)
 {
   MIKTEX_ASSERT(result.empty());
@@ -276,25 +305,7 @@ bool SessionImpl::FindFileInternal(const string& fileName, FileType fileType, bo
   const InternalFileTypeInfo* fti = GetInternalFileTypeInfo(fileType);
   MIKTEX_ASSERT(fti != nullptr);
 
-  // check to see whether the file name has a registered file name extension
-  PathName extension(PathName(fileName).GetExtension());
-  bool hasRegisteredExtension = !extension.Empty()
-    && (std::find_if(fti->fileNameExtensions.begin(), fti->fileNameExtensions.end(), [extension](const string& ext) { return extension == PathName(ext); }) != fti->fileNameExtensions.end()
-      || std::find_if(fti->alternateExtensions.begin(), fti->alternateExtensions.end(), [extension](const string& ext) { return extension == PathName(ext); }) != fti->alternateExtensions.end());
-
-  vector<PathName> fileNamesToTry;
-
-  // try each registered file name extension, if none was specified
-  if (!hasRegisteredExtension)
-  {
-    for (const string& ext : fti->fileNameExtensions)
-    {
-      fileNamesToTry.push_back(PathName(fileName).AppendExtension(ext));
-    }
-  }
-
-  // try it with the given file name
-  fileNamesToTry.push_back(PathName(fileName));
+  vector<PathName> fileNamesToTry = GetFileNamesToTry(fileName, fti);
 
   // first round: use the fndb
   for (const PathName& fn : fileNamesToTry)
@@ -380,15 +391,181 @@ bool SessionImpl::FindFile(const string& fileName, FileType fileType, FindFileOp
 bool SessionImpl::FindFile(const string& fileName, FileType fileType, FindFileOptionSet options, PathName& result)
 {
   MIKTEX_ASSERT(!options[FindFileOption::All]);
+  string cacheKey;
+  if (fileType == FileType::EXE && !options[FindFileOption::Renew])
+  {
+    // tool chains resolve the same executables over and over again
+    string envPath;
+    Utils::GetEnvironmentString("PATH", envPath);
+    cacheKey = fileName + PathNameUtil::PathNameDelimiter + envPath;
+    auto it = executableCache.find(cacheKey);
+    if (it != executableCache.end() && File::Exists(it->second))
+    {
+      result = it->second;
+      return true;
+    }
+  }
   vector<PathName> paths;
   bool found = FindFile(fileName, fileType, options, paths);
   if (found)
   {
     result = paths[0];
+    if (!cacheKey.empty())
+    {
+      executableCache[cacheKey] = result;
+    }
   }
   return found;
 }
 
+void SessionImpl::ResetExecutableCache()
+{
+  // a cached location may be shadowed by a new root or FNDB entry
+  executableCache.clear();
+}
+
+size_t SessionImpl::FindFiles(const vector<string>& fileNames, FileType fileType, FindFileOptionSet options, vector<PathName>& result)
+{
+  MIKTEX_ASSERT(!options[FindFileOption::All]);
+
+  CoreStopWatch stopWatch(fmt::format("find {} files", fileNames.size()));
+
+  result.clear();
+  result.resize(fileNames.size());
+
+  // names which need the special treatment of FindFile()
+  vector<size_t> singles;
+
+  // names which can be looked up in the same pass over the search vector
+  struct Pending
+  {
+    size_t idx;
+    vector<PathName> fileNamesToTry;
+  };
+  vector<Pending> pending;
+
+  // the file type of the batch; derived from the first file name, if
+  // the caller didn't specify it
+  FileType batchFileType = FileType::None;
+  const InternalFileTypeInfo* fti = nullptr;
+  vector<PathName> vec;
+
+  for (size_t idx = 0; idx < fileNames.size(); ++idx)
+  {
+    const string& fileName = fileNames[idx];
+    FileType ft = fileType == FileType::None ? DeriveFileType(PathName(fileName)) : fileType;
+    if (ft == FileType::None
+      || ft == FileType::EXE
+      || options[FindFileOption::Renew]
+      || options[FindFileOption::Create] && (ft == FileType::BASE || ft == FileType::FMT || ft == FileType::MEM)
+      || PathNameUtil::IsAbsolutePath(fileName)
+      || IsExplicitlyRelativePath(fileName.c_str()))
+    {
+      singles.push_back(idx);
+      continue;
+    }
+    if (fti == nullptr)
+    {
+      batchFileType = ft;
+      fti = GetInternalFileTypeInfo(batchFileType);
+      MIKTEX_ASSERT(fti != nullptr);
+      vec = ConstructSearchVector(batchFileType);
+    }
+    else if (ft != batchFileType)
+    {
+      singles.push_back(idx);
+      continue;
+    }
+    pending.push_back({ idx, GetFileNamesToTry(fileName, fti) });
+  }
+
+  // first round: use the FNDB; the k-th pass tries the k-th file name
+  // candidate, so that the result is the same as with FindFile()
+  for (size_t k = 0; !pending.empty(); ++k)
+  {
+    vector<Pending*> candidates;
+    for (Pending& p : pending)
+    {
+      if (k < p.fileNamesToTry.size())
+      {
+        candidates.push_back(&p);
+      }
+    }
+    if (candidates.empty())
+    {
+      break;
+    }
+    vector<bool> found(candidates.size(), false);
+    size_t numFound = 0;
+    for (vector<PathName>::const_iterator it = vec.begin(); numFound < candidates.size() && it != vec.end(); ++it)
+    {
+      shared_ptr<FileNameDatabase> fndb = GetFileNameDatabase(it->GetData());
+      if (fndb == nullptr)
+      {
+        // search the file system because the FNDB does not exist
+        for (size_t i = 0; i < candidates.size(); ++i)
+        {
+          vector<PathName> paths;
+          if (!found[i] && SearchFileSystem(candidates[i]->fileNamesToTry[k].ToString(), it->GetData(), false, paths))
+          {
+            found[i] = true;
+            ++numFound;
+            result[candidates[i]->idx] = paths[0];
+          }
+        }
+        continue;
+      }
+      vector<pair<size_t, Fndb::Record>> hits;
+      for (size_t i = 0; i < candidates.size(); ++i)
+      {
+        vector<Fndb::Record> records;
+        if (!found[i] && fndb->Search(candidates[i]->fileNamesToTry[k], it->ToString(), false, records))
+        {
+          for (Fndb::Record& rec : records)
+          {
+            hits.push_back(make_pair(i, std::move(rec)));
+          }
+        }
+      }
+      // we must release the FNDB handle since CheckCandidate() might request an unload of the FNDB
+      fndb = nullptr;
+      for (pair<size_t, Fndb::Record>& hit : hits)
+      {
+        if (!found[hit.first] && CheckCandidate(hit.second.path, hit.second.fileNameInfo.c_str()))
+        {
+          found[hit.first] = true;
+          ++numFound;
+          result[candidates[hit.first]->idx] = hit.second.path;
+        }
+      }
+    }
+    if (numFound > 0)
+    {
+      pending.erase(std::remove_if(pending.begin(), pending.end(), [&result](const Pending& p) { return !result[p.idx].Empty(); }), pending.end());
+    }
+  }
+
+  // files which have not been found in the FNDB get the full treatment
+  if (options[FindFileOption::SearchFileSystem] || options[FindFileOption::Create])
+  {
+    for (const Pending& p : pending)
+    {
+      singles.push_back(p.idx);
+    }
+  }
+
+  for (size_t idx : singles)
+  {
+    PathName path;
+    if (FindFile(fileNames[idx], fileType, options, path))
+    {
+      result[idx] = path;
+    }
+  }
+
+  return std::count_if(result.begin(), result.end(), [](const PathName& path) { return !path.Empty(); });
+}
+
 static const string DEFAULT_PK_NAME_TEMPLATE = "%f.pk";
 
 bool SessionImpl::MakePkFileName(PathName& pkFileName, const string& fontName, int dpi)
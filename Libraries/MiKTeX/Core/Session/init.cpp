@@ -760,7 +760,13 @@ void SessionImpl::Uninitialize()
     initialized = false;
     trace_core->WriteLine("core", T_("uninitializing core library"));
     CheckOpenFiles();
+    if (fileNameRecorderStream.is_open())
+    {
+      // the recorder stream is flushed in batches only
+      fileNameRecorderStream.close();
+    }
     WritePackageHistory();
+    SaveSearchPathCache();
     inputDirectories.clear();
     UnregisterLibraryTraceStreams();
     configurationSettings.clear();
@@ -21,10 +21,19 @@
 
 #include "config.h"
 
+#include <cstring>
+
+#include <fstream>
+#include <mutex>
+
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
 #include <miktex/Core/Directory>
+#include <miktex/Core/File>
+#include <miktex/Core/MD5>
+#include <miktex/Core/Paths>
+#include <miktex/Core/Process>
 
 #include "internal.h"
 
@@ -397,13 +406,162 @@ void SessionImpl::ExpandBraces(const string& toBeExpanded, vector<PathName>& pat
   paths.insert(paths.end(), result.begin(), result.end());
 }
 
+// The cache file contains the magic line, the digest of the root
+// directories, and one line per search path: the search path followed
+// by its expansions, separated by tabs.
+const char* const SEARCH_PATH_CACHE_MAGIC = "MiKTeX search path cache 1";
+const char* const SEARCH_PATH_CACHE_FILENAME = "searchpaths.txt";
+const size_t MAX_CACHED_SEARCH_PATHS = 1000;
+
 vector<PathName> SessionImpl::ExpandBraces(const string& toBeExpanded)
 {
+  // short-lived programs expand the same configured search paths over
+  // and over again; the expansions only depend on the root directories
+  bool cacheable = initialized
+    && toBeExpanded.find_first_of("%{") != string::npos
+    && toBeExpanded.find_first_of("\t\n") == string::npos;
+  if (cacheable)
+  {
+    lock_guard<mutex> lockGuard(searchPathCacheMutex);
+    if (!searchPathCacheLoaded)
+    {
+      LoadSearchPathCache();
+    }
+    SearchPathDictionary::const_iterator it = searchPathCache.find(toBeExpanded);
+    if (it != searchPathCache.end())
+    {
+      return it->second;
+    }
+  }
   vector<PathName> paths = ExpandRootDirectories(toBeExpanded);
   vector<PathName> result;
   for (const PathName& path : paths)
   {
     ExpandBraces(path.GetData(), result);
   }
+  if (cacheable)
+  {
+    lock_guard<mutex> lockGuard(searchPathCacheMutex);
+    if (searchPathCache.size() < MAX_CACHED_SEARCH_PATHS)
+    {
+      searchPathCache[toBeExpanded] = result;
+      searchPathCacheDirty = true;
+    }
+  }
   return result;
 }
+
+PathName SessionImpl::GetSearchPathCacheFile()
+{
+  return GetSpecialPath(SpecialPath::DataRoot) / PathName(MIKTEX_PATH_MIKTEX_CACHE_DIR) / PathName(SEARCH_PATH_CACHE_FILENAME);
+}
+
+string SessionImpl::GetRootDirectoriesDigest()
+{
+  MD5Builder md5Builder;
+  for (unsigned idx = 0; idx < GetNumberOfTEXMFRoots(); ++idx)
+  {
+    string path = rootDirectories[idx].get_Path().ToString();
+    md5Builder.Update(path.c_str(), path.length() + 1);
+  }
+  const char* mpmRootPath = MPM_ROOT_PATH;
+  md5Builder.Update(mpmRootPath, strlen(mpmRootPath));
+  return md5Builder.Final().ToString();
+}
+
+void SessionImpl::LoadSearchPathCache()
+{
+  searchPathCacheLoaded = true;
+  searchPathCacheDigest = GetRootDirectoriesDigest();
+  PathName path = GetSearchPathCacheFile();
+  if (!File::Exists(path))
+  {
+    return;
+  }
+  try
+  {
+    ifstream stream = File::CreateInputStream(path);
+    string line;
+    if (!getline(stream, line) || line != SEARCH_PATH_CACHE_MAGIC || !getline(stream, line) || line != searchPathCacheDigest)
+    {
+      trace_filesearch->WriteLine("core", fmt::format(T_("ignoring outdated search path cache {0}"), Q_(path)));
+      return;
+    }
+    while (getline(stream, line))
+    {
+      vector<string> fields = StringUtil::Split(line, '\t');
+      if (fields.empty())
+      {
+        continue;
+      }
+      vector<PathName>& paths = searchPathCache[fields[0]];
+      paths.clear();
+      for (size_t idx = 1; idx < fields.size(); ++idx)
+      {
+        paths.push_back(PathName(fields[idx]));
+      }
+    }
+    trace_filesearch->WriteLine("core", fmt::format(T_("loaded {0} search paths from {1}"), searchPathCache.size(), Q_(path)));
+  }
+  catch (const exception& e)
+  {
+    // the cache is an optimization only
+    trace_filesearch->WriteLine("core", TraceLevel::Warning, fmt::format(T_("could not read search path cache {0}: {1}"), Q_(path), e.what()));
+    searchPathCache.clear();
+  }
+}
+
+void SessionImpl::SaveSearchPathCache()
+{
+  lock_guard<mutex> lockGuard(searchPathCacheMutex);
+  if (!searchPathCacheDirty)
+  {
+    return;
+  }
+  searchPathCacheDirty = false;
+  PathName path;
+  PathName tmp;
+  try
+  {
+    path = GetSearchPathCacheFile();
+    // write a temporary file and rename it, so that concurrent readers
+    // never see a partially written cache
+    tmp = path.ToString() + "." + std::to_string(Process::GetCurrentProcess()->GetSystemId()) + ".tmp";
+    ofstream stream = File::CreateOutputStream(tmp);
+    stream << SEARCH_PATH_CACHE_MAGIC << "\n" << searchPathCacheDigest << "\n";
+    for (const auto& entry : searchPathCache)
+    {
+      stream << entry.first;
+      for (const PathName& p : entry.second)
+      {
+        stream << '\t' << p.ToString();
+      }
+      stream << "\n";
+    }
+    stream.close();
+    File::Move(tmp, path, { FileMoveOption::ReplaceExisting });
+  }
+  catch (const exception& e)
+  {
+    trace_filesearch->WriteLine("core", TraceLevel::Warning, fmt::format(T_("could not write search path cache {0}: {1}"), Q_(path), e.what()));
+    try
+    {
+      if (!tmp.Empty() && File::Exists(tmp))
+      {
+        File::Delete(tmp);
+      }
+    }
+    catch (const exception&)
+    {
+    }
+  }
+}
+
+void SessionImpl::ResetSearchPathCache()
+{
+  // entries computed for other root directories must not be saved
+  lock_guard<mutex> lockGuard(searchPathCacheMutex);
+  searchPathCache.clear();
+  searchPathCacheLoaded = false;
+  searchPathCacheDirty = false;
+}
@@ -138,6 +138,9 @@ unsigned SessionImpl::RegisterRootDirectory(const PathName& root, RootDirectoryI
 
 void SessionImpl::InitializeRootDirectories(const StartupConfig& startupConfig, bool review)
 {
+  ResetSearchPathCache();
+  ResetExecutableCache();
+
   rootDirectories.clear();
 
   commonInstallRootIndex = INVALID_ROOT_INDEX;
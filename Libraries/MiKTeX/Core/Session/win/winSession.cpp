@@ -742,6 +742,7 @@ void Session::FatalWindowsError(const string& functionName, unsigned long errorC
   if (session != nullptr)
   {
     TraceWindowsError(functionName.c_str(), errorCode, info.ToString().c_str(), sourceLocation.fileName.c_str(), sourceLocation.lineNo);
+    session->FlushFileInfoRecorder();
     programInvocationName = session->initInfo.GetProgramInvocationName();
   }
   string errorMessage = T_("Windows API error ") + std::to_string(errorCode);
@@ -36,9 +36,12 @@
 
 #cmakedefine HAVE_CHOWN 1
 #cmakedefine HAVE_CONFSTR 1
+#cmakedefine HAVE_FOPENCOOKIE 1
 #cmakedefine HAVE_FORK 1
+#cmakedefine HAVE_FUNOPEN 1
 #cmakedefine HAVE_FUTIMES 1
 #cmakedefine HAVE_MMAP 1
+#cmakedefine HAVE_POSIX_SPAWN 1
 #cmakedefine HAVE_STATVFS 1
 #cmakedefine HAVE_UNAME_SYSCALL 1
 #cmakedefine HAVE_VFORK 1
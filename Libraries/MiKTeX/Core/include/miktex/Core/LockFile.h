@@ -29,6 +29,7 @@
 #include <cstddef>
 
 #include <chrono>
+#include <functional>
 #include <memory>
 
 #include "PathName.h"
@@ -56,6 +57,17 @@ public:
   /// @return Returns a smart pointer to the new `LockFile` object.
 public:
   static MIKTEXCORECEEAPI(std::unique_ptr<LockFile>) Create(const PathName& path);
+
+  /// Coordinates the (re)creation of a file shared by several processes.
+  /// Only one process creates the file. The others keep using the
+  /// previous version, or wait for the new one if there is none.
+  /// @param lockPath The file system path to the lock file.
+  /// @param find Finds the current version of the file.
+  /// @param create Creates the file.
+  /// @param timeout The maximum time waited for the new version.
+  /// @return Returns `true`, if the file is available.
+public:
+  static MIKTEXCORECEEAPI(bool) CreateOnce(const PathName& lockPath, std::function<bool(PathName&)> find, std::function<bool()> create, std::chrono::milliseconds timeout);
 };
 
 MIKTEX_CORE_END_NAMESPACE;
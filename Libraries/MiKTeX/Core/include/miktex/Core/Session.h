@@ -1690,6 +1690,16 @@ public:
 public:
   virtual std::tuple<ExamineCommandLineResult, std::string, std::string> ExamineCommandLine(const std::string& commandLine) = 0;
 
+  /// Searches several files of the same type.
+  /// @param fileNames The names of the files to search.
+  /// @param fileType The file type to search for.
+  /// @param options Search options (`FindFileOption::All` is not supported).
+  /// @param[out] result The result of the search: one entry for each
+  /// file name; the entry is empty, if the file was not found.
+  /// @return Returns the number of files found.
+public:
+  virtual std::size_t MIKTEXTHISCALL FindFiles(const std::vector<std::string>& fileNames, FileType fileType, FindFileOptionSet options, std::vector<PathName>& result) = 0;
+
   /// Throws a C/C++-runtime exception.
   /// @param functionName The name of the C/C++-runtime function.
   /// @param errorCode The `errno` value.
@@ -155,6 +155,9 @@ const char* const RECURSION_INDICATOR = "//";
 const size_t RECURSION_INDICATOR_LENGTH = 2;
 const char* const SESSIONSVC = "sessionsvc";
 
+// the file name recorder is flushed after this many lines
+const size_t RECORDER_FLUSH_LINES = 64;
+
 // The virtual TEXMF root MPM_ROOT_PATH is assigned to the MiKTeX
 // package manager.  We make sure that MPM_ROOT_PATH is a valid path
 // name.  On the other hand, it must not interfere with an existing
@@ -24,3 +24,5 @@
 
 #define DATAROOT "@dataroot@"
 #define INSTALLROOT "@installroot@"
+
+#cmakedefine HAVE_POSIX_SPAWN 1
@@ -31,6 +31,7 @@
 
 #include <miktex/Core/HasNamedValues>
 #include <miktex/Core/Session>
+#include <miktex/Util/StringUtil>
 
 using namespace MiKTeX::Core;
 using namespace MiKTeX::Test;
@@ -137,10 +138,23 @@ BEGIN_TEST_FUNCTION(2);
 }
 END_TEST_FUNCTION();
 
+BEGIN_TEST_FUNCTION(3);
+{
+  // the second expansion is served from the search path cache
+  string searchPath = pSession->Expand("%R/tex/{plain,generic}//", { ExpandOption::Braces }, nullptr);
+  TEST(pSession->Expand("%R/tex/{plain,generic}//", { ExpandOption::Braces }, nullptr) == searchPath);
+  for (const string& path : StringUtil::Split(searchPath, PathNameUtil::PathNameDelimiter))
+  {
+    TEST(PathNameUtil::IsAbsolutePath(path));
+  }
+}
+END_TEST_FUNCTION();
+
 BEGIN_TEST_PROGRAM();
 {
   CALL_TEST_FUNCTION(1);
   CALL_TEST_FUNCTION(2);
+  CALL_TEST_FUNCTION(3);
 }
 END_TEST_PROGRAM();
 
@@ -0,0 +1,126 @@
+/* 2.cpp:
+
+   Copyright (C) 2026 agent
+
+   This file is part of the MiKTeX Core Library.
+
+   The MiKTeX Core Library is free software; you can redistribute it
+   and/or modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2, or
+   (at your option) any later version.
+
+   The MiKTeX Core Library is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the MiKTeX Core Library; if not, write to the Free
+   Software Foundation, 59 Temple Place - Suite 330, Boston, MA
+   02111-1307, USA. */
+
+#include "config.h"
+
+#include <miktex/Core/Test>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <miktex/Core/Directory>
+#include <miktex/Core/File>
+#include <miktex/Core/Paths>
+#include <miktex/Core/Process>
+
+using namespace MiKTeX::Core;
+using namespace MiKTeX::Test;
+using namespace std;
+
+BEGIN_TEST_SCRIPT("expansion-2");
+
+const string SEARCH_PATH = "%R/tex/{plain,generic}//";
+const string SENTINEL = "/sentinel/from/cache";
+
+string ExpandInChildProcess(const vector<string>& args)
+{
+  PathName pathExe = pSession->GetMyLocation(false);
+  pathExe /= "core_expansion_test2-1" MIKTEX_EXE_FILE_SUFFIX;
+  vector<string> arguments{ pathExe.ToString() };
+  arguments.insert(arguments.end(), args.begin(), args.end());
+  int exitCode = -1;
+  ProcessOutput<4096> processOutput;
+  if (!Process::Run(pathExe, arguments, &processOutput, &exitCode, nullptr) || exitCode != 0)
+  {
+    MIKTEX_FATAL_ERROR("core_expansion_test2-1 failed");
+  }
+  return processOutput.StdoutToString();
+}
+
+PathName GetCacheFile()
+{
+  return pSession->GetSpecialPath(SpecialPath::DataRoot) / PathName(MIKTEX_PATH_MIKTEX_CACHE_DIR) / PathName("searchpaths.txt");
+}
+
+// a second process is served from the cache written by the first
+BEGIN_TEST_FUNCTION(1);
+{
+  PathName cacheFile = GetCacheFile();
+  if (File::Exists(cacheFile))
+  {
+    File::Delete(cacheFile);
+  }
+  string expansion = ExpandInChildProcess({ SEARCH_PATH });
+  TEST(expansion != SENTINEL + "\n");
+  TEST(File::Exists(cacheFile));
+  // replace the cached expansion so that a hit is observable
+  vector<string> lines;
+  bool found = false;
+  {
+    ifstream stream = File::CreateInputStream(cacheFile);
+    string line;
+    while (getline(stream, line))
+    {
+      if (line.compare(0, SEARCH_PATH.length() + 1, SEARCH_PATH + "\t") == 0)
+      {
+        line = SEARCH_PATH + "\t" + SENTINEL;
+        found = true;
+      }
+      lines.push_back(line);
+    }
+  }
+  TEST(found);
+  {
+    ofstream stream = File::CreateOutputStream(cacheFile);
+    for (const string& line : lines)
+    {
+      stream << line << "\n";
+    }
+  }
+  TEST(ExpandInChildProcess({ SEARCH_PATH }) == SENTINEL + "\n");
+}
+END_TEST_FUNCTION();
+
+// the cache is ignored once the root directories change
+BEGIN_TEST_FUNCTION(2);
+{
+  PathName extraRoot = pSession->GetSpecialPath(SpecialPath::DataRoot);
+  extraRoot.CutOffLastComponent();
+  extraRoot /= "extratexmf";
+  Directory::Create(extraRoot / PathName("tex/plain"));
+  string expansion = ExpandInChildProcess({ SEARCH_PATH, extraRoot.ToString() });
+  TEST(expansion != SENTINEL + "\n");
+  TEST(expansion.find(extraRoot.ToString()) != string::npos);
+  TEST(ExpandInChildProcess({ SEARCH_PATH }).find(extraRoot.ToString()) == string::npos);
+}
+END_TEST_FUNCTION();
+
+BEGIN_TEST_PROGRAM();
+{
+  CALL_TEST_FUNCTION(1);
+  CALL_TEST_FUNCTION(2);
+}
+END_TEST_PROGRAM();
+
+END_TEST_SCRIPT();
+
+RUN_TEST_SCRIPT();
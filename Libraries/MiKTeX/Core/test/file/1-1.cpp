@@ -0,0 +1,69 @@
+/* 1-1.cpp:
+
+   Copyright (C) 2026 agent
+
+   This file is part of the MiKTeX Core Library.
+
+   The MiKTeX Core Library is free software; you can redistribute it
+   and/or modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2, or
+   (at your option) any later version.
+
+   The MiKTeX Core Library is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the MiKTeX Core Library; if not, write to the Free
+   Software Foundation, 59 Temple Place - Suite 330, Boston, MA
+   02111-1307, USA. */
+
+#include "config.h"
+
+#include <cstdlib>
+#include <string>
+
+#include <miktex/Core/Test>
+
+using namespace MiKTeX::Core;
+using namespace MiKTeX::Test;
+using namespace std;
+
+BEGIN_TEST_SCRIPT("file-1-1");
+
+// a fatal error that escapes here terminates the process without
+// unwinding the session
+static void Crash() noexcept
+{
+  MIKTEX_FATAL_ERROR("file-1-1 crashed");
+}
+
+// args: recorder file, number of files, "fatal" or "abort"
+BEGIN_TEST_FUNCTION(1);
+{
+  TEST(pSession->StartFileInfoRecorder(false));
+  pSession->SetRecorderPath(PathName(vecArgs[0]));
+  int count = std::stoi(vecArgs[1]);
+  for (int i = 0; i < count; ++i)
+  {
+    FILE* file = pSession->OpenFile(PathName("recorded-" + std::to_string(i) + ".txt"), FileMode::Create, FileAccess::Write, false);
+    pSession->CloseFile(file);
+  }
+  if (vecArgs[2] == "fatal")
+  {
+    Crash();
+  }
+  abort();
+}
+END_TEST_FUNCTION();
+
+BEGIN_TEST_PROGRAM();
+{
+  CALL_TEST_FUNCTION(1);
+}
+END_TEST_PROGRAM();
+
+END_TEST_SCRIPT();
+
+RUN_TEST_SCRIPT();
@@ -23,8 +23,14 @@
 
 #include <miktex/Core/Test>
 
+#include <fstream>
+#include <string>
+#include <vector>
+
 #include <miktex/Core/File>
 #include <miktex/Core/FileStream>
+#include <miktex/Core/Paths>
+#include <miktex/Core/Process>
 
 using namespace std;
 
@@ -33,6 +39,64 @@ using namespace MiKTeX::Test;
 
 BEGIN_TEST_SCRIPT("file-1");
 
+// the recorder is flushed at least every 64 lines
+const size_t RECORDER_FLUSH_LINES = 64;
+
+// records count output files in a child process which then exits
+// abnormally; returns the OUTPUT lines of the recorder file
+vector<string> RecordAndCrash(const string& mode, int count)
+{
+  PathName pathExe = pSession->GetMyLocation(false);
+  pathExe /= "core_file_test1-1" MIKTEX_EXE_FILE_SUFFIX;
+  PathName recorder("crash.fls");
+  bool crashed;
+  try
+  {
+    int exitCode = 0;
+    Process::Run(pathExe, { pathExe.ToString(), recorder.ToString(), std::to_string(count), mode }, nullptr, &exitCode, nullptr);
+    crashed = exitCode != 0;
+  }
+  catch (const MiKTeXException&)
+  {
+    // terminated by a signal
+    crashed = true;
+  }
+  if (!crashed)
+  {
+    MIKTEX_FATAL_ERROR("core_file_test1-1 did not crash");
+  }
+  vector<string> lines;
+  {
+    ifstream stream = File::CreateInputStream(recorder);
+    string line;
+    while (getline(stream, line))
+    {
+      if (line.compare(0, 7, "OUTPUT ") == 0)
+      {
+        lines.push_back(line.substr(7));
+      }
+    }
+  }
+  File::Delete(recorder);
+  for (int i = 0; i < count; ++i)
+  {
+    File::Delete(PathName("recorded-" + std::to_string(i) + ".txt"));
+  }
+  return lines;
+}
+
+bool IsPrefix(const vector<string>& lines)
+{
+  for (size_t i = 0; i < lines.size(); ++i)
+  {
+    if (PathName(lines[i]) != PathName("recorded-" + std::to_string(i) + ".txt"))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 BEGIN_TEST_FUNCTION(1);
 {
 #if defined(MIKTEX_WINDOWS)
@@ -61,10 +125,56 @@ BEGIN_TEST_FUNCTION(2);
 }
 END_TEST_FUNCTION();
 
+BEGIN_TEST_FUNCTION(3);
+{
+  TEST(pSession->StartFileInfoRecorder(false));
+  Touch("recorded.txt");
+  for (int i = 0; i < 3; ++i)
+  {
+    FILE* file = pSession->OpenFile(PathName("recorded.txt"), FileMode::Open, FileAccess::Read, false);
+    pSession->CloseFile(file);
+  }
+  FILE* file = pSession->OpenFile(PathName("recorded.txt"), FileMode::Append, FileAccess::Write, false);
+  pSession->CloseFile(file);
+  size_t count = 0;
+  for (const FileInfoRecord& fir : pSession->GetFileInfoRecords())
+  {
+    if (PathName(fir.fileName) == PathName("recorded.txt"))
+    {
+      ++count;
+    }
+  }
+  TEST(count == 2);
+  File::Delete(PathName("recorded.txt"));
+}
+END_TEST_FUNCTION();
+
+// a fatal error flushes the recorder, even if the process then
+// terminates without unwinding
+BEGIN_TEST_FUNCTION(4);
+{
+  vector<string> lines = RecordAndCrash("fatal", 100);
+  TEST(lines.size() == 100);
+  TEST(IsPrefix(lines));
+}
+END_TEST_FUNCTION();
+
+// a hard crash loses at most the lines of one flush batch
+BEGIN_TEST_FUNCTION(5);
+{
+  vector<string> lines = RecordAndCrash("abort", 100);
+  TEST(lines.size() > 100 - RECORDER_FLUSH_LINES);
+  TEST(IsPrefix(lines));
+}
+END_TEST_FUNCTION();
+
 BEGIN_TEST_PROGRAM();
 {
   CALL_TEST_FUNCTION(1);
   CALL_TEST_FUNCTION(2);
+  CALL_TEST_FUNCTION(3);
+  CALL_TEST_FUNCTION(4);
+  CALL_TEST_FUNCTION(5);
 }
 END_TEST_PROGRAM();
 
@@ -103,6 +103,36 @@ BEGIN_TEST_FUNCTION(3);
   TESTX(Fndb::Add({ {PathName(path)} }));
   TESTX(pSession->UnloadFilenameDatabase());
   TEST(Fndb::FileExists(path));
+  PathName path2 = pSession->GetSpecialPath(SpecialPath::InstallRoot) / PathName("abrakadabra") / PathName("hello.txt");
+  TEST(!Fndb::FileExists(path2));
+  TESTX(Fndb::Add({ {PathName(path2)} }));
+  TEST(Fndb::FileExists(path2));
+  TEST(!Fndb::FileExists(pSession->GetSpecialPath(SpecialPath::InstallRoot) / PathName("abrakadabra") / PathName("no-such-file.txt")));
+}
+END_TEST_FUNCTION();
+
+BEGIN_TEST_FUNCTION(4);
+{
+  vector<string> fileNames = { "test.tex", "test", "base/test.tex", "nonexistent-file.tex", "test.cls" };
+  vector<PathName> paths;
+  size_t numFound = pSession->FindFiles(fileNames, FileType::TEX, {}, paths);
+  TEST(paths.size() == fileNames.size());
+  size_t n = 0;
+  for (size_t idx = 0; idx < fileNames.size(); ++idx)
+  {
+    PathName path;
+    if (pSession->FindFile(fileNames[idx], FileType::TEX, path))
+    {
+      TEST(paths[idx] == path);
+      ++n;
+    }
+    else
+    {
+      TEST(paths[idx].Empty());
+    }
+  }
+  TEST(numFound == n);
+  TEST(paths[3].Empty());
 }
 END_TEST_FUNCTION();
 
@@ -111,6 +141,7 @@ BEGIN_TEST_PROGRAM();
   CALL_TEST_FUNCTION(1);
   CALL_TEST_FUNCTION(2);
   CALL_TEST_FUNCTION(3);
+  CALL_TEST_FUNCTION(4);
 }
 END_TEST_PROGRAM();
 
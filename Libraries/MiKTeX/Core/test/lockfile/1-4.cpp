@@ -0,0 +1,96 @@
+/* 1-4.cpp:
+
+   Copyright (C) 2026 agent
+
+   This file is part of the MiKTeX Core Library.
+
+   The MiKTeX Core Library is free software; you can redistribute it
+   and/or modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2, or
+   (at your option) any later version.
+   
+   The MiKTeX Core Library is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with the MiKTeX Core Library; if not, write to the Free
+   Software Foundation, 59 Temple Place - Suite 330, Boston, MA
+   02111-1307, USA. */
+
+#include "config.h"
+
+#include <miktex/Core/Test>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <miktex/Core/File>
+#include <miktex/Core/FileStream>
+#include <miktex/Core/LockFile>
+#include <miktex/Core/PathName>
+#include <miktex/Core/Process>
+
+using namespace std;
+using namespace chrono_literals;
+
+using namespace MiKTeX::Core;
+using namespace MiKTeX::Test;
+
+// mimics an engine which finds its memory dump file missing or stale
+// and rebuilds it like Application::TryCreateFile does
+
+#define FORMAT_CONTENTS "complete format\n"
+
+BEGIN_TEST_SCRIPT("lockfile-1-4");
+
+BEGIN_TEST_FUNCTION(1);
+{
+  PathName format("format-1.fmt");
+  PathName staleMarker("format-1.stale");
+  if (!File::Exists(format) || File::Exists(staleMarker))
+  {
+    auto find = [&](PathName& existing)
+    {
+      existing = format;
+      return File::Exists(format);
+    };
+    auto create = [&]()
+    {
+      PathName tmp(format.ToString() + "." + std::to_string(Process::GetCurrentProcess()->GetSystemId()) + ".tmp");
+      FileStream writer(File::Open(tmp, FileMode::Create, FileAccess::Write, false));
+      string contents = FORMAT_CONTENTS;
+      writer.Write(contents.c_str(), contents.length() / 2);
+      this_thread::sleep_for(500ms);
+      writer.Write(contents.c_str() + contents.length() / 2, contents.length() - contents.length() / 2);
+      writer.Close();
+      File::Move(tmp, format, { FileMoveOption::ReplaceExisting });
+      if (File::Exists(staleMarker))
+      {
+        File::Delete(staleMarker);
+      }
+      FileStream builds(File::Open(PathName("builds-1"), FileMode::Append, FileAccess::Write, false));
+      builds.Write("+\n", 2);
+      builds.Close();
+      return true;
+    };
+    TEST(LockFile::CreateOnce(PathName("format-1.lock"), find, create, 60s));
+  }
+  vector<unsigned char> bytes = File::ReadAllBytes(format);
+  TEST(string(bytes.begin(), bytes.end()) == FORMAT_CONTENTS);
+}
+END_TEST_FUNCTION();
+
+BEGIN_TEST_PROGRAM();
+{
+  CALL_TEST_FUNCTION(1);
+}
+END_TEST_PROGRAM();
+
+END_TEST_SCRIPT();
+
+RUN_TEST_SCRIPT();
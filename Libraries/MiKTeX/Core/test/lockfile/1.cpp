@@ -23,9 +23,13 @@
 
 #include <miktex/Core/Test>
 
+#include <algorithm>
 #include <chrono>
+#include <ctime>
 #include <memory>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include <miktex/Core/File>
 #include <miktex/Core/FileStream>
@@ -95,12 +99,75 @@ BEGIN_TEST_FUNCTION(4);
 }
 END_TEST_FUNCTION();
 
+// engines launched in parallel must rebuild a format only once and
+// must never read a partially written one
+#define NUM_ENGINES 8
+
+bool RunEngines(size_t& numBuilds)
+{
+  PathName pathExe = pSession->GetMyLocation(false);
+  pathExe /= "core_lockfile_test1-4" MIKTEX_EXE_FILE_SUFFIX;
+  vector<unique_ptr<Process>> engines;
+  for (int n = 0; n < NUM_ENGINES; ++n)
+  {
+    engines.push_back(Process::Start(ProcessStartInfo(pathExe)));
+  }
+  bool succeeded = true;
+  for (unique_ptr<Process>& engine : engines)
+  {
+    engine->WaitForExit();
+    succeeded = succeeded && engine->get_ExitCode() == 0;
+  }
+  vector<unsigned char> builds = File::ReadAllBytes(PathName("builds-1"));
+  numBuilds = std::count(builds.begin(), builds.end(), '\n');
+  return succeeded;
+}
+
+BEGIN_TEST_FUNCTION(5);
+{
+  size_t numBuilds;
+  TEST(RunEngines(numBuilds));
+  TEST(numBuilds == 1);
+  // now the format is stale: one engine rebuilds it, while the others
+  // keep using the previous one; the new one must be recognizably newer
+  time_t past = time(nullptr) - 60;
+  TESTX(File::SetTimes(PathName("format-1.fmt"), past, past, past));
+  FileStream staleMarker(File::Open(PathName("format-1.stale"), FileMode::Create, FileAccess::Write, false));
+  staleMarker.Close();
+  TEST(RunEngines(numBuilds));
+  TEST(numBuilds == 2);
+  TESTX(File::Delete(PathName("format-1.fmt")));
+  TESTX(File::Delete(PathName("builds-1")));
+}
+END_TEST_FUNCTION();
+
+// a lock file which never got a valid owner is abandoned after a while
+BEGIN_TEST_FUNCTION(6);
+{
+  for (const string& contents : { ""s, "99999999999999999999\nengine\n"s })
+  {
+    PathName path("lockfile-6");
+    FileStream stream(File::Open(path, FileMode::Create, FileAccess::Write, false));
+    stream.Write(contents.c_str(), contents.length());
+    stream.Close();
+    unique_ptr<MiKTeX::Core::LockFile> lockFile = LockFile::Create(path);
+    TEST(!lockFile->TryLock(0ms));
+    time_t past = time(nullptr) - 60;
+    TESTX(File::SetTimes(path, past, past, past));
+    TEST(lockFile->TryLock(0ms));
+    TESTX(lockFile->Unlock());
+  }
+}
+END_TEST_FUNCTION();
+
 BEGIN_TEST_PROGRAM();
 {
   CALL_TEST_FUNCTION(1);
   CALL_TEST_FUNCTION(2);
   CALL_TEST_FUNCTION(3);
   CALL_TEST_FUNCTION(4);
+  CALL_TEST_FUNCTION(5);
+  CALL_TEST_FUNCTION(6);
 }
 END_TEST_PROGRAM();
 
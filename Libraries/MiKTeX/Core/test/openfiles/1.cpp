@@ -0,0 +1,133 @@
+/* 1.cpp:
+
+   Copyright (C) 2026 agent
+
+   This file is part of the MiKTeX Core Library.
+
+   The MiKTeX Core Library is free software; you can redistribute it
+   and/or modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2, or
+   (at your option) any later version.
+
+   The MiKTeX Core Library is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the MiKTeX Core Library; if not, write to the Free
+   Software Foundation, 59 Temple Place - Suite 330, Boston, MA
+   02111-1307, USA. */
+
+#include "config.h"
+
+#include <miktex/Core/Test>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <miktex/Core/Exceptions>
+#include <miktex/Core/File>
+
+using namespace MiKTeX::Core;
+using namespace MiKTeX::Test;
+using namespace std;
+
+#define NUM_THREADS 8
+#define NUM_ROUNDS 500
+#define NUM_FILES 4
+
+BEGIN_TEST_SCRIPT("openfiles-1");
+
+atomic<int> errors;
+
+void OpenAndClose(int id)
+{
+  vector<FILE*> inputFiles;
+  for (int round = 0; round < NUM_ROUNDS; ++round)
+  {
+    PathName path("openfiles-" + std::to_string(id) + "-" + std::to_string(round % NUM_FILES) + ".txt");
+    FILE* output = pSession->OpenFile(path, FileMode::Create, FileAccess::Write, false);
+    pair<bool, Session::OpenFileInfo> info = pSession->TryGetOpenFileInfo(output);
+    if (!info.first || PathName(info.second.fileName) != path || !pSession->IsOutputFile(output))
+    {
+      ++errors;
+    }
+    fputs(path.GetData(), output);
+    pSession->CloseFile(output);
+    FILE* input = pSession->OpenFile(path, FileMode::Open, FileAccess::Read, false);
+    if (!pSession->TryGetOpenFileInfo(input).first || pSession->IsOutputFile(input))
+    {
+      ++errors;
+    }
+    // keep some files open, so that registered files pile up
+    inputFiles.push_back(input);
+    if (inputFiles.size() >= NUM_FILES)
+    {
+      for (FILE* file : inputFiles)
+      {
+        pSession->CloseFile(file);
+        if (pSession->TryGetOpenFileInfo(file).first)
+        {
+          ++errors;
+        }
+      }
+      inputFiles.clear();
+    }
+  }
+  for (FILE* file : inputFiles)
+  {
+    pSession->CloseFile(file);
+  }
+}
+
+void Thread(int id)
+{
+  try
+  {
+    OpenAndClose(id);
+  }
+  catch (const MiKTeX::Core::MiKTeXException& e)
+  {
+    ++errors;
+    LOG4CXX_FATAL(logger, e.what());
+    LOG4CXX_FATAL(logger, "Info: " << e.GetInfo());
+    LOG4CXX_FATAL(logger, "Source: " << e.GetSourceFile());
+    LOG4CXX_FATAL(logger, "Line: " << e.GetSourceLine());
+  }
+}
+
+BEGIN_TEST_FUNCTION(1);
+{
+  errors = 0;
+  vector<thread> threads;
+  for (int id = 0; id < NUM_THREADS; ++id)
+  {
+    threads.push_back(thread(&MyTestScript::Thread, this, id));
+  }
+  for (thread& t : threads)
+  {
+    t.join();
+  }
+  TEST(errors == 0);
+  for (int id = 0; id < NUM_THREADS; ++id)
+  {
+    for (int n = 0; n < NUM_FILES; ++n)
+    {
+      File::Delete(PathName("openfiles-" + std::to_string(id) + "-" + std::to_string(n) + ".txt"));
+    }
+  }
+}
+END_TEST_FUNCTION();
+
+BEGIN_TEST_PROGRAM();
+{
+  CALL_TEST_FUNCTION(1);
+}
+END_TEST_PROGRAM();
+
+END_TEST_SCRIPT();
+
+RUN_TEST_SCRIPT();
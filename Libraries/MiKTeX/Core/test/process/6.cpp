@@ -0,0 +1,132 @@
+/* 6.cpp:
+
+   Copyright (C) 2026 agent
+
+   This file is part of the MiKTeX Core Library.
+
+   The MiKTeX Core Library is free software; you can redistribute it
+   and/or modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2, or
+   (at your option) any later version.
+   
+   The MiKTeX Core Library is distributed in the hope that it will be
+   useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+   of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   
+   You should have received a copy of the GNU General Public License
+   along with the MiKTeX Core Library; if not, write to the Free
+   Software Foundation, 59 Temple Place - Suite 330, Boston, MA
+   02111-1307, USA. */
+
+#include "config.h"
+
+#include <miktex/Core/Test>
+
+#include <miktex/Core/Paths>
+#include <miktex/Core/Process>
+
+using namespace MiKTeX::Core;
+using namespace MiKTeX::Test;
+using namespace std;
+
+BEGIN_TEST_SCRIPT("process-6");
+
+// the timing loop lives in benchmarks/spawn.cpp
+const int NUM_SPAWNS = 5;
+
+// children started with posix_spawn() and with fork(), as traced by
+// Process::Start()
+int numSpawned = 0;
+int numForked = 0;
+
+bool MIKTEXTHISCALL Trace(const MiKTeX::Trace::TraceCallback::TraceMessage& traceMessage) override
+{
+  if (traceMessage.streamName == MIKTEX_TRACE_PROCESS)
+  {
+    if (traceMessage.message.compare(0, 12, "posix_spawn:") == 0)
+    {
+      ++numSpawned;
+    }
+    else if (traceMessage.message == "forking...")
+    {
+      ++numForked;
+    }
+  }
+  return TestScript::Trace(traceMessage);
+}
+
+// true, if n children have been started on the path Process::Start()
+// takes for them
+bool StartedBy(bool spawn, int n)
+{
+#if defined(HAVE_POSIX_SPAWN)
+  bool result = spawn ? numSpawned == n && numForked == 0 : numSpawned == 0 && numForked == n;
+#else
+  bool result = numSpawned == 0;
+#endif
+  numSpawned = 0;
+  numForked = 0;
+  return result;
+}
+
+BEGIN_TEST_FUNCTION(1);
+{
+  PathName pathExe = pSession->GetMyLocation(false);
+  pathExe /= "core_process_test6-1" MIKTEX_EXE_FILE_SUFFIX;
+  for (int n = 0; n < NUM_SPAWNS; ++n)
+  {
+    int exitCode = -1;
+    TEST(Process::Run(pathExe, { pathExe.ToString() }, nullptr, &exitCode, nullptr));
+    TEST(exitCode == 0);
+  }
+  TEST(StartedBy(true, NUM_SPAWNS));
+}
+END_TEST_FUNCTION();
+
+BEGIN_TEST_FUNCTION(2);
+{
+  PathName pathExe = pSession->GetMyLocation(false);
+  pathExe /= "core_process_test6-1" MIKTEX_EXE_FILE_SUFFIX;
+  for (int n = 0; n < NUM_SPAWNS; ++n)
+  {
+    int exitCode = -1;
+    ProcessOutput<16> processOutput;
+    TEST(Process::Run(pathExe, { pathExe.ToString(), "ok" }, &processOutput, &exitCode, nullptr));
+    TEST(exitCode == 0);
+    TEST(processOutput.StdoutToString() == "ok\n");
+  }
+  TEST(StartedBy(true, NUM_SPAWNS));
+}
+END_TEST_FUNCTION();
+
+// posix_spawn() cannot change the working directory: fork() is used
+BEGIN_TEST_FUNCTION(3);
+{
+  PathName pathExe = pSession->GetMyLocation(false);
+  pathExe /= "core_process_test6-1" MIKTEX_EXE_FILE_SUFFIX;
+  PathName cwd;
+  cwd.SetToCurrentDirectory();
+  for (int n = 0; n < NUM_SPAWNS; ++n)
+  {
+    int exitCode = -1;
+    ProcessOutput<16> processOutput;
+    TEST(Process::Run(pathExe, { pathExe.ToString(), "ok" }, &processOutput, &exitCode, cwd.GetData()));
+    TEST(exitCode == 0);
+    TEST(processOutput.StdoutToString() == "ok\n");
+  }
+  TEST(StartedBy(false, NUM_SPAWNS));
+}
+END_TEST_FUNCTION();
+
+BEGIN_TEST_PROGRAM();
+{
+  CALL_TEST_FUNCTION(1);
+  CALL_TEST_FUNCTION(2);
+  CALL_TEST_FUNCTION(3);
+}
+END_TEST_PROGRAM();
+
+END_TEST_SCRIPT();
+
+RUN_TEST_SCRIPT();
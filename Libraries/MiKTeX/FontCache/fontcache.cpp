@@ -0,0 +1,364 @@
+/* fontcache.cpp:
+
+   Copyright (C) 2026 agent
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published
+   by the Free Software Foundation; either version 2, or (at your
+   option) any later version.
+
+   This file is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this file; if not, write to the Free Software
+   Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+   USA.  */
+
+#include "miktex/fontcache.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#if defined(MIKTEX_WINDOWS)
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include <miktex/Core/Directory>
+#include <miktex/Core/DirectoryLister>
+#include <miktex/Core/File>
+#include <miktex/Core/MD5>
+#include <miktex/Core/Paths>
+#include <miktex/Core/Process>
+#include <miktex/Core/Session>
+
+using namespace MiKTeX::Core;
+using namespace std;
+
+// Entry layout: MAGIC, MD5 of the data (16 bytes), data.  Entries are
+// written to a temporary file which is then renamed, so that readers
+// never see a partially written entry; the checksum guards against
+// anything else.
+const char MAGIC[] = "MiKTeX font subset cache 1\n";
+const size_t MAGIC_SIZE = sizeof(MAGIC) - 1;
+const size_t HEADER_SIZE = MAGIC_SIZE + 16;
+
+// After eviction, the cache occupies at most this fraction of the
+// configured size, so that not every store has to evict.
+const double LOW_WATER_MARK = 0.8;
+
+static bool GetCacheDirectory(const char* program, PathName& directory, size_t& maxSize)
+{
+  shared_ptr<Session> session = Session::Get();
+  int megabytes = session->GetConfigValue(program, "FontCacheSize", ConfigValue(0)).GetInt();
+  if (megabytes <= 0)
+  {
+    return false;
+  }
+  maxSize = static_cast<size_t>(megabytes) * 1024 * 1024;
+  directory = session->GetSpecialPath(SpecialPath::DataRoot);
+  directory /= MIKTEX_PATH_MIKTEX_CACHE_DIR;
+  directory /= "fonts";
+  directory /= program;
+  return true;
+}
+
+// Identifies the contents of an open font file without reading it:
+// the file (device and inode, or volume and file index), its size and
+// its modification time.
+struct FontFileId
+{
+  unsigned long long device;
+  unsigned long long index;
+  unsigned long long size;
+  long long modified;
+  bool operator<(const FontFileId& other) const
+  {
+    return tie(device, index, size, modified) < tie(other.device, other.index, other.size, other.modified);
+  }
+};
+
+static bool GetFontFileId(FILE* fontFile, FontFileId& id)
+{
+#if defined(MIKTEX_WINDOWS)
+  HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(fontFile)));
+  BY_HANDLE_FILE_INFORMATION info;
+  if (handle == INVALID_HANDLE_VALUE || !GetFileInformationByHandle(handle, &info))
+  {
+    return false;
+  }
+  id.device = info.dwVolumeSerialNumber;
+  id.index = (static_cast<unsigned long long>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+  id.size = (static_cast<unsigned long long>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+  id.modified = (static_cast<long long>(info.ftLastWriteTime.dwHighDateTime) << 32) | info.ftLastWriteTime.dwLowDateTime;
+#else
+  struct stat statbuf;
+  if (fstat(fileno(fontFile), &statbuf) != 0)
+  {
+    return false;
+  }
+  id.device = statbuf.st_dev;
+  id.index = statbuf.st_ino;
+  id.size = statbuf.st_size;
+  id.modified = statbuf.st_mtime;
+#endif
+  return true;
+}
+
+struct CacheState
+{
+  mutex mtx;
+  // digests of the font files seen by this process
+  map<FontFileId, MD5> fontDigests;
+  // directory => estimated size of the cache; see Evict()
+  map<string, size_t> cacheSizes;
+};
+
+static CacheState& GetCacheState()
+{
+  static CacheState state;
+  return state;
+}
+
+static MD5 GetFontDigest(FILE* fontFile)
+{
+  CacheState& state = GetCacheState();
+  FontFileId id;
+  bool haveId = GetFontFileId(fontFile, id);
+  if (haveId)
+  {
+    lock_guard<mutex> lock(state.mtx);
+    auto it = state.fontDigests.find(id);
+    if (it != state.fontDigests.end())
+    {
+      return it->second;
+    }
+  }
+  MD5Builder md5Builder;
+  long pos = ftell(fontFile);
+  fseek(fontFile, 0, SEEK_SET);
+  char buf[8192];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), fontFile)) > 0)
+  {
+    md5Builder.Update(buf, n);
+  }
+  clearerr(fontFile);
+  fseek(fontFile, pos, SEEK_SET);
+  MD5 md5 = md5Builder.Final();
+  if (haveId)
+  {
+    lock_guard<mutex> lock(state.mtx);
+    state.fontDigests[id] = md5;
+  }
+  return md5;
+}
+
+static PathName GetEntryPath(const PathName& directory, const char* program, FILE* fontFile, const void* key, size_t keySize)
+{
+  MD5 fontDigest = GetFontDigest(fontFile);
+  MD5Builder md5Builder;
+  md5Builder.Update(program, strlen(program) + 1);
+  md5Builder.Update(&fontDigest[0], fontDigest.size());
+  md5Builder.Update(key, keySize);
+  PathName path = directory;
+  path /= md5Builder.Final().ToString();
+  return path;
+}
+
+// Lists the cache directory and evicts least recently used entries
+// if the cache is larger than maxSize.  Returns the resulting size.
+static size_t Evict(const PathName& directory, size_t maxSize)
+{
+  struct Entry
+  {
+    PathName path;
+    size_t size;
+    time_t lastUsed;
+  };
+  vector<Entry> entries;
+  size_t totalSize = 0;
+  unique_ptr<DirectoryLister> lister = DirectoryLister::Open(directory, nullptr, (int)DirectoryLister::Options::FilesOnly);
+  DirectoryEntry2 dirEntry;
+  while (lister->GetNext(dirEntry))
+  {
+    Entry entry;
+    entry.path = directory / PathName(dirEntry.name);
+    entry.size = dirEntry.size;
+    time_t creationTime, lastAccessTime;
+    try
+    {
+      File::GetTimes(entry.path, creationTime, lastAccessTime, entry.lastUsed);
+    }
+    catch (const MiKTeXException&)
+    {
+      // evicted by another process
+      continue;
+    }
+    totalSize += entry.size;
+    entries.push_back(entry);
+  }
+  lister->Close();
+  if (totalSize <= maxSize)
+  {
+    return totalSize;
+  }
+  sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastUsed < b.lastUsed; });
+  for (const Entry& entry : entries)
+  {
+    if (totalSize <= maxSize * LOW_WATER_MARK)
+    {
+      break;
+    }
+    try
+    {
+      File::Delete(entry.path, { FileDeleteOption::TryHard });
+    }
+    catch (const MiKTeXException&)
+    {
+      // another process might have evicted it already, or still be
+      // reading it (Windows)
+    }
+    totalSize -= entry.size;
+  }
+  return totalSize;
+}
+
+// The cache directory is listed once per process; afterwards, stores
+// are added to the estimate and the directory is listed again (and
+// evicted in one batch) only when the estimate exceeds maxSize.
+// Stores by other processes are picked up by that listing.
+static void AccountForStore(const PathName& directory, size_t maxSize, size_t entrySize)
+{
+  CacheState& state = GetCacheState();
+  lock_guard<mutex> lock(state.mtx);
+  auto it = state.cacheSizes.find(directory.ToString());
+  if (it == state.cacheSizes.end())
+  {
+    state.cacheSizes[directory.ToString()] = Evict(directory, maxSize);
+    return;
+  }
+  it->second += entrySize;
+  if (it->second > maxSize)
+  {
+    it->second = Evict(directory, maxSize);
+  }
+}
+
+extern "C" int miktex_font_cache_enabled(const char* program)
+{
+  try
+  {
+    PathName directory;
+    size_t maxSize;
+    return GetCacheDirectory(program, directory, maxSize) ? 1 : 0;
+  }
+  catch (const exception&)
+  {
+    return 0;
+  }
+}
+
+extern "C" void* miktex_font_cache_get(const char* program, FILE* fontFile, const void* key, size_t keySize, size_t* size)
+{
+  try
+  {
+    PathName directory;
+    size_t maxSize;
+    if (!GetCacheDirectory(program, directory, maxSize))
+    {
+      return nullptr;
+    }
+    PathName path = GetEntryPath(directory, program, fontFile, key, keySize);
+    if (!File::Exists(path))
+    {
+      return nullptr;
+    }
+    vector<unsigned char> bytes = File::ReadAllBytes(path);
+    if (bytes.size() < HEADER_SIZE || memcmp(&bytes[0], MAGIC, MAGIC_SIZE) != 0)
+    {
+      return nullptr;
+    }
+    MD5Builder md5Builder;
+    md5Builder.Update(&bytes[HEADER_SIZE], bytes.size() - HEADER_SIZE);
+    MD5 md5 = md5Builder.Final();
+    if (memcmp(&md5[0], &bytes[MAGIC_SIZE], 16) != 0)
+    {
+      return nullptr;
+    }
+    // least recently used is least recently written or read
+    File::SetTimes(path, static_cast<time_t>(-1), static_cast<time_t>(-1), static_cast<time_t>(-1));
+    *size = bytes.size() - HEADER_SIZE;
+    void* data = malloc(*size > 0 ? *size : 1);
+    if (data != nullptr)
+    {
+      memcpy(data, &bytes[HEADER_SIZE], *size);
+    }
+    return data;
+  }
+  catch (const exception&)
+  {
+    // entry vanished or cannot be read: treat as a miss
+    return nullptr;
+  }
+}
+
+extern "C" void miktex_font_cache_put(const char* program, FILE* fontFile, const void* key, size_t keySize, const void* data, size_t size)
+{
+  try
+  {
+    PathName directory;
+    size_t maxSize;
+    if (!GetCacheDirectory(program, directory, maxSize) || size + HEADER_SIZE > maxSize)
+    {
+      return;
+    }
+    Directory::Create(directory);
+    PathName path = GetEntryPath(directory, program, fontFile, key, keySize);
+    vector<unsigned char> bytes(HEADER_SIZE + size);
+    memcpy(&bytes[0], MAGIC, MAGIC_SIZE);
+    MD5Builder md5Builder;
+    md5Builder.Update(data, size);
+    MD5 md5 = md5Builder.Final();
+    memcpy(&bytes[MAGIC_SIZE], &md5[0], 16);
+    if (size > 0)
+    {
+      memcpy(&bytes[HEADER_SIZE], data, size);
+    }
+    PathName tempPath = path;
+    tempPath.AppendExtension(std::to_string(Process::GetCurrentProcess()->GetSystemId()));
+    tempPath.AppendExtension(".tmp");
+    try
+    {
+      File::WriteBytes(tempPath, bytes);
+      File::Move(tempPath, path, { FileMoveOption::ReplaceExisting });
+    }
+    catch (const MiKTeXException&)
+    {
+      // e.g., another process is reading the entry (Windows)
+      if (File::Exists(tempPath))
+      {
+        File::Delete(tempPath);
+      }
+      throw;
+    }
+    AccountForStore(directory, maxSize, bytes.size());
+  }
+  catch (const exception&)
+  {
+    // the cache is an optimization only
+  }
+}
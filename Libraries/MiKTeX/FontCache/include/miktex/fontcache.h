@@ -0,0 +1,52 @@
+/* miktex/fontcache.h:
+
+   Copyright (C) 2026 agent
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published
+   by the Free Software Foundation; either version 2, or (at your
+   option) any later version.
+
+   This file is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this file; if not, write to the Free Software
+   Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+   USA.  */
+
+/* Cross-run cache for embedded font subsets (used by dvipdfmx and
+   dvips).  Entries are addressed by the digest of the font file
+   contents plus a caller-defined key, which describes the subset
+   (glyph set, encoding, ...).
+
+   The cache is disabled unless the configuration value
+   [<program>]FontCacheSize (in megabytes) is greater than zero.  */
+
+#pragma once
+
+#if defined(__cplusplus)
+#include <cstddef>
+#include <cstdio>
+#else
+#include <stddef.h>
+#include <stdio.h>
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+int miktex_font_cache_enabled(const char* program);
+
+/* Returns a malloc'ed copy of the cached data, or NULL.  The file
+   position of fontFile is preserved. */
+void* miktex_font_cache_get(const char* program, FILE* fontFile, const void* key, size_t keySize, size_t* size);
+
+void miktex_font_cache_put(const char* program, FILE* fontFile, const void* key, size_t keySize, const void* data, size_t size);
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,69 @@
+/* 1-1.cpp:
+
+   Copyright (C) 2026 agent
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published
+   by the Free Software Foundation; either version 2, or (at your
+   option) any later version.
+
+   This file is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this file; if not, write to the Free Software
+   Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+   USA.  */
+
+#include "config.h"
+
+#include <miktex/Core/Test>
+
+#include <cstdlib>
+#include <string>
+
+#include <miktex/fontcache.h>
+
+using namespace MiKTeX::Test;
+using namespace std;
+
+BEGIN_TEST_SCRIPT("fontcache-1-1");
+
+// stores and reads back the same entry over and over; usage:
+// fontcache_test1-1 PROGRAM FONTFILE
+BEGIN_TEST_FUNCTION(1);
+{
+  const char* program = vecArgs[0].c_str();
+  FILE* fontFile = fopen(vecArgs[1].c_str(), "rb");
+  TEST(fontFile != nullptr);
+  const string expected(4 * 1024 * 1024, 'x');
+  const string key = "subset";
+  for (int i = 0; i < 20; ++i)
+  {
+    miktex_font_cache_put(program, fontFile, key.c_str(), key.length(), expected.c_str(), expected.length());
+    size_t size;
+    void* data = miktex_font_cache_get(program, fontFile, key.c_str(), key.length(), &size);
+    // the other process may be replacing the entry right now, but
+    // whatever is read must be complete
+    if (data != nullptr)
+    {
+      bool complete = size == expected.length() && string(static_cast<const char*>(data), size) == expected;
+      free(data);
+      TEST(complete);
+    }
+  }
+  fclose(fontFile);
+}
+END_TEST_FUNCTION();
+
+BEGIN_TEST_PROGRAM();
+{
+  CALL_TEST_FUNCTION(1);
+}
+END_TEST_PROGRAM();
+
+END_TEST_SCRIPT();
+
+RUN_TEST_SCRIPT();
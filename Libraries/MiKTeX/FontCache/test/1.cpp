@@ -0,0 +1,235 @@
+/* 1.cpp:
+
+   Copyright (C) 2026 agent
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published
+   by the Free Software Foundation; either version 2, or (at your
+   option) any later version.
+
+   This file is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this file; if not, write to the Free Software
+   Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+   USA.  */
+
+#include "config.h"
+
+#include <miktex/Core/Test>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <miktex/Core/Directory>
+#include <miktex/Core/DirectoryLister>
+#include <miktex/Core/File>
+#include <miktex/Core/PathName>
+#include <miktex/Core/Paths>
+#include <miktex/Core/Process>
+#include <miktex/Core/Utils>
+
+#include <miktex/fontcache.h>
+
+using namespace MiKTeX::Core;
+using namespace MiKTeX::Test;
+using namespace std;
+
+BEGIN_TEST_SCRIPT("fontcache-1");
+
+void WriteFont(const char* fileName, const string& contents)
+{
+  FILE* file = fopen(fileName, "wb");
+  if (file == nullptr)
+  {
+    FATAL();
+  }
+  fwrite(contents.c_str(), 1, contents.length(), file);
+  fclose(file);
+}
+
+bool Get(const char* program, const char* fontFileName, const string& key, string& data)
+{
+  FILE* fontFile = fopen(fontFileName, "rb");
+  if (fontFile == nullptr)
+  {
+    FATAL();
+  }
+  fseek(fontFile, 3, SEEK_SET);
+  size_t size;
+  void* p = miktex_font_cache_get(program, fontFile, key.c_str(), key.length(), &size);
+  // the file position is preserved
+  bool positionKept = ftell(fontFile) == 3;
+  fclose(fontFile);
+  if (!positionKept)
+  {
+    FATAL();
+  }
+  if (p == nullptr)
+  {
+    return false;
+  }
+  data.assign(static_cast<const char*>(p), size);
+  free(p);
+  return true;
+}
+
+void Put(const char* program, const char* fontFileName, const string& key, const string& data)
+{
+  FILE* fontFile = fopen(fontFileName, "rb");
+  if (fontFile == nullptr)
+  {
+    FATAL();
+  }
+  miktex_font_cache_put(program, fontFile, key.c_str(), key.length(), data.c_str(), data.length());
+  fclose(fontFile);
+}
+
+PathName GetCacheDirectory(const char* program)
+{
+  PathName directory = pSession->GetSpecialPath(SpecialPath::DataRoot);
+  directory /= MIKTEX_PATH_MIKTEX_CACHE_DIR;
+  directory /= "fonts";
+  directory /= program;
+  return directory;
+}
+
+void ClearCache(const char* program)
+{
+  if (Directory::Exists(GetCacheDirectory(program)))
+  {
+    Directory::Delete(GetCacheDirectory(program), true);
+  }
+}
+
+// hit and miss
+BEGIN_TEST_FUNCTION(1);
+{
+  const char* program = "fontcachetest";
+  ClearCache(program);
+  ClearCache("fontcachetest2");
+  TEST(!miktex_font_cache_enabled(program));
+  Utils::SetEnvironmentString("MIKTEX_FONTCACHETEST_FONTCACHESIZE", "1");
+  Utils::SetEnvironmentString("MIKTEX_FONTCACHETEST2_FONTCACHESIZE", "1");
+  TEST(miktex_font_cache_enabled(program));
+  WriteFont("1.pfb", "font 1");
+  string data;
+  TEST(!Get(program, "1.pfb", "subset a", data));
+  Put(program, "1.pfb", "subset a", "data a");
+  TEST(Get(program, "1.pfb", "subset a", data));
+  TEST(data == "data a");
+  TEST(!Get(program, "1.pfb", "subset b", data));
+  TEST(!Get("fontcachetest2", "1.pfb", "subset a", data));
+  // same contents, other file
+  WriteFont("2.pfb", "font 1");
+  TEST(Get(program, "2.pfb", "subset a", data));
+  TEST(data == "data a");
+  // the digest of a changed font file is not reused
+  WriteFont("1.pfb", "font 1, revised");
+  TEST(!Get(program, "1.pfb", "subset a", data));
+  // a corrupted entry is a miss
+  WriteFont("3.pfb", "font 3");
+  Put(program, "3.pfb", "subset a", "data 3");
+  unique_ptr<DirectoryLister> lister = DirectoryLister::Open(GetCacheDirectory(program));
+  DirectoryEntry entry;
+  while (lister->GetNext(entry))
+  {
+    PathName path = GetCacheDirectory(program) / PathName(entry.name);
+    vector<unsigned char> bytes = File::ReadAllBytes(path);
+    bytes.back() ^= 1;
+    File::WriteBytes(path, bytes);
+  }
+  lister->Close();
+  TEST(!Get(program, "3.pfb", "subset a", data));
+  TEST(!Get(program, "2.pfb", "subset a", data));
+}
+END_TEST_FUNCTION();
+
+// least recently used entries are evicted
+BEGIN_TEST_FUNCTION(2);
+{
+  const char* program = "fontcachelru";
+  ClearCache(program);
+  Utils::SetEnvironmentString("MIKTEX_FONTCACHELRU_FONTCACHESIZE", "1");
+  WriteFont("lru.pfb", "lru font");
+  // four entries do not fit into 1 MB; three do
+  string a(300000, 'a');
+  string b(300000, 'b');
+  string c(300000, 'c');
+  string d(300000, 'd');
+  string data;
+  Put(program, "lru.pfb", "a", a);
+  this_thread::sleep_for(chrono::milliseconds(1100));
+  Put(program, "lru.pfb", "b", b);
+  this_thread::sleep_for(chrono::milliseconds(1100));
+  Put(program, "lru.pfb", "c", c);
+  this_thread::sleep_for(chrono::milliseconds(1100));
+  TEST(Get(program, "lru.pfb", "a", data));
+  this_thread::sleep_for(chrono::milliseconds(1100));
+  Put(program, "lru.pfb", "d", d);
+  TEST(Get(program, "lru.pfb", "a", data));
+  TEST(data == a);
+  TEST(!Get(program, "lru.pfb", "b", data));
+  TEST(!Get(program, "lru.pfb", "c", data));
+  TEST(Get(program, "lru.pfb", "d", data));
+  TEST(data == d);
+}
+END_TEST_FUNCTION();
+
+// two processes store the same entry at the same time
+BEGIN_TEST_FUNCTION(3);
+{
+  const char* program = "fontcacheconcurrent";
+  ClearCache(program);
+  Utils::SetEnvironmentString("MIKTEX_FONTCACHECONCURRENT_FONTCACHESIZE", "64");
+  WriteFont("concurrent.pfb", "concurrent font");
+  PathName pathExe = pSession->GetMyLocation(false);
+  pathExe /= "fontcache_test1-1" MIKTEX_EXE_FILE_SUFFIX;
+  vector<unique_ptr<Process>> writers;
+  for (int i = 0; i < 2; ++i)
+  {
+    ProcessStartInfo startInfo(pathExe);
+    startInfo.Arguments = { pathExe.ToString(), program, "concurrent.pfb" };
+    writers.push_back(Process::Start(startInfo));
+  }
+  for (unique_ptr<Process>& writer : writers)
+  {
+    writer->WaitForExit();
+    TEST(writer->get_ExitCode() == 0);
+    writer->Close();
+  }
+  string data;
+  TEST(Get(program, "concurrent.pfb", "subset", data));
+  TEST(data == string(4 * 1024 * 1024, 'x'));
+  // no temporary files are left behind
+  unique_ptr<DirectoryLister> lister = DirectoryLister::Open(GetCacheDirectory(program));
+  DirectoryEntry entry;
+  int count = 0;
+  while (lister->GetNext(entry))
+  {
+    ++count;
+  }
+  lister->Close();
+  TEST(count == 1);
+}
+END_TEST_FUNCTION();
+
+BEGIN_TEST_PROGRAM();
+{
+  CALL_TEST_FUNCTION(1);
+  CALL_TEST_FUNCTION(2);
+  CALL_TEST_FUNCTION(3);
+}
+END_TEST_PROGRAM();
+
+END_TEST_SCRIPT();
+
+RUN_TEST_SCRIPT();
@@ -1064,6 +1064,8 @@ MIKTEXKPSCEEAPI(char*) miktex_kpathsea_find_file(kpathsea kpseInstance, const ch
 
 MIKTEXKPSCEEAPI(char**) miktex_kpathsea_find_file_generic(kpathsea kpseInstance, const char* fileName, kpse_file_format_type format, boolean mustExist, boolean all);
 
+MIKTEXKPSCEEAPI(char**) miktex_kpathsea_find_files(kpathsea kpseInstance, const char* const* fileNames, unsigned numFileNames, kpse_file_format_type format, int mustExist);
+
 MIKTEXKPSCEEAPI(char*) miktex_kpathsea_find_glyph(kpathsea kpseInstance, const char* fontName, unsigned dpi, kpse_file_format_type format, kpse_glyph_file_type* glyph_file);
 
 MIKTEXKPSCEEAPI(void) miktex_kpathsea_finish(kpathsea kpseInstance);
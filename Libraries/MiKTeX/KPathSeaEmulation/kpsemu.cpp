@@ -300,6 +300,38 @@ MIKTEXKPSCEEAPI(char**) miktex_kpathsea_find_file_generic(kpathsea kpseInstance,
   return stringList;
 }
 
+MIKTEXKPSCEEAPI(char**) miktex_kpathsea_find_files(kpathsea kpseInstance, const char* const* fileNames, unsigned numFileNames, kpse_file_format_type format, int mustExist)
+{
+  MIKTEX_ASSERT(kpseInstance != nullptr);
+  MIKTEX_ASSERT(fileNames != nullptr || numFileNames == 0);
+  vector<string> names(fileNames, fileNames + numFileNames);
+  vector<PathName> result;
+  FileType fileType = ToFileType(format);
+  Session::FindFileOptionSet options;
+  if (mustExist)
+  {
+    options += Session::FindFileOption::Create;
+    options += Session::FindFileOption::SearchFileSystem;
+  }
+  shared_ptr<Session> session = Session::Get();
+  session->FindFiles(names, fileType, options, result);
+  char** stringList = XTALLOC(numFileNames + 1, char*);
+  for (unsigned idx = 0; idx < numFileNames; ++idx)
+  {
+    if (result[idx].Empty())
+    {
+      stringList[idx] = nullptr;
+    }
+    else
+    {
+      result[idx].ConvertToUnix();
+      stringList[idx] = xstrdup(result[idx].GetData());
+    }
+  }
+  stringList[numFileNames] = nullptr;
+  return stringList;
+}
+
 MIKTEXSTATICFUNC(bool) IsBinary(kpse_file_format_type format)
 {
   switch (format)
@@ -52,6 +52,11 @@ string engine = NULL;
 /* Interactively ask for names to look up?  (-interactive) */
 boolean interactive = false;
 
+#if defined(MIKTEX)
+/* Read the names to look up from standard input?  (-stdin) */
+boolean names_from_stdin = false;
+#endif
+
 /* The device name, for $MAKETEX_MODE.  (-mode) */
 string mode = NULL;
 
@@ -470,6 +475,91 @@ lookup (kpathsea kpse, string name)
 
   return ret == NULL;
 }
+
+#if defined(MIKTEX)
+/* Look up the COUNT filenames in NAMES and print the first match of
+   each, in the given order.  Names of the same format are resolved
+   with one call, which walks the search path only once.  Fall back to
+   `lookup' for everything else (-path, -all, -subdir, glyph formats).
+   Return the number of failures.  */
+
+static unsigned
+lookup_names (kpathsea kpse, string *names, unsigned count)
+{
+  unsigned unfound = 0;
+  unsigned i, j, n;
+  kpse_file_format_type *formats;
+  boolean *batched;
+  string *found;
+  const_string *group;
+  unsigned *group_idx;
+
+  /* The batch search returns only the first match of each name, so
+     it cannot honor -subdir, which filters all matches.  */
+  if (user_path || show_all || !STR_LIST_EMPTY (subdir_paths)) {
+    for (i = 0; i < count; i++)
+      unfound += lookup (kpse, names[i]);
+    return unfound;
+  }
+
+  formats = XTALLOC (count + 1, kpse_file_format_type);
+  batched = XTALLOC (count + 1, boolean);
+  found = XTALLOC (count + 1, string);
+  group = XTALLOC (count + 1, const_string);
+  group_idx = XTALLOC (count + 1, unsigned);
+
+  for (i = 0; i < count; i++) {
+    formats[i] = find_format (kpse, names[i], true);
+    /* If the suffix isn't recognized, assume it's a tex file. */
+    if (formats[i] == kpse_last_format)
+      formats[i] = kpse_tex_format;
+    batched[i] = formats[i] != kpse_pk_format
+      && formats[i] != kpse_gf_format
+      && formats[i] != kpse_any_glyph_format;
+    found[i] = NULL;
+  }
+
+  /* Group the names by format.  */
+  for (i = 0; i < count; i++) {
+    kpse_file_format_type fmt = formats[i];
+    string *ret_list;
+    if (!batched[i] || fmt == kpse_last_format)
+      continue;
+    for (n = 0, j = i; j < count; j++) {
+      if (batched[j] && formats[j] == fmt) {
+        group[n] = names[j];
+        group_idx[n++] = j;
+        /* Don't look at this one again.  */
+        formats[j] = kpse_last_format;
+      }
+    }
+    ret_list = miktex_kpathsea_find_files (kpse, group, n, fmt, must_exist);
+    for (j = 0; j < n; j++)
+      found[group_idx[j]] = ret_list[j];
+    free (ret_list);
+  }
+
+  /* Print output.  */
+  for (i = 0; i < count; i++) {
+    if (!batched[i]) {
+      unfound += lookup (kpse, names[i]);
+    } else if (found[i]) {
+      puts (found[i]);
+      free (found[i]);
+    } else {
+      unfound++;
+    }
+  }
+
+  free (group_idx);
+  free (group);
+  free (found);
+  free (batched);
+  free (formats);
+
+  return unfound;
+}
+#endif
 
 /* Help message.  */
 
@@ -503,6 +593,8 @@ to also use -engine, or nothing will be returned; in particular,\n\
 -safe-out-name=STRING  check if STRING is ok to open for output.\n\
 -show-path=TYPE        output search path for file type TYPE\n\
                          (list shown by -help-formats).\n\
+-stdin                 read filenames to look up from standard input,\n\
+                         one per line.\n\
 -subdir=STRING         only output matches whose directory ends with STRING.\n\
 -var-brace-value=STRING output brace-expanded value of variable $STRING.\n\
 -var-value=STRING       output variable-expanded value of variable $STRING.\n\
@@ -633,6 +725,9 @@ static struct option long_options[]
       { "safe-out-name",        1, 0, 0 },
       { "subdir",               1, 0, 0 },
       { "show-path",            1, 0, 0 },
+#if defined(MIKTEX)
+      { "stdin",                0, (int *) &names_from_stdin, 1 },
+#endif
       { "var-brace-value",      1, 0, 0 },
       { "var-value",            1, 0, 0 },
       { "version",              0, 0, 0 },
@@ -915,9 +1010,37 @@ main (int argc,  string *argv)
   }
 
   /* Usual case: look up each given filename.  */
+#if defined(MIKTEX)
+  unfound += lookup_names (kpse, argv + optind, argc - optind);
+  optind = argc;
+
+  /* Many filenames: read them from standard input.  */
+  if (names_from_stdin) {
+    unsigned count = 0;
+    unsigned capacity = 256;
+    string *names = XTALLOC (capacity, string);
+    string name;
+    while ((name = read_line (stdin)) != NULL) {
+      if (*name == 0) {
+        free (name);
+        continue;
+      }
+      if (count == capacity) {
+        capacity *= 2;
+        XRETALLOC (names, capacity, string);
+      }
+      names[count++] = name;
+    }
+    unfound += lookup_names (kpse, names, count);
+    while (count > 0)
+      free (names[--count]);
+    free (names);
+  }
+#else
   for (; optind < argc; optind++) {
     unfound += lookup (kpse, argv[optind]);
   }
+#endif
 
   if (interactive) {
     for (;;) {
@@ -0,0 +1,67 @@
+## subdir.cmake: check that kpsewhich honors -subdir  -*- CMake -*-
+##
+## Copyright (C) 2026 agent
+## 
+## This file is free software; you can redistribute it and/or modify
+## it under the terms of the GNU General Public License as published
+## by the Free Software Foundation; either version 2, or (at your
+## option) any later version.
+## 
+## This file is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+## General Public License for more details.
+## 
+## You should have received a copy of the GNU General Public License
+## along with this file; if not, write to the Free Software
+## Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+## USA.
+
+## Sets up a private TEXMF root with two files of the same name and
+## looks one of them up by subdirectory, both from the command line
+## and from standard input.
+
+cmake_minimum_required(VERSION 3.12)
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR}/config ${WORK_DIR}/data ${WORK_DIR}/install)
+file(WRITE ${WORK_DIR}/root/tex/latex/a/sample.sty "% a\n")
+file(WRITE ${WORK_DIR}/root/tex/latex/b/sample.sty "% b\n")
+file(WRITE ${WORK_DIR}/names.txt "sample.sty\n")
+
+set(ENV{MIKTEX_USERCONFIG} ${WORK_DIR}/config)
+set(ENV{MIKTEX_USERDATA} ${WORK_DIR}/data)
+set(ENV{MIKTEX_USERINSTALL} ${WORK_DIR}/install)
+set(ENV{MIKTEX_USERROOTS} ${WORK_DIR}/root)
+
+function(check_lookup subdir expected)
+  foreach(mode args stdin)
+    if(mode STREQUAL "args")
+      execute_process(
+        COMMAND ${KPSEWHICH} -subdir=${subdir} sample.sty
+        OUTPUT_VARIABLE output
+        OUTPUT_STRIP_TRAILING_WHITESPACE
+        RESULT_VARIABLE exit_code
+      )
+    else()
+      execute_process(
+        COMMAND ${KPSEWHICH} -stdin -subdir=${subdir}
+        INPUT_FILE ${WORK_DIR}/names.txt
+        OUTPUT_VARIABLE output
+        OUTPUT_STRIP_TRAILING_WHITESPACE
+        RESULT_VARIABLE exit_code
+      )
+    endif()
+    if(expected STREQUAL "")
+      if(exit_code EQUAL 0 OR NOT output STREQUAL "")
+        message(FATAL_ERROR "${mode}: -subdir=${subdir} should not match, got: ${output}")
+      endif()
+    elseif(NOT exit_code EQUAL 0 OR NOT output MATCHES "${expected}$")
+      message(FATAL_ERROR "${mode}: -subdir=${subdir} should match ${expected}, got: ${output}")
+    endif()
+  endforeach()
+endfunction()
+
+check_lookup(latex/a "latex/a/sample.sty")
+check_lookup(latex/b "latex/b/sample.sty")
+check_lookup(latex/c "")
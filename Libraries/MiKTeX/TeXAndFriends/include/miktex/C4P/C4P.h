@@ -728,6 +728,17 @@ template<int handle> inline void c4p_proc_exit()
 #define C4P_PROC_ENTRY(handle) c4p_proc_entry<handle>();
 #define C4P_PROC_EXIT(handle) C4P_LABEL_PROC_EXIT: c4p_proc_exit<handle>();
 
+// hints emitted by c4p --optimize
+#if defined(__GNUC__)
+#  define C4P_HOT __attribute__((hot))
+#  define C4P_COLD __attribute__((cold))
+#  define C4P_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#  define C4P_HOT
+#  define C4P_COLD
+#  define C4P_UNLIKELY(x) (x)
+#endif
+
 C4PCEEAPI(void) SetStartUpTime(time_t time, bool useUtc);
 
 C4PCEEAPI(time_t) GetStartUpTime();
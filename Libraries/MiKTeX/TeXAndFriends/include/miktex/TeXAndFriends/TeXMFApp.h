@@ -173,6 +173,11 @@ public:
   virtual void OnTeXMFInitialize() const
   {
     signal(SIGINT, OnKeybordInterrupt);
+    if (IsInitProgram())
+    {
+      // there is no format to be loaded
+      ProfilePhase("typeset");
+    }
   }
 
 public:
@@ -343,6 +348,9 @@ public:
 private:
   MIKTEXMFTHISAPI(void) CheckFirstLine(const MiKTeX::Core::PathName& fileName);
 
+private:
+  MIKTEXMFTHISAPI(void) WriteMemoryReport();
+
 public:
   static MIKTEXMFCEEAPI(void) OnKeybordInterrupt(int);
 
@@ -370,6 +378,15 @@ public:
 public:
   MIKTEXMFTHISAPI(ITeXMFMemoryHandler*) GetTeXMFMemoryHandler() const;
 
+public:
+  MIKTEXMFTHISAPI(bool) IsMemoryReportEnabled() const;
+
+public:
+  MIKTEXMFTHISAPI(void) OnArrayReallocated(const std::string& arrayName, std::size_t oldSize, std::size_t newSize);
+
+public:
+  MIKTEXMFTHISAPI(void) OnArrayFreed(const std::string& arrayName, std::size_t size, std::size_t peakUsed, std::size_t touchedSize, std::size_t reservedSize);
+
 private:
   class impl;
   std::unique_ptr<impl> pimpl;
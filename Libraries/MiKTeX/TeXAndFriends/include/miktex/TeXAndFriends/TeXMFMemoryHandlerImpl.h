@@ -22,6 +22,17 @@
 #if !defined(FEFFF218B53147ED8CDE64F68A13D234)
 #define FEFFF218B53147ED8CDE64F68A13D234
 
+#if defined(MIKTEX_UNIX)
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include <miktex/Core/ConfigNames>
 
 #include <miktex/TeXAndFriends/config.h>
@@ -57,6 +68,28 @@ protected:
 protected:
   std::unique_ptr<MiKTeX::Trace::TraceStream> trace_mem;
 
+protected:
+  struct ArrayInfo
+  {
+    std::string name;
+    std::size_t size = 0;
+    // high-water mark as tracked by the engine; 0, if unknown
+    std::size_t peakUsed = 0;
+    // non-zero, if the array lives in a reserved address range
+    std::size_t reserved = 0;
+  };
+
+protected:
+  std::unordered_map<void*, ArrayInfo> arrays;
+
+protected:
+  // bytes of address space to reserve for large arrays; 0 means: use the heap
+  std::size_t reserveSize = 0;
+
+protected:
+  // arrays smaller than this always live on the heap
+  static constexpr std::size_t MAP_THRESHOLD = 1024 * 1024;
+
 protected:
   int GetConfigValue(const std::string& valueName, int defaultValue) const
   {
@@ -171,6 +204,10 @@ public:
 
     program.maxstrings += 0x100;
 
+#if defined(MIKTEX_UNIX) && defined(MAP_NORESERVE)
+    reserveSize = static_cast<std::size_t>(GetConfigValue("reserve_address_space", texmfapp::texmfapp::reserve_address_space())) * 1024 * 1024;
+#endif
+
 #if defined(HAVE_EXTRA_MEM_BOT)
     if (texmfapp.IsInitProgram())
     {
@@ -230,9 +267,38 @@ public:
 #endif
   }
 
+protected:
+  template<typename T> void SetPeakUsed(T* ptr, std::size_t numElem)
+  {
+    auto it = arrays.find(ptr);
+    if (it != arrays.end())
+    {
+      it->second.peakUsed = std::min(numElem * sizeof(*ptr), it->second.size);
+    }
+  }
+
 public:
   void Free() override
   {
+    if (texmfapp.IsMemoryReportEnabled())
+    {
+      SetPeakUsed(program.buffer, program.maxbufstack + 1);
+      SetPeakUsed(program.inputstack, program.maxinstack + 1);
+      SetPeakUsed(program.paramstack, program.maxparamstack);
+#if defined(MIKTEX_TEX_COMPILER)
+      // mem[mem_min..lo_mem_max] and mem[hi_mem_min..mem_end]
+      SetPeakUsed(program.yzmem, (program.lomemmax - program.memmin + 1) + (program.memend - program.himemmin + 1));
+#  if !defined(MIKTEX_OMEGA)
+      // max_pool_ptr and max_str_ptr are not touched by loading a format
+      SetPeakUsed(program.strpool, std::max(program.maxpoolptr, program.poolptr));
+      SetPeakUsed(program.strstart, std::max(program.maxstrptr, program.strptr) + 1);
+#  endif
+#elif defined(MIKTEX_META_COMPILER)
+      SetPeakUsed(program.mem, (program.lomemmax + 1) + (program.memend - program.himemmin + 1));
+      SetPeakUsed(program.strpool, program.maxpoolptr);
+      SetPeakUsed(program.strstart, program.maxstrptr + 1);
+#endif
+    }
     FreeArray("buffer", program.buffer);
     FreeArray("inputstack", program.inputstack);
     FreeArray("paramstack", program.paramstack);
@@ -248,21 +314,168 @@ public:
 #endif
   }
 
+protected:
+  bool IsMapped(void* ptr) const
+  {
+    auto it = arrays.find(ptr);
+    return it != arrays.end() && it->second.reserved > 0;
+  }
+
 public:
   void Check() override
   {
-    MIKTEX_ASSERT_VALID_HEAP_POINTER_OR_NIL(program.buffer);
+#define CHECK_ARRAY(p) if (!IsMapped(p)) { MIKTEX_ASSERT_VALID_HEAP_POINTER_OR_NIL(p); }
+    CHECK_ARRAY(program.buffer);
 #if defined(MIKTEX_TEX_COMPILER)
-    MIKTEX_ASSERT_VALID_HEAP_POINTER_OR_NIL(program.yzmem);
+    CHECK_ARRAY(program.yzmem);
 #else
-    MIKTEX_ASSERT_VALID_HEAP_POINTER_OR_NIL(program.mem);
+    CHECK_ARRAY(program.mem);
 #endif
-    MIKTEX_ASSERT_VALID_HEAP_POINTER_OR_NIL(program.paramstack);
-    MIKTEX_ASSERT_VALID_HEAP_POINTER_OR_NIL(program.strpool);
-    MIKTEX_ASSERT_VALID_HEAP_POINTER_OR_NIL(program.trickbuf);
+    CHECK_ARRAY(program.paramstack);
+    CHECK_ARRAY(program.strpool);
+    CHECK_ARRAY(program.trickbuf);
 #if !defined(MIKTEX_OMEGA)
-    MIKTEX_ASSERT_VALID_HEAP_POINTER_OR_NIL(program.strstart);
+    CHECK_ARRAY(program.strstart);
+#endif
+#undef CHECK_ARRAY
+  }
+
+#if defined(MIKTEX_UNIX) && defined(MAP_NORESERVE)
+protected:
+  static std::size_t RoundUp(std::size_t n, std::size_t alignment)
+  {
+    return (n + alignment - 1) / alignment * alignment;
+  }
+
+protected:
+  // reserve address space without committing memory; pages are
+  // backed lazily on first touch
+  void* MapRange(std::size_t size)
+  {
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED)
+    {
+      return nullptr;
+    }
+#if defined(MADV_HUGEPAGE)
+    madvise(p, size, MADV_HUGEPAGE);
+#endif
+    return p;
+  }
+
+protected:
+  // returns MAP_FAILED, if the array should live on the heap
+  void* ReallocateMapped(void* ptr, std::size_t amount, const ArrayInfo& info, std::size_t& reserved)
+  {
+    const std::size_t hugePageSize = 2 * 1024 * 1024;
+    if (info.reserved > 0 && amount == 0)
+    {
+      munmap(ptr, info.reserved);
+      reserved = 0;
+      return nullptr;
+    }
+    if (info.reserved > 0 && amount <= info.reserved)
+    {
+      // the common case: grow (or shrink) in place
+      reserved = info.reserved;
+      return ptr;
+    }
+    if (info.reserved == 0 && (amount < MAP_THRESHOLD || reserveSize == 0))
+    {
+      return MAP_FAILED;
+    }
+    std::size_t newReserved = RoundUp(std::max(amount * 2, reserveSize), hugePageSize);
+    void* newPtr;
+    if (info.reserved > 0)
+    {
+#if defined(MREMAP_MAYMOVE)
+      // move the page tables, not the contents
+      newPtr = mremap(ptr, info.reserved, newReserved, MREMAP_MAYMOVE);
+      if (newPtr == MAP_FAILED)
+      {
+        return MAP_FAILED;
+      }
+#if defined(MADV_HUGEPAGE)
+      madvise(newPtr, newReserved, MADV_HUGEPAGE);
+#endif
+#else
+      newPtr = MapRange(newReserved);
+      if (newPtr == nullptr)
+      {
+        return MAP_FAILED;
+      }
+      memcpy(newPtr, ptr, info.size);
+      munmap(ptr, info.reserved);
+#endif
+    }
+    else
+    {
+      newPtr = MapRange(newReserved);
+      if (newPtr == nullptr)
+      {
+        return MAP_FAILED;
+      }
+      if (ptr != nullptr)
+      {
+        // migrate a heap array which has outgrown the threshold
+        memcpy(newPtr, ptr, std::min(info.size, amount));
+        MiKTeX::Debug::Free(ptr, MIKTEX_SOURCE_LOCATION_DEBUG());
+      }
+    }
+    reserved = newReserved;
+    return newPtr;
+  }
+
+protected:
+  // number of bytes which have actually been touched
+  static std::size_t GetResidentSize(void* ptr, std::size_t size)
+  {
+    const std::size_t pageSize = sysconf(_SC_PAGESIZE);
+    std::size_t numPages = RoundUp(size, pageSize) / pageSize;
+#if defined(__APPLE__)
+    std::vector<char> vec(numPages);
+#else
+    std::vector<unsigned char> vec(numPages);
+#endif
+    if (numPages == 0 || mincore(ptr, size, vec.data()) != 0)
+    {
+      return size;
+    }
+    std::size_t resident = 0;
+    for (auto v : vec)
+    {
+      if ((v & 1) != 0)
+      {
+        resident += pageSize;
+      }
+    }
+    return std::min(resident, size);
+  }
+#endif
+
+protected:
+  void ReportArray(const ArrayInfo& info, void* ptr)
+  {
+    std::string message = "array " + info.name + ": size " + std::to_string(info.size) + " bytes";
+    if (info.peakUsed > 0)
+    {
+      message += ", peak used " + std::to_string(info.peakUsed) + " bytes";
+    }
+    // 0: not measured (heap arrays)
+    std::size_t touchedSize = 0;
+#if defined(MIKTEX_UNIX) && defined(MAP_NORESERVE)
+    if (info.reserved > 0)
+    {
+      touchedSize = GetResidentSize(ptr, info.size);
+      message += ", touched " + std::to_string(touchedSize) + " bytes, reserved " + std::to_string(info.reserved) + " bytes";
+    }
 #endif
+    texmfapp.OnArrayFreed(info.name, info.size, info.peakUsed, touchedSize, info.reserved);
+    texmfapp.LogInfo(message);
+    if (trace_mem->IsEnabled("libtexmf", MiKTeX::Trace::TraceLevel::Info))
+    {
+      trace_mem->WriteLine("libtexmf", MiKTeX::Trace::TraceLevel::Info, message);
+    }
   }
 
 public:
@@ -282,12 +495,51 @@ public:
     {
       // TODO: trace_mem->WriteLine("libtexmf", fmt::format(MIKTEXTEXT("Reallocate {0}: p == {1}, elementSize == {2}, nElements == {3}, bytes == {4}"), arrayName.empty() ? "array"s : arrayName, ptr, elemSize, numElem, amount));
     }
-    ptr = MiKTeX::Debug::Realloc(ptr, amount, sourceLocation);
+    ArrayInfo info;
+    auto it = arrays.find(ptr);
+    if (it != arrays.end())
+    {
+      info = it->second;
+      arrays.erase(it);
+    }
+    else
+    {
+      info.name = arrayName;
+    }
+    if (amount == 0 && ptr != nullptr)
+    {
+      ReportArray(info, ptr);
+    }
+    void* newPtr = nullptr;
+    bool mapped = false;
+#if defined(MIKTEX_UNIX) && defined(MAP_NORESERVE)
+    std::size_t reserved = 0;
+    newPtr = ReallocateMapped(ptr, amount, info, reserved);
+    mapped = newPtr != MAP_FAILED;
+    if (!mapped && info.reserved > 0)
+    {
+      MIKTEX_FATAL_ERROR_2(MIKTEXTEXT("The array could not be enlarged."), "arrayName", info.name, "bytes", std::to_string(amount));
+    }
+    info.reserved = reserved;
+#endif
+    if (!mapped)
+    {
+      newPtr = MiKTeX::Debug::Realloc(ptr, amount, sourceLocation);
+    }
+    if (newPtr != nullptr && amount > 0)
+    {
+      if (amount != info.size)
+      {
+        texmfapp.OnArrayReallocated(info.name, info.size, amount);
+      }
+      info.size = amount;
+      arrays[newPtr] = info;
+    }
     if (trace_mem->IsEnabled("libtexmf", MiKTeX::Trace::TraceLevel::Trace))
     {
       // TODO: trace_mem->WriteLine("libtexmf", fmt::format(MIKTEXTEXT("Reallocate: return {0}"), ptr));
     }
-    return ptr;
+    return newPtr;
   }
 };
 
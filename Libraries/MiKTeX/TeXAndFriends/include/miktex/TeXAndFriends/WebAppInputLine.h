@@ -132,6 +132,7 @@ public:
   {
     f.AssertValid();
     TouchJobOutputFile(f);
+    ProfileFileClosed(f);
     GetSession()->CloseFile(f);
   }
 
@@ -211,6 +212,21 @@ public:
 public:
   MIKTEXMFTHISAPI(IInputOutput*) GetInputOutput() const;
 
+public:
+  MIKTEXMFTHISAPI(bool) IsProfiling() const;
+
+public:
+  MIKTEXMFTHISAPI(void) ProfilePhase(const std::string& phase) const;
+
+public:
+  MIKTEXMFTHISAPI(void) ProfileFileOpened(FILE* file, const MiKTeX::Core::PathName& fileName, const std::string& category) const;
+
+public:
+  MIKTEXMFTHISAPI(void) ProfileFileClosed(FILE* file) const;
+
+private:
+  MIKTEXMFTHISAPI(void) WriteProfile();
+
 private:
   class impl;
   std::unique_ptr<impl> pimpl;
@@ -19,7 +19,12 @@
    Software Foundation, 59 Temple Place - Suite 330, Boston, MA
    02111-1307, USA. */
 
+#include <chrono>
+
+#include <fmt/format.h>
+
 #include <miktex/Core/ConfigNames>
+#include <miktex/Core/StreamWriter>
 
 #include "internal.h"
 
@@ -93,8 +98,67 @@ int CheckBom(FILE* file)
   return 0;
 }
 
+// Line readers are specialized per engine; the one for the running
+// engine is selected once, in Init().
+struct EightBitLines
+{
+  typedef char CharType;
+  static constexpr bool trackMaxBufStack = true;
+  static char* Buffer(IInputOutput* inputOutput)
+  {
+    return inputOutput->buffer();
+  }
+  static const char* Xord(const WebApp& app)
+  {
+    return app.GetCharacterConverter()->xord();
+  }
+  static char Translate(const char* xord, int ch)
+  {
+    return xord[ch & 0xff];
+  }
+};
+
+struct BibTeXLines :
+  public EightBitLines
+{
+  static constexpr bool trackMaxBufStack = false;
+};
+
+#if defined(WITH_OMEGA)
+struct OmegaLines
+{
+  typedef char16_t CharType;
+  static constexpr bool trackMaxBufStack = true;
+  static char16_t* Buffer(IInputOutput* inputOutput)
+  {
+    return inputOutput->buffer16();
+  }
+  static const char* Xord(const WebApp& app)
+  {
+    return nullptr;
+  }
+  static char16_t Translate(const char* xord, int ch)
+  {
+    return static_cast<char16_t>(ch);
+  }
+};
+#endif
+
 class WebAppInputLine::impl
 {
+public:
+  bool isOmega = false;
+public:
+  bool isXeTeX = false;
+public:
+  bool (*inputLine)(const WebAppInputLine& app, FILE* file) = nullptr;
+public:
+  template<class Traits> static bool InputLine(const WebAppInputLine& app, FILE* file);
+public:
+  static bool UnexpectedInputLine(const WebAppInputLine& app, FILE* file)
+  {
+    MIKTEX_UNEXPECTED();
+  }
 public:
   PathName outputDirectory;
 public:
@@ -117,6 +181,44 @@ public:
   TriState allowInput = TriState::Undetermined;
 public:
   TriState allowOutput = TriState::Undetermined;
+public:
+  PathName profileFile;
+public:
+  chrono::steady_clock::time_point profileStart;
+public:
+  double Now() const
+  {
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - profileStart).count();
+  }
+public:
+  struct ProfileEvent
+  {
+    string name;
+    string category;
+    int track;
+    double start;
+    double end;
+    long long bytes;
+  };
+public:
+  vector<ProfileEvent> profileEvents;
+public:
+  unordered_map<FILE*, ProfileEvent> profiledFiles;
+public:
+  string phase;
+public:
+  double phaseStart;
+};
+
+enum {
+  OPT_PROFILE,
+};
+
+// Chrome trace tracks
+enum {
+  TRACK_PHASES = 1,
+  TRACK_INPUT = 2,
+  TRACK_OUTPUT = 3,
 };
 
 WebAppInputLine::WebAppInputLine() :
@@ -131,12 +233,41 @@ WebAppInputLine::~WebAppInputLine() noexcept
 void WebAppInputLine::Init(vector<char*>& args)
 {
   WebApp::Init(args);
+  pimpl->isOmega = AmI("omega");
+  pimpl->isXeTeX = AmI("xetex");
+  if (pimpl->isXeTeX)
+  {
+    pimpl->inputLine = &impl::UnexpectedInputLine;
+  }
+#if defined(WITH_OMEGA)
+  else if (pimpl->isOmega)
+  {
+    pimpl->inputLine = &impl::InputLine<OmegaLines>;
+  }
+#endif
+  else if (AmI("bibtex"))
+  {
+    pimpl->inputLine = &impl::InputLine<BibTeXLines>;
+  }
+  else
+  {
+    pimpl->inputLine = &impl::InputLine<EightBitLines>;
+  }
   pimpl->shellCommandMode = ShellCommandMode::Forbidden;
   pimpl->enablePipes = false;
+  pimpl->profileStart = chrono::steady_clock::now();
 }
 
 void WebAppInputLine::Finalize()
 {
+  if (IsProfiling())
+  {
+    WriteProfile();
+  }
+  pimpl->profileFile.Clear();
+  pimpl->profileEvents.clear();
+  pimpl->profiledFiles.clear();
+  pimpl->phase = "";
   pimpl->foundFile.Clear();
   pimpl->foundFileFq.Clear();
   pimpl->lastInputFileName.Clear();
@@ -149,11 +280,23 @@ void WebAppInputLine::AddOptions()
 {
   WebApp::AddOptions();
   pimpl->optBase = (int)GetOptions().size();
+  AddOption(T_("profile\0Write a Chrome trace of the time spent per input file and per processing phase to FILE."), FIRST_OPTION_VAL + pimpl->optBase + OPT_PROFILE, POPT_ARG_STRING, "FILE");
 }
 
 bool WebAppInputLine::ProcessOption(int opt, const string& optArg)
 {
-  return WebApp::ProcessOption(opt, optArg);
+  bool done = true;
+  switch (opt - FIRST_OPTION_VAL - pimpl->optBase)
+  {
+  case OPT_PROFILE:
+    pimpl->profileFile = optArg;
+    pimpl->profileFile.MakeAbsolute();
+    break;
+  default:
+    done = WebApp::ProcessOption(opt, optArg);
+    break;
+  }
+  return done;
 }
 
 #if defined(WITH_OMEGA)
@@ -335,7 +478,7 @@ bool WebAppInputLine::OpenOutputFile(C4P::FileRoot& f, const PathName& fileName,
   {
 #if defined(WITH_OMEGA)
     PathName unmangled;
-    if (AmI("omega"))
+    if (pimpl->isOmega)
     {
       unmangled = UnmangleNameOfFile(lpszPath);
       lpszPath = unmangled.GetData();
@@ -363,6 +506,7 @@ bool WebAppInputLine::OpenOutputFile(C4P::FileRoot& f, const PathName& fileName,
   {
     return false;
   }
+  ProfileFileOpened(file, PathName(lpszPath), "output");
   f.Attach(file, true);
   return true;
 }
@@ -430,7 +574,7 @@ bool WebAppInputLine::OpenInputFile(FILE** ppFile, const PathName& fileName)
   {
 #if defined(WITH_OMEGA)
     PathName unmangled;
-    if (AmI("omega"))
+    if (pimpl->isOmega)
     {
       unmangled = UnmangleNameOfFile(lpszFileName);
       lpszFileName = unmangled.GetData();
@@ -496,7 +640,7 @@ bool WebAppInputLine::OpenInputFile(FILE** ppFile, const PathName& fileName)
     return false;
   }
 
-  if (!AmI("xetex"))
+  if (!pimpl->isXeTeX)
   {
     auto openFileInfo = session->TryGetOpenFileInfo(*ppFile);
     if (openFileInfo.first && openFileInfo.second.mode != FileMode::Command)
@@ -519,6 +663,25 @@ bool WebAppInputLine::OpenInputFile(FILE** ppFile, const PathName& fileName)
 
   pimpl->lastInputFileName = lpszFileName;
 
+  if (IsProfiling())
+  {
+    string category = "input";
+    PathName path = pimpl->foundFileFq.Empty() ? PathName(lpszFileName) : pimpl->foundFileFq;
+    if (path.HasExtension(".sty"))
+    {
+      category = "package";
+    }
+    else if (path.HasExtension(".cls"))
+    {
+      category = "class";
+    }
+    else if (path.HasExtension(".fd") || path.HasExtension(".enc") || path.HasExtension(".map"))
+    {
+      category = "font";
+    }
+    ProfileFileOpened(*ppFile, path, category);
+  }
+
   return true;
 }
 
@@ -670,45 +833,16 @@ inline int GetCharacter(FILE* file)
   return ch;
 }
 
-bool WebAppInputLine::InputLine(C4P_text& f, C4P_boolean bypassEndOfLine) const
+template<class Traits> bool WebAppInputLine::impl::InputLine(const WebAppInputLine& app, FILE* f)
 {
-  f.AssertValid();
-
-  if (AmI("xetex"))
-  {
-    MIKTEX_UNEXPECTED();
-  }
-
-#if defined(PASCAL_TEXT_IO)
-  MIKTEX_UNEXPECTED();
-#endif
-
-  IInputOutput* inputOutput = GetInputOutput();
+  IInputOutput* inputOutput = app.GetInputOutput();
 
   const C4P_signed32 first = inputOutput->first();
   C4P_signed32& last = inputOutput->last();
   C4P_signed32 bufsize = inputOutput->bufsize();
 
-  const char* xord = nullptr;
-#if defined(WITH_OMEGA)
-  if (!AmI("omega"))
-#endif
-  {
-    xord = GetCharacterConverter()->xord();
-  }
-
-  char *buffer = nullptr;
-#if defined(WITH_OMEGA)
-  char16_t* buffer16 = nullptr;
-  if (AmI("omega"))
-  {
-    buffer16 = inputOutput->buffer16();
-  }
-  else
-#endif
-  {
-    buffer = inputOutput->buffer();
-  }
+  const char* xord = Traits::Xord(app);
+  typename Traits::CharType* buffer = Traits::Buffer(inputOutput);
 
   last = first;
 
@@ -741,28 +875,16 @@ bool WebAppInputLine::InputLine(C4P_text& f, C4P_boolean bypassEndOfLine) const
     return true;
   }
 
-#if defined(WITH_OMEGA)
-  if (AmI("omega"))
-  {
-    buffer16[last] = ch;
-  }
-  else
-#endif
-  {
-    buffer[last] = xord[ch & 0xff];
-  }
+  buffer[last] = Traits::Translate(xord, ch);
   last += 1;
 
   while ((ch = GetCharacter(f)) != EOF)
   {
     if (last >= bufsize)
     {
-      BufferSizeExceeded();
+      app.BufferSizeExceeded();
       bufsize = inputOutput->bufsize();
-#if defined(WITH_OMEGA)
-      if (!AmI("omega"))
-#endif
-      buffer = inputOutput->buffer();
+      buffer = Traits::Buffer(inputOutput);
     }
     if (ch == '\r')
     {
@@ -781,45 +903,123 @@ bool WebAppInputLine::InputLine(C4P_text& f, C4P_boolean bypassEndOfLine) const
     {
       break;
     }
-#if defined(WITH_OMEGA)
-    if (AmI("omega"))
-    {
-      buffer16[last] = ch;
-    }
-    else
-#endif
-    {
-      buffer[last] = xord[ch & 0xff];
-    }
+    buffer[last] = Traits::Translate(xord, ch);
     last += 1;
   }
 
-  if (!AmI("bibtex") && last >= inputOutput->maxbufstack())
+  if (Traits::trackMaxBufStack && last >= inputOutput->maxbufstack())
   {
     inputOutput->maxbufstack() = last + 1;
     if (inputOutput->maxbufstack() >= bufsize)
     {
-      BufferSizeExceeded();
+      app.BufferSizeExceeded();
       bufsize = inputOutput->bufsize();
     }
   }
 
-#if defined(WITH_OMEGA)
-  if (AmI("omega"))
+  while (last > first && (buffer[last - 1] == ' ' || buffer[last - 1] == '\r'))
   {
-    while (last > first && (buffer16[last - 1] == u' ' || buffer16[last - 1] == u'\r'))
-    {
-      last -= 1;
-    }
+    last -= 1;
   }
-  else
+
+  return true;
+}
+
+bool WebAppInputLine::InputLine(C4P_text& f, C4P_boolean bypassEndOfLine) const
+{
+  f.AssertValid();
+
+#if defined(PASCAL_TEXT_IO)
+  MIKTEX_UNEXPECTED();
 #endif
+
+  MIKTEX_ASSERT(pimpl->inputLine != nullptr);
+  return pimpl->inputLine(*this, f);
+}
+
+bool WebAppInputLine::IsProfiling() const
+{
+  return !pimpl->profileFile.Empty();
+}
+
+void WebAppInputLine::ProfilePhase(const string& phase) const
+{
+  if (!IsProfiling())
   {
-    while (last > first && (buffer[last - 1] == ' ' || buffer[last - 1] == '\r'))
-    {
-      last -= 1;
-    }
+    return;
   }
+  double now = pimpl->Now();
+  if (!pimpl->phase.empty())
+  {
+    pimpl->profileEvents.push_back({ pimpl->phase, "phase", TRACK_PHASES, pimpl->phaseStart, now, -1 });
+  }
+  pimpl->phase = phase;
+  pimpl->phaseStart = now;
+}
 
-  return true;
+void WebAppInputLine::ProfileFileOpened(FILE* file, const PathName& fileName, const string& category) const
+{
+  if (!IsProfiling() || file == nullptr)
+  {
+    return;
+  }
+  if (category == "format")
+  {
+    ProfilePhase("format");
+  }
+  pimpl->profiledFiles[file] = { fileName.ToString(), category, category == "output" ? TRACK_OUTPUT : TRACK_INPUT, pimpl->Now(), 0, -1 };
+}
+
+void WebAppInputLine::ProfileFileClosed(FILE* file) const
+{
+  if (!IsProfiling())
+  {
+    return;
+  }
+  auto it = pimpl->profiledFiles.find(file);
+  if (it == pimpl->profiledFiles.end())
+  {
+    return;
+  }
+  impl::ProfileEvent event = it->second;
+  pimpl->profiledFiles.erase(it);
+  event.end = pimpl->Now();
+  // fails (-1) for pipes
+  event.bytes = ftell(file);
+  pimpl->profileEvents.push_back(event);
+  if (event.category == "format")
+  {
+    ProfilePhase("typeset");
+  }
+}
+
+void WebAppInputLine::WriteProfile()
+{
+  ProfilePhase("");
+  double now = pimpl->Now();
+  for (const auto& p : pimpl->profiledFiles)
+  {
+    impl::ProfileEvent event = p.second;
+    event.end = now;
+    pimpl->profileEvents.push_back(event);
+  }
+  pimpl->profiledFiles.clear();
+  StreamWriter writer(pimpl->profileFile);
+  writer.WriteLine("{");
+  writer.WriteLine("  \"displayTimeUnit\": \"ms\",");
+  writer.WriteLine("  \"traceEvents\": [");
+  writer.WriteLine(fmt::format("    {{ \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": {0}, \"args\": {{ \"name\": \"phases\" }} }},", TRACK_PHASES));
+  writer.WriteLine(fmt::format("    {{ \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": {0}, \"args\": {{ \"name\": \"input files\" }} }},", TRACK_INPUT));
+  writer.Write(fmt::format("    {{ \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": {0}, \"args\": {{ \"name\": \"output files\" }} }}", TRACK_OUTPUT));
+  for (const impl::ProfileEvent& e : pimpl->profileEvents)
+  {
+    writer.WriteLine(",");
+    string args = e.bytes >= 0 ? fmt::format(", \"args\": {{ \"bytes\": {0} }}", e.bytes) : "";
+    writer.Write(fmt::format("    {{ \"name\": {0}, \"cat\": \"{1}\", \"ph\": \"X\", \"pid\": 1, \"tid\": {2}, \"ts\": {3:.0f}, \"dur\": {4:.0f}{5} }}",
+      JsonString(e.name), e.category, e.track, e.start, e.end - e.start, args));
+  }
+  writer.WriteLine();
+  writer.WriteLine("  ]");
+  writer.WriteLine("}");
+  writer.Close();
 }
@@ -90,6 +90,39 @@ inline int GetC(FILE* stream)
   return ch;
 }
 
+inline std::string JsonString(const std::string& s)
+{
+  std::string result = "\"";
+  for (char ch : s)
+  {
+    if (ch == '"' || ch == '\\')
+    {
+      result += '\\';
+      result += ch;
+    }
+    else if (static_cast<unsigned char>(ch) < 0x20)
+    {
+      // control characters must be escaped
+      const char* hexDigits = "0123456789abcdef";
+      result += "\\u00";
+      result += hexDigits[ch >> 4];
+      result += hexDigits[ch & 15];
+    }
+    else
+    {
+      result += ch;
+    }
+  }
+  result += '"';
+  return result;
+}
+
+// 0 stands for a value which is not known
+inline std::string JsonSize(std::size_t n)
+{
+  return n == 0 ? "null" : std::to_string(n);
+}
+
 template<class VALTYPE> class AutoRestore
 {
 public:
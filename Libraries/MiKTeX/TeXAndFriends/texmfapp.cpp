@@ -19,6 +19,8 @@
    Software Foundation, 59 Temple Place - Suite 330, Boston, MA
    02111-1307, USA. */
 
+#include <chrono>
+
 #include <fmt/format.h>
 #include <fmt/ostream.h>
 
@@ -26,6 +28,7 @@
 #include <miktex/Core/Directory>
 #include <miktex/Core/Paths>
 #include <miktex/Core/StreamReader>
+#include <miktex/Core/StreamWriter>
 
 #include <miktex/Trace/Trace>
 
@@ -73,6 +76,37 @@ public:
   ITeXMFMemoryHandler* memoryHandler = nullptr;
 public:
   UserParams userParams;
+public:
+  PathName memoryReportFile;
+public:
+  bool jobFinished = false;
+public:
+  bool memoryReportWritten = false;
+public:
+  chrono::steady_clock::time_point wallClockStart;
+public:
+  struct ArrayEvent
+  {
+    double time;
+    string arrayName;
+    size_t oldSize;
+    size_t newSize;
+  };
+public:
+  vector<ArrayEvent> arrayEvents;
+public:
+  struct ArrayReport
+  {
+    string arrayName;
+    size_t size;
+    // 0, if unknown
+    size_t peakUsed;
+    // 0, if not measured
+    size_t touchedSize;
+    size_t reservedSize;
+  };
+public:
+  vector<ArrayReport> arrayReports;
 };
 
 TeXMFApp::TeXMFApp() :
@@ -132,6 +166,7 @@ void TeXMFApp::Init(vector<char*>& args)
   pimpl->userParams.clear();
 
   pimpl->clockStart = clock();
+  pimpl->wallClockStart = chrono::steady_clock::now();
   pimpl->disableExtensions = false;
   pimpl->haltOnError = false;
   pimpl->interactionMode = -1;
@@ -149,12 +184,30 @@ void TeXMFApp::Init(vector<char*>& args)
 
 void TeXMFApp::Finalize()
 {
+  if (IsMemoryReportEnabled() && !pimpl->memoryReportWritten && GetTeXMFMemoryHandler() != nullptr)
+  {
+    // the job was aborted by an exception: report the arrays as they are
+    try
+    {
+      FreeMemory();
+      WriteMemoryReport();
+    }
+    catch (const MiKTeXException& ex)
+    {
+      LogError("the memory report could not be written: " + ex.GetErrorMessage());
+    }
+  }
   if (pimpl->trace_time != nullptr)
   {
     pimpl->trace_time->Close();
     pimpl->trace_time = nullptr;
   }
   pimpl->memoryDumpFileName = "";
+  pimpl->memoryReportFile = "";
+  pimpl->jobFinished = false;
+  pimpl->memoryReportWritten = false;
+  pimpl->arrayEvents.clear();
+  pimpl->arrayReports.clear();
   pimpl->jobName = "";
   WebAppInputLine::Finalize();
 }
@@ -179,6 +232,7 @@ void TeXMFApp::OnTeXMFStartJob()
 
 void TeXMFApp::OnTeXMFFinishJob()
 {
+  ProfilePhase("");
   if (pimpl->recordFileNames)
   {
     string fileName;
@@ -197,6 +251,42 @@ void TeXMFApp::OnTeXMFFinishJob()
   {
     TraceExecutionTime(pimpl->trace_time.get(), pimpl->clockStart);
   }
+  if (IsMemoryReportEnabled())
+  {
+    pimpl->jobFinished = true;
+    WriteMemoryReport();
+  }
+}
+
+void TeXMFApp::WriteMemoryReport()
+{
+  double wallTime = chrono::duration<double>(chrono::steady_clock::now() - pimpl->wallClockStart).count();
+  double cpuTime = static_cast<double>(clock() - pimpl->clockStart) / CLOCKS_PER_SEC;
+  StreamWriter writer(pimpl->memoryReportFile);
+  writer.WriteLine("{");
+  writer.WriteLine(fmt::format("  \"program\": {0},", JsonString(GetProgramName())));
+  writer.WriteLine(fmt::format("  \"finished\": {0},", pimpl->jobFinished ? "true" : "false"));
+  writer.WriteLine(fmt::format("  \"wall_time\": {0:.3f},", wallTime));
+  writer.WriteLine(fmt::format("  \"cpu_time\": {0:.3f},", cpuTime));
+  writer.WriteLine("  \"arrays\": [");
+  for (size_t idx = 0; idx < pimpl->arrayReports.size(); ++idx)
+  {
+    const impl::ArrayReport& r = pimpl->arrayReports[idx];
+    writer.WriteLine(fmt::format("    {{ \"name\": {0}, \"allocated\": {1}, \"peak_used\": {2}, \"touched\": {3}, \"reserved\": {4} }}{5}",
+      JsonString(r.arrayName), r.size, JsonSize(r.peakUsed), JsonSize(r.touchedSize), r.reservedSize, idx + 1 < pimpl->arrayReports.size() ? "," : ""));
+  }
+  writer.WriteLine("  ],");
+  writer.WriteLine("  \"growth_events\": [");
+  for (size_t idx = 0; idx < pimpl->arrayEvents.size(); ++idx)
+  {
+    const impl::ArrayEvent& e = pimpl->arrayEvents[idx];
+    writer.WriteLine(fmt::format("    {{ \"time\": {0:.6f}, \"name\": {1}, \"old_size\": {2}, \"new_size\": {3} }}{4}",
+      e.time, JsonString(e.arrayName), e.oldSize, e.newSize, idx + 1 < pimpl->arrayEvents.size() ? "," : ""));
+  }
+  writer.WriteLine("  ]");
+  writer.WriteLine("}");
+  writer.Close();
+  pimpl->memoryReportWritten = true;
 }
 
 enum {
@@ -218,6 +308,7 @@ enum {
   OPT_MAIN_MEMORY,
   OPT_MAX_PRINT_LINE,
   OPT_MAX_STRINGS,
+  OPT_MEMORY_REPORT,
   OPT_NO_C_STYLE_ERRORS,
   OPT_OUTPUT_DIRECTORY,
   OPT_PARAM_SIZE,
@@ -282,6 +373,7 @@ void TeXMFApp::AddOptions()
   AddOption(T_("main-memory\0Set main_memory to N."), FIRST_OPTION_VAL + pimpl->optBase + OPT_MAIN_MEMORY, POPT_ARG_STRING, "N");
   AddOption(T_("max-print-line\0Set max_print_line to N."), FIRST_OPTION_VAL + pimpl->optBase + OPT_MAX_PRINT_LINE, POPT_ARG_STRING, "N");
   AddOption(T_("max-strings\0Set max_strings to N."), FIRST_OPTION_VAL + pimpl->optBase + OPT_MAX_STRINGS, POPT_ARG_STRING, "N");
+  AddOption(T_("memory-report\0Write array sizes, growth events and execution times to FILE (JSON)."), FIRST_OPTION_VAL + pimpl->optBase + OPT_MEMORY_REPORT, POPT_ARG_STRING, "FILE");
   AddOption(T_("no-c-style-errors\0Disable file:line:error style messages."), FIRST_OPTION_VAL + pimpl->optBase + OPT_NO_C_STYLE_ERRORS);
   AddOption(T_("output-directory\0Use DIR as the directory to write output files to."), FIRST_OPTION_VAL + pimpl->optBase + OPT_OUTPUT_DIRECTORY, POPT_ARG_STRING, "DIR");
   AddOption(T_("param-size\0Set param_size to N."), FIRST_OPTION_VAL + pimpl->optBase + OPT_PARAM_SIZE, POPT_ARG_STRING, "N");
@@ -491,6 +583,11 @@ bool TeXMFApp::ProcessOption(int opt, const string& optArg)
     pimpl->timeStatistics = true;
     break;
 
+  case OPT_MEMORY_REPORT:
+    pimpl->memoryReportFile = optArg;
+    pimpl->memoryReportFile.MakeAbsolute();
+    break;
+
   case OPT_NO_C_STYLE_ERRORS:
     pimpl->showFileLineErrorMessages = false;
     break;
@@ -725,6 +822,8 @@ bool TeXMFApp::OpenMemoryDumpFile(const PathName& fileName_, FILE** ppFile, void
 
   *ppFile = stream.Detach();
 
+  ProfileFileOpened(*ppFile, path, "format");
+
   return true;
 }
 
@@ -737,6 +836,8 @@ void TeXMFApp::ProcessCommandLineOptions()
 
   WebAppInputLine::ProcessCommandLineOptions();
 
+  ProfilePhase("initialize");
+
   if (GetQuietFlag())
   {
     pimpl->showFileLineErrorMessages = true;
@@ -1009,6 +1110,30 @@ ITeXMFMemoryHandler* TeXMFApp::GetTeXMFMemoryHandler() const
   return pimpl->memoryHandler;
 }
 
+bool TeXMFApp::IsMemoryReportEnabled() const
+{
+  return !pimpl->memoryReportFile.Empty();
+}
+
+void TeXMFApp::OnArrayReallocated(const string& arrayName, size_t oldSize, size_t newSize)
+{
+  if (!IsMemoryReportEnabled())
+  {
+    return;
+  }
+  double time = chrono::duration<double>(chrono::steady_clock::now() - pimpl->wallClockStart).count();
+  pimpl->arrayEvents.push_back({ time, arrayName, oldSize, newSize });
+}
+
+void TeXMFApp::OnArrayFreed(const string& arrayName, size_t size, size_t peakUsed, size_t touchedSize, size_t reservedSize)
+{
+  if (!IsMemoryReportEnabled())
+  {
+    return;
+  }
+  pimpl->arrayReports.push_back({ arrayName, size, peakUsed, touchedSize, reservedSize });
+}
+
 TeXMFApp::UserParams& TeXMFApp::GetUserParams() const
 {
   return pimpl->userParams;
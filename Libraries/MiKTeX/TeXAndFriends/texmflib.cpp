@@ -61,6 +61,11 @@ STATICFUNC(bool) OpenFontFile(bytefile* file, const string& fontName, FileType f
     }
   }
   file->Attach(session->OpenFile(pathFont, FileMode::Open, FileAccess::Read, false), true);
+  WebAppInputLine* app = dynamic_cast<WebAppInputLine*>(MiKTeX::App::Application::GetApplication());
+  if (app != nullptr)
+  {
+    app->ProfileFileOpened(*file, pathFont, "font");
+  }
   file->Read();
   return true;
 }
@@ -0,0 +1,285 @@
+/* bibtex-x/miktex/bibindex.cpp:
+
+   Copyright (C) 2026 agent
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published
+   by the Free Software Foundation; either version 2, or (at your
+   option) any later version.
+
+   This file is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this file; if not, write to the Free Software
+   Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+   USA.  */
+
+#include "bibindex.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <miktex/Core/ConfigNames>
+#include <miktex/Core/Directory>
+#include <miktex/Core/File>
+#include <miktex/Core/MD5>
+#include <miktex/Core/Paths>
+#include <miktex/Core/Process>
+#include <miktex/Core/Session>
+
+using namespace MiKTeX::Core;
+using namespace std;
+
+// File layout: MAGIC, Header, path, Items, keys.  The index is only
+// ever read by the program that wrote it (or one built the same way),
+// so structures are stored as they are laid out in memory.
+const char MAGIC[] = "MiKTeX bib index 1\n";
+const size_t MAGIC_SIZE = sizeof(MAGIC) - 1;
+
+const int DEFAULT_THRESHOLD = 512;
+
+struct Header
+{
+  uint64_t fileSize;
+  int64_t lastWriteTime;
+  uint32_t pathLength;
+  uint32_t itemCount;
+  uint32_t keysSize;
+};
+
+struct Item
+{
+  int64_t lineStart;
+  int64_t lineNum;
+  int32_t column;
+  int32_t keyLength;
+  uint32_t keyOffset;
+};
+
+struct Index
+{
+  PathName bibPath;
+  uint64_t fileSize = 0;
+  int64_t lastWriteTime = 0;
+  vector<Item> items;
+  vector<unsigned char> keys;
+  size_t next = 0;
+};
+
+static map<FILE*, PathName> bibPaths;
+static unique_ptr<Index> currentIndex;
+
+static PathName GetIndexPath(const PathName& bibPath)
+{
+  PathName path = Session::Get()->GetSpecialPath(SpecialPath::DataRoot);
+  path /= MIKTEX_PATH_MIKTEX_CACHE_DIR;
+  path /= "bibtex";
+  path /= MD5::FromChars(bibPath.ToString()).ToString();
+  path.AppendExtension(".idx");
+  return path;
+}
+
+static unique_ptr<Index> StartIndex(FILE* bibFile)
+{
+  auto it = bibPaths.find(bibFile);
+  if (it == bibPaths.end())
+  {
+    return nullptr;
+  }
+  unique_ptr<Index> index = make_unique<Index>();
+  index->bibPath = it->second;
+  index->fileSize = File::GetSize(index->bibPath);
+  index->lastWriteTime = File::GetLastWriteTime(index->bibPath);
+  return index;
+}
+
+extern "C" void miktex_bib_index_remember(FILE* bibFile, const char* path)
+{
+  try
+  {
+    bibPaths[bibFile] = PathName(path).MakeAbsolute();
+  }
+  catch (const exception&)
+  {
+  }
+}
+
+extern "C" int miktex_bib_index_open(FILE* bibFile)
+{
+  currentIndex = nullptr;
+  try
+  {
+    unique_ptr<Index> index = StartIndex(bibFile);
+    if (index == nullptr)
+    {
+      return 0;
+    }
+    PathName path = GetIndexPath(index->bibPath);
+    if (!File::Exists(path))
+    {
+      return 0;
+    }
+    vector<unsigned char> bytes = File::ReadAllBytes(path);
+    if (bytes.size() < MAGIC_SIZE + sizeof(Header) || memcmp(&bytes[0], MAGIC, MAGIC_SIZE) != 0)
+    {
+      return 0;
+    }
+    Header header;
+    memcpy(&header, &bytes[MAGIC_SIZE], sizeof(header));
+    size_t pathOffset = MAGIC_SIZE + sizeof(Header);
+    size_t itemsOffset = pathOffset + header.pathLength;
+    size_t keysOffset = itemsOffset + static_cast<size_t>(header.itemCount) * sizeof(Item);
+    string bibPath = index->bibPath.ToString();
+    if (keysOffset + header.keysSize != bytes.size()
+      || header.fileSize != index->fileSize
+      || header.lastWriteTime != index->lastWriteTime
+      || header.pathLength != bibPath.length()
+      || memcmp(&bytes[pathOffset], bibPath.c_str(), bibPath.length()) != 0)
+    {
+      return 0;
+    }
+    index->items.resize(header.itemCount);
+    if (header.itemCount > 0)
+    {
+      memcpy(&index->items[0], &bytes[itemsOffset], header.itemCount * sizeof(Item));
+    }
+    index->keys.assign(bytes.begin() + keysOffset, bytes.end());
+    for (const Item& item : index->items)
+    {
+      if (item.keyLength > 0 && item.keyOffset + static_cast<size_t>(item.keyLength) > index->keys.size())
+      {
+        return 0;
+      }
+    }
+    // up-to-date: nothing to record for this file
+    bibPaths.erase(bibFile);
+    currentIndex = move(index);
+    return 1;
+  }
+  catch (const exception&)
+  {
+    // unreadable index: read the database file the usual way
+    return 0;
+  }
+}
+
+extern "C" int miktex_bib_index_next(long* lineStart, long* lineNum, int* column, const unsigned char** key, int* keyLength)
+{
+  if (currentIndex == nullptr || currentIndex->next >= currentIndex->items.size())
+  {
+    currentIndex = nullptr;
+    return 0;
+  }
+  const Item& item = currentIndex->items[currentIndex->next++];
+  *lineStart = static_cast<long>(item.lineStart);
+  *lineNum = static_cast<long>(item.lineNum);
+  *column = item.column;
+  if (item.keyLength < 0)
+  {
+    *key = nullptr;
+    *keyLength = 0;
+  }
+  else
+  {
+    *key = item.keyLength > 0 ? &currentIndex->keys[item.keyOffset] : reinterpret_cast<const unsigned char*>("");
+    *keyLength = item.keyLength;
+  }
+  return 1;
+}
+
+extern "C" int miktex_bib_index_begin(FILE* bibFile)
+{
+  currentIndex = nullptr;
+  try
+  {
+    shared_ptr<Session> session = Session::Get();
+    int threshold = session->GetConfigValue(MIKTEX_CONFIG_SECTION_NONE, "BibIndexThreshold", ConfigValue(DEFAULT_THRESHOLD)).GetInt();
+    unique_ptr<Index> index = threshold > 0 ? StartIndex(bibFile) : nullptr;
+    bibPaths.erase(bibFile);
+    if (index == nullptr || index->fileSize < static_cast<uint64_t>(threshold) * 1024)
+    {
+      return 0;
+    }
+    currentIndex = move(index);
+    return 1;
+  }
+  catch (const exception&)
+  {
+    return 0;
+  }
+}
+
+extern "C" void miktex_bib_index_add(long lineStart, long lineNum, int column)
+{
+  if (currentIndex == nullptr)
+  {
+    return;
+  }
+  Item item;
+  item.lineStart = lineStart;
+  item.lineNum = lineNum;
+  item.column = column;
+  item.keyLength = -1;
+  item.keyOffset = 0;
+  currentIndex->items.push_back(item);
+}
+
+extern "C" void miktex_bib_index_set_key(const unsigned char* key, int keyLength)
+{
+  if (currentIndex == nullptr || currentIndex->items.empty())
+  {
+    return;
+  }
+  Item& item = currentIndex->items.back();
+  item.keyOffset = static_cast<uint32_t>(currentIndex->keys.size());
+  item.keyLength = keyLength;
+  currentIndex->keys.insert(currentIndex->keys.end(), key, key + keyLength);
+}
+
+extern "C" void miktex_bib_index_end()
+{
+  unique_ptr<Index> index = move(currentIndex);
+  if (index == nullptr)
+  {
+    return;
+  }
+  try
+  {
+    string bibPath = index->bibPath.ToString();
+    Header header;
+    memset(&header, 0, sizeof(header));
+    header.fileSize = index->fileSize;
+    header.lastWriteTime = index->lastWriteTime;
+    header.pathLength = static_cast<uint32_t>(bibPath.length());
+    header.itemCount = static_cast<uint32_t>(index->items.size());
+    header.keysSize = static_cast<uint32_t>(index->keys.size());
+    vector<unsigned char> bytes(MAGIC, MAGIC + MAGIC_SIZE);
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(&header);
+    bytes.insert(bytes.end(), p, p + sizeof(header));
+    bytes.insert(bytes.end(), bibPath.begin(), bibPath.end());
+    p = reinterpret_cast<const unsigned char*>(index->items.data());
+    bytes.insert(bytes.end(), p, p + index->items.size() * sizeof(Item));
+    bytes.insert(bytes.end(), index->keys.begin(), index->keys.end());
+    PathName path = GetIndexPath(index->bibPath);
+    Directory::Create(path.GetDirectoryName());
+    // write a temporary file and rename it, so that concurrent
+    // readers never see a partially written index
+    PathName tempPath = path;
+    tempPath.AppendExtension(std::to_string(Process::GetCurrentProcess()->GetSystemId()));
+    tempPath.AppendExtension(".tmp");
+    File::WriteBytes(tempPath, bytes);
+    File::Move(tempPath, path, { FileMoveOption::ReplaceExisting });
+  }
+  catch (const exception&)
+  {
+    // the index is an optimization only
+  }
+}
@@ -0,0 +1,72 @@
+/* bibtex-x/miktex/bibindex.h:
+
+   Copyright (C) 2026 agent
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published
+   by the Free Software Foundation; either version 2, or (at your
+   option) any later version.
+
+   This file is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this file; if not, write to the Free Software
+   Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+   USA.  */
+
+/* Persistent index of .bib database files.  The index lists every
+   `@' that starts a command or an entry (in database order), with the
+   position of the line it is on and, for entries, the database
+   key.  With an index at hand, the reader can seek to the
+   commands and to the entries on the cite list, skipping everything
+   else.
+
+   Indexes are stored in the MiKTeX cache directory and are keyed by
+   the path, the size and the modification time of the database
+   file.  Files smaller than [<program>]BibIndexThreshold (in
+   kilobytes) are not indexed; a value of zero disables indexing.  */
+
+#pragma once
+
+#if defined(__cplusplus)
+#include <cstdio>
+#else
+#include <stdio.h>
+#endif
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* Associates an opened database file with its path. */
+void miktex_bib_index_remember(FILE* bibFile, const char* path);
+
+/* Loads the index of bibFile.  Returns 0, if there is no up-to-date
+   index. */
+int miktex_bib_index_open(FILE* bibFile);
+
+/* Retrieves the next item of the loaded index.  key is NULL, if the
+   item is not an entry (or if the entry has no valid database key).
+   Returns 0 at the end of the index. */
+int miktex_bib_index_next(long* lineStart, long* lineNum, int* column, const unsigned char** key, int* keyLength);
+
+/* Starts building an index for bibFile.  Returns 0, if bibFile
+   shall not be indexed or if miktex_bib_index_open() has already
+   found an up-to-date index. */
+int miktex_bib_index_begin(FILE* bibFile);
+
+/* Adds an item at the current position. */
+void miktex_bib_index_add(long lineStart, long lineNum, int column);
+
+/* Sets the database key of the last item. */
+void miktex_bib_index_set_key(const unsigned char* key, int keyLength);
+
+/* Saves the index; call this after bibFile has been read entirely. */
+void miktex_bib_index_end(void);
+
+#if defined(__cplusplus)
+}
+#endif
@@ -146,6 +146,9 @@
 #include "gblvars.h"
 #include "utils.h"
 #include "version.h"
+#if defined(MIKTEX)
+#include "miktex/bibindex.h"
+#endif
 
 
 
@@ -2070,12 +2073,23 @@ BEGIN
     BEGIN
       PRINT2 ("Database file #%ld: ", (long) bib_ptr + 1);
       print_bib_name ();
+#if defined(MIKTEX)
+      if (miktex_bib_index_open (CUR_BIB_FILE) && ( ! all_entries))
+      BEGIN
+	read_indexed_bib_file ();
+      END
+      else
+      BEGIN
+	read_bib_file ();
+      END
+#else
       bib_line_num = 0;
       buf_ptr2 = last;
       while ( ! feof (CUR_BIB_FILE))
       BEGIN
 	get_bib_command_or_entry_and_pr ();
       END
+#endif
       a_close (CUR_BIB_FILE);
       INCR (bib_ptr);
     END
@@ -2709,13 +2723,13 @@ BEGIN
   if (last_cite == Max_Cites)
   BEGIN
     BIB_XRETALLOC_NOSET ("cite_info", cite_info, StrNumber_T,
-                         Max_Cites, Max_Cites + MAX_CITES);
+                         Max_Cites, GROW_CAPACITY (Max_Cites, MAX_CITES));
     BIB_XRETALLOC_NOSET ("cite_list", cite_list, StrNumber_T,
-                         Max_Cites, Max_Cites + MAX_CITES);
+                         Max_Cites, GROW_CAPACITY (Max_Cites, MAX_CITES));
     BIB_XRETALLOC_NOSET ("entry_exists", entry_exists, Boolean_T,
-                         Max_Cites, Max_Cites + MAX_CITES);
+                         Max_Cites, GROW_CAPACITY (Max_Cites, MAX_CITES));
     BIB_XRETALLOC ("type_list", type_list, HashPtr2_T,
-                   Max_Cites, Max_Cites + MAX_CITES);
+                   Max_Cites, GROW_CAPACITY (Max_Cites, MAX_CITES));
     while (last_cite < Max_Cites)
     BEGIN
       type_list[last_cite] = EMPTY;
@@ -2772,7 +2786,7 @@ BEGIN
   BEGIN
     field_ptr = Max_Fields;
     BIB_XRETALLOC ("field_info", field_info, StrNumber_T,
-                   Max_Fields, total_fields + MAX_FIELDS);
+                   Max_Fields, GROW_CAPACITY (total_fields, MAX_FIELDS));
     /* Initialize to |missing|.  */
     while (field_ptr < Max_Fields)
     BEGIN
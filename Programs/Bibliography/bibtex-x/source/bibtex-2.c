@@ -141,6 +141,9 @@
 #include "gblvars.h"
 #include "utils.h"
 #include "version.h"
+#if defined(MIKTEX)
+#include "miktex/bibindex.h"
+#endif
 
 
 /***************************************************************************
@@ -1275,6 +1278,12 @@ BEGIN
     INCR (bib_line_num);
     buf_ptr2 = 0;
   END
+#if defined(MIKTEX)
+  if (bib_index_recording)
+  BEGIN
+    miktex_bib_index_add (bib_line_start, bib_line_num, buf_ptr2);
+  END
+#endif
 /*^^^^^^^^^^^^^^^^^^^^^^^^^^ END OF SECTION 237 ^^^^^^^^^^^^^^^^^^^^^^^^^^^*/
 
 /***************************************************************************
@@ -1587,6 +1596,12 @@ BEGIN
         }
 #endif                     		 	/* TRACE */
 
+#if defined(MIKTEX)
+	if (bib_index_recording)
+	BEGIN
+	  miktex_bib_index_set_key (&buffer[buf_ptr1], TOKEN_LEN);
+	END
+#endif
 	tmp_ptr = buf_ptr1;
 	while (tmp_ptr < buf_ptr2)
 	BEGIN
@@ -1876,6 +1891,74 @@ END
 /*^^^^^^^^^^^^^^^^^^^^^^^^^^ END OF SECTION 236 ^^^^^^^^^^^^^^^^^^^^^^^^^^^*/
 
 
+#if defined(MIKTEX)
+/***************************************************************************
+ * Reads the current .bib file from beginning to end, building an index
+ * of it on the way (if the file is large enough to be worth it).
+ ***************************************************************************/
+void          read_bib_file (void)
+BEGIN
+  bib_index_recording = miktex_bib_index_begin (CUR_BIB_FILE);
+  bib_line_num = 0;
+  buf_ptr2 = last;
+  while ( ! feof (CUR_BIB_FILE))
+  BEGIN
+    get_bib_command_or_entry_and_pr ();
+  END
+  if (bib_index_recording)
+  BEGIN
+    miktex_bib_index_end ();
+    bib_index_recording = FALSE;
+  END
+END
+
+
+
+/***************************************************************************
+ * Reads the current .bib file with the help of its index: commands are
+ * always processed, but an entry is looked at only if its database key
+ * is on |cite_list| at the time it would have been read (which takes
+ * care of cross references, too); the others would not be stored
+ * anyway.  |\nocite{*}| needs every entry, so it doesn't come here.
+ ***************************************************************************/
+void          read_indexed_bib_file (void)
+BEGIN
+  long                  line_start;
+  long                  line_num;
+  int                   column;
+  const unsigned char  *key;
+  int                   key_length;
+  int                   i;
+
+  while (miktex_bib_index_next (&line_start, &line_num, &column, &key,
+				&key_length))
+  BEGIN
+    if ((key != NULL) && (key_length <= Buf_Size))
+    BEGIN
+      for (i = 0; i < key_length; i++)
+      BEGIN
+	ex_buf[i] = key[i];
+      END
+      lower_case (ex_buf, 0, key_length);
+      (void) str_lookup (ex_buf, 0, key_length, LC_CITE_ILK, DONT_INSERT);
+      if ( ! hash_found)
+      BEGIN
+	continue;
+      END
+    END
+    if (fseek (CUR_BIB_FILE, line_start, SEEK_SET) != 0
+	  || ! input_ln (CUR_BIB_FILE))
+    BEGIN
+      continue;
+    END
+    bib_line_num = line_num;
+    buf_ptr2 = column;
+    get_bib_command_or_entry_and_pr ();
+  END
+END
+#endif
+
+
 /***************************************************************************
  * WEB section number:	 154
  * ~~~~~~~~~~~~~~~~~~~
@@ -2663,7 +2746,15 @@ BEGIN
         hash_next[k] = EMPTY;
         hash_text[k] = 0;
     END
+#if defined(MIKTEX)
+    for (k=0; k<Hash_Prime; k++)
+    BEGIN
+        hash_head[k] = EMPTY;
+    END
+    hash_used = HASH_BASE - 1;
+#else
     hash_used = HASH_MAX + 1;
+#endif
 /*^^^^^^^^^^^^^^^^^^^^^^^^^^ END OF SECTION 67 ^^^^^^^^^^^^^^^^^^^^^^^^^^^*/
 
 /***************************************************************************
@@ -2792,6 +2883,12 @@ BEGIN
   Boolean_T    	  input_ln;
 
   last = 0;
+#if defined(MIKTEX)
+  if (bib_index_recording)
+  BEGIN
+    bib_line_start = ftell (f);
+  END
+#endif
 
   if (feof (f))
   BEGIN
@@ -3282,7 +3379,12 @@ StrNumber_T       make_string (void)
 BEGIN
   if (str_ptr == Max_Strings)
   BEGIN
+#if defined(MIKTEX)
+    BIB_XRETALLOC ("str_start", str_start, PoolPointer_T,
+                   Max_Strings, GROW_CAPACITY (Max_Strings, MAX_STRINGS));
+#else
     BIBTEX_OVERFLOW ("number of strings ", Max_Strings);
+#endif
   END
   INCR (str_ptr);
   str_start[str_ptr] = pool_ptr;
@@ -3566,7 +3668,7 @@ END
 void          pool_overflow (void)
 BEGIN
   BIB_XRETALLOC ("str_pool", str_pool, ASCIICode_T,
-                 Pool_Size, Pool_Size + POOL_SIZE);
+                 Pool_Size, GROW_CAPACITY (Pool_Size, POOL_SIZE));
 END
 /*^^^^^^^^^^^^^^^^^^^^^^^^^^ END OF SECTION  53 ^^^^^^^^^^^^^^^^^^^^^^^^^^^*/
 
@@ -2448,6 +2448,82 @@ END
 
 
 
+#if defined(MIKTEX)
+/***************************************************************************
+ * The hash code of |buf[j..(j+l-1)]| (WEB section 69).
+ ***************************************************************************/
+long              hash_code (BufType_T buf, BufPointer_T j, BufPointer_T l)
+BEGIN
+  long                  h;
+  BufPointer_T		k;
+
+  h = 0;
+  k = j;
+  while (k < (j + l))
+  BEGIN
+    h = h + h + buf[k];
+    while (h >= Hash_Prime)
+      h = h - Hash_Prime;
+    INCR (k);
+  END
+  return (h);
+END
+
+
+
+/***************************************************************************
+ * Doubles the capacity of the hash table and rebuilds its lists for the
+ * smallest prime not less than |hash_load_percent|\% of the new
+ * |hash_size|.  Hash locations stay where they are.
+ ***************************************************************************/
+void              grow_hash_table (void)
+BEGIN
+  Integer_T             new_size;
+  Integer_T             want;
+  Integer_T             d;
+  HashLoc_T		p;
+  long                  h;
+
+  new_size = 2 * Hash_Size;
+  BIB_XRETALLOC_NOSET ("fn_type", fn_type, FnClass_T, Hash_Size, new_size);
+  BIB_XRETALLOC_NOSET ("hash_ilk", hash_ilk, StrIlk_T, Hash_Size, new_size);
+  BIB_XRETALLOC_NOSET ("hash_next", hash_next, HashPointer_T, Hash_Size,
+		       new_size);
+  BIB_XRETALLOC_NOSET ("hash_text", hash_text, StrNumber_T, Hash_Size,
+		       new_size);
+  BIB_XRETALLOC ("ilk_info", ilk_info, Integer_T, Hash_Size, new_size);
+
+  want = (Hash_Size / 100) * HASH_LOAD_PERCENT;
+  Hash_Prime = want | 1;
+  d = 3;
+  while (d * d <= Hash_Prime)
+  BEGIN
+    if (Hash_Prime % d == 0)
+    BEGIN
+      Hash_Prime = Hash_Prime + 2;
+      d = 3;
+    END
+    else
+    BEGIN
+      d = d + 2;
+    END
+  END
+  MYRETALLOC ("hash_head", hash_head, Hash_Prime, HashPointer_T);
+
+  for (h = 0; h < Hash_Prime; h++)
+  BEGIN
+    hash_head[h] = EMPTY;
+  END
+  for (p = HASH_BASE; p <= hash_used; p++)
+  BEGIN
+    h = hash_code (str_pool, str_start[hash_text[p]], LENGTH (hash_text[p]));
+    hash_next[p] = hash_head[h];
+    hash_head[h] = p;
+  END
+END
+#endif
+
+
 
 /***************************************************************************
  * WEB section number:	 68
@@ -2475,6 +2551,59 @@ BEGIN
   Boolean_T		old_string;
   StrNumber_T		str_num;
 
+#if defined(MIKTEX)
+  if (insert_it && (hash_used == HASH_MAX))
+  BEGIN
+    grow_hash_table ();
+  END
+  h = hash_code (buf, j, l);
+  hash_found = FALSE;
+  old_string = FALSE;
+  str_num = 0;
+  p = hash_head[h];
+  while (p != EMPTY)
+  BEGIN
+    if (str_eq_buf (hash_text[p], buf, j, l))
+    BEGIN
+      if (hash_ilk[p] == ilk)
+      BEGIN
+	hash_found = TRUE;
+	goto Str_Found_Label;
+      END
+      else
+      BEGIN
+	old_string = TRUE;
+	str_num = hash_text[p];
+      END
+    END
+    p = hash_next[p];
+  END
+  if ( ! insert_it)
+  BEGIN
+    goto Str_Not_Found_Label;
+  END
+  INCR (hash_used);
+  p = hash_used;
+  hash_next[p] = hash_head[h];
+  hash_head[h] = p;
+  if (old_string)
+  BEGIN
+    hash_text[p] = str_num;
+  END
+  else
+  BEGIN
+    STR_ROOM (l);
+    k = j;
+    while (k < (j + l))
+    BEGIN
+      APPEND_CHAR (buf[k]);
+      INCR (k);
+    END
+    hash_text[p] = make_string ();
+  END
+  hash_ilk[p] = ilk;
+  goto Str_Found_Label;
+#else
 /***************************************************************************
  * WEB section number:	69
  * ~~~~~~~~~~~~~~~~~~~
@@ -2584,6 +2713,7 @@ BEGIN
     END
     p = hash_next[p];
   END
+#endif
 Str_Not_Found_Label: DO_NOTHING;
 Str_Found_Label: str_lookup = p;
   return (str_lookup);
@@ -287,6 +287,17 @@
 #define GLOB_STR_SIZE               1000
 #define LIT_STK_SIZE                50
 
+/*
+ * Growable arrays are enlarged by at least the initial increment, but
+ * geometrically, so that huge databases don't cause quadratic copying.
+ */
+#if defined(MIKTEX)
+#define GROW_CAPACITY(size, increment) \
+  ((size) + (((size) > (increment)) ? (size) : (increment)))
+#else
+#define GROW_CAPACITY(size, increment) ((size) + (increment))
+#endif
+
 
 /***************************************************************************
  * WEB section number:   15
@@ -508,6 +519,17 @@
 #define HASH_BASE                   (EMPTY + 1)
 #define HASH_MAX                    (HASH_BASE + Hash_Size - 1)
 #define HASH_IS_FULL                ((hash_used) == (HASH_BASE))
+#if defined(MIKTEX)
+/*
+ * MiKTeX: the hash table grows.  Strings are put into consecutive
+ * locations |hash_base..hash_used| (locations never move, because they
+ * are remembered all over the place); |hash_head| maps a hash code to
+ * the first location of its list.  When all |hash_size| locations are
+ * used, the arrays are doubled and the lists are rebuilt for a new
+ * |hash_prime|, so that the load factor stays at about 1/0.85.
+ */
+#define HASH_LOAD_PERCENT           85
+#endif
 #define TEXT_ILK                    0
 #define INTEGER_ILK                 1
 #define AUX_COMMAND_ILK             2
@@ -846,7 +868,12 @@
  * |wiz_functions| explained below.
  ***************************************************************************/
 #define QUOTE_NEXT_FN               (HASH_BASE - 1)
+#if defined(MIKTEX)
+/* must not depend on |hash_size|, which can change */
+#define END_OF_DEF                  (HASH_BASE - 2)
+#else
 #define END_OF_DEF                  (HASH_MAX + 1)
+#endif
 
 /***************************************************************************
  * WEB section number:  161
@@ -988,7 +1015,11 @@
  * ~~~~~~~~~~~~~~~~~~~
  * These global variables are used ...
  ***************************************************************************/
+#if defined(MIKTEX)
+#define UNDEFINED                   (HASH_BASE - 2)
+#else
 #define UNDEFINED                   (HASH_MAX + 1)
+#endif
 
 /***************************************************************************
  * WEB section number:  221
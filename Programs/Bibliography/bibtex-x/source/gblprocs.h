@@ -205,6 +205,12 @@ void                    get_aux_command_and_process (void);
 void                    get_bib_command_or_entry_and_pr (void);
 void                    get_bst_command_and_process (void);
 void                    get_the_top_level_aux_file_name (void);
+#if defined(MIKTEX)
+void                    grow_hash_table (void);
+long                    hash_code (BufType_T buf,
+                                BufPointer_T j,
+                                BufPointer_T l);
+#endif
 
 void                    hash_cite_confusion (void);
 
@@ -288,6 +294,10 @@ void                    push_lit_stk (Integer_T push_lt,
 void                    quick_sort (CiteNumber_T left_end,
                                 CiteNumber_T right_end);
 
+#if defined(MIKTEX)
+void                    read_bib_file (void);
+void                    read_indexed_bib_file (void);
+#endif
 void                    sam_too_long_file_name_print (void);
 void                    sam_wrong_file_name_print (void);
 Boolean_T               scan1 (ASCIICode_T char1);
@@ -161,6 +161,10 @@ __EXTERN__ AlphaFile_T                  bbl_file;
 __EXTERN__ Integer_T                    bbl_line_num;
 __EXTERN__ Integer_T                    bib_brace_level;
 __EXTERN__ Integer_T                    bib_line_num;
+#if defined(MIKTEX)
+__EXTERN__ Boolean_T                    bib_index_recording;
+__EXTERN__ long                         bib_line_start;
+#endif
 __EXTERN__ BibNumber_T                  bib_ptr;
 __EXTERN__ Boolean_T                    bib_seen;
 __EXTERN__ Integer_T                    brace_level;
@@ -400,6 +404,9 @@ __EXTERN__ Integer_T                   *glb_str_end;
 __EXTERN__ StrNumber_T                 *glb_str_ptr;
 __EXTERN__ ASCIICode_T                 *global_strs;
 __EXTERN__ StrIlk_T                    *hash_ilk;
+#if defined(MIKTEX)
+__EXTERN__ HashPointer_T               *hash_head;
+#endif
 __EXTERN__ HashPointer_T               *hash_next;
 __EXTERN__ StrNumber_T                 *hash_text;
 __EXTERN__ Integer_T                   *ilk_info;
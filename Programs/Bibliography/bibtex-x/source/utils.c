@@ -151,6 +151,9 @@
 #include "gblvars.h"
 #include "utils.h"
 #include "version.h"
+#if defined(MIKTEX)
+#include "miktex/bibindex.h"
+#endif
 
 
 /*
@@ -876,6 +879,10 @@ FILE *open_ip_file (Integer_T search_path)
 	if (!kpse_in_name_ok(full_filespec))
 	    goto not_ok;
 	fptr = fopen (full_filespec, FOPEN_R_MODE);
+#if defined(MIKTEX)
+	if (fptr != NULL && search_path == BIB_FILE_SEARCH_PATH)
+	    miktex_bib_index_remember (fptr, full_filespec);
+#endif
 	free (full_filespec);
 #else
 # if defined(MSDOS) || defined(OS2)
@@ -1457,6 +1464,10 @@ void set_array_sizes (void)
 
     allocate_arrays ();
     compute_hash_prime ();
+#if defined(MIKTEX)
+    hash_head = (HashPointer_T *) mymalloc (Hash_Prime
+        * (unsigned long) sizeof (HashPointer_T), "hash_head");
+#endif
 
 
     debug_msg (DBG_MEM, "Hash_Prime = %d, Hash_Size = %d", 
@@ -0,0 +1,232 @@
+/* 1.cpp:
+
+   Copyright (C) 2026 agent
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published
+   by the Free Software Foundation; either version 2, or (at your
+   option) any later version.
+
+   This file is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this file; if not, write to the Free Software
+   Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+   USA.  */
+
+#include "config.h"
+
+#include <miktex/Core/Test>
+
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <miktex/Core/Directory>
+#include <miktex/Core/File>
+#include <miktex/Core/PathName>
+#include <miktex/Core/Paths>
+#include <miktex/Core/Utils>
+
+#include "miktex/bibindex.h"
+
+using namespace MiKTeX::Core;
+using namespace MiKTeX::Test;
+using namespace std;
+
+BEGIN_TEST_SCRIPT("bibtex-x-1");
+
+struct Item
+{
+  long lineStart;
+  long lineNum;
+  int column;
+  string key;
+};
+
+// a database of count entries, each on a line of its own; keys are
+// prefix0, prefix1, ...
+void WriteBib(const char* fileName, const string& prefix, int count)
+{
+  FILE* file = fopen(fileName, "wb");
+  if (file == nullptr)
+  {
+    FATAL();
+  }
+  fputs("@string{journal = \"TUGboat\"}\n", file);
+  for (int idx = 0; idx < count; ++idx)
+  {
+    fprintf(file, "@article{%s%d, title = \"Entry %d\", journal = journal}\n", prefix.c_str(), idx, idx);
+  }
+  fclose(file);
+}
+
+// what the reader does while reading the whole database: the
+// command and the entries, in database order
+vector<Item> Scan(const char* fileName)
+{
+  vector<Item> items;
+  FILE* file = fopen(fileName, "rb");
+  if (file == nullptr)
+  {
+    FATAL();
+  }
+  long lineStart = 0;
+  long lineNum = 1;
+  char line[1000];
+  while (fgets(line, sizeof(line), file) != nullptr)
+  {
+    Item item = { lineStart, lineNum, 0, "" };
+    if (strncmp(line, "@article{", 9) == 0)
+    {
+      item.key.assign(line + 9, strchr(line, ',') - (line + 9));
+    }
+    items.push_back(item);
+    lineStart = ftell(file);
+    ++lineNum;
+  }
+  fclose(file);
+  return items;
+}
+
+// opens the database as bibtex does; returns true, if an up-to-date
+// index was found; otherwise builds one, unless the file is too small
+bool Read(const char* fileName, vector<Item>& indexed)
+{
+  indexed.clear();
+  FILE* file = fopen(fileName, "rb");
+  if (file == nullptr)
+  {
+    FATAL();
+  }
+  miktex_bib_index_remember(file, PathName(fileName).MakeAbsolute().GetData());
+  bool haveIndex = miktex_bib_index_open(file) != 0;
+  if (haveIndex)
+  {
+    long lineStart;
+    long lineNum;
+    int column;
+    const unsigned char* key;
+    int keyLength;
+    while (miktex_bib_index_next(&lineStart, &lineNum, &column, &key, &keyLength))
+    {
+      Item item = { lineStart, lineNum, column, "" };
+      if (key != nullptr)
+      {
+        item.key.assign(reinterpret_cast<const char*>(key), keyLength);
+      }
+      indexed.push_back(item);
+    }
+  }
+  else if (miktex_bib_index_begin(file))
+  {
+    for (const Item& item : Scan(fileName))
+    {
+      miktex_bib_index_add(item.lineStart, item.lineNum, item.column);
+      if (!item.key.empty())
+      {
+        miktex_bib_index_set_key(reinterpret_cast<const unsigned char*>(item.key.c_str()), static_cast<int>(item.key.length()));
+      }
+    }
+    miktex_bib_index_end();
+  }
+  fclose(file);
+  return haveIndex;
+}
+
+bool Equals(const vector<Item>& items1, const vector<Item>& items2)
+{
+  if (items1.size() != items2.size())
+  {
+    return false;
+  }
+  for (size_t idx = 0; idx < items1.size(); ++idx)
+  {
+    if (items1[idx].lineStart != items2[idx].lineStart
+      || items1[idx].lineNum != items2[idx].lineNum
+      || items1[idx].column != items2[idx].column
+      || items1[idx].key != items2[idx].key)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// creation and reuse
+BEGIN_TEST_FUNCTION(1);
+{
+  PathName cacheDir = pSession->GetSpecialPath(SpecialPath::DataRoot);
+  cacheDir /= MIKTEX_PATH_MIKTEX_CACHE_DIR;
+  cacheDir /= "bibtex";
+  if (Directory::Exists(cacheDir))
+  {
+    Directory::Delete(cacheDir, true);
+  }
+  Utils::SetEnvironmentString("MIKTEX_BIBINDEXTHRESHOLD", "1");
+  WriteBib("1.bib", "first", 100);
+  vector<Item> indexed;
+  TEST(!Read("1.bib", indexed));
+  TEST(Read("1.bib", indexed));
+  TEST(Equals(indexed, Scan("1.bib")));
+  TEST(indexed[0].key.empty());
+  TEST(indexed[1].key == "first0");
+  TEST(Read("1.bib", indexed));
+}
+END_TEST_FUNCTION();
+
+// a changed database gets a new index
+BEGIN_TEST_FUNCTION(2);
+{
+  vector<Item> indexed;
+  TEST(Read("1.bib", indexed));
+  WriteBib("1.bib", "second", 120);
+  TEST(!Read("1.bib", indexed));
+  TEST(Read("1.bib", indexed));
+  TEST(Equals(indexed, Scan("1.bib")));
+  TEST(indexed[1].key == "second0");
+  // same size, other contents: the modification time tells
+  WriteBib("1.bib", "thirdx", 120);
+  time_t later = time(nullptr) + 10;
+  File::SetTimes(PathName("1.bib"), later, later, later);
+  TEST(!Read("1.bib", indexed));
+  TEST(Read("1.bib", indexed));
+  TEST(indexed[1].key == "thirdx0");
+}
+END_TEST_FUNCTION();
+
+// indexes are per file; small files are not indexed
+BEGIN_TEST_FUNCTION(3);
+{
+  vector<Item> indexed;
+  WriteBib("2.bib", "other", 100);
+  TEST(!Read("2.bib", indexed));
+  TEST(Read("2.bib", indexed));
+  TEST(indexed[1].key == "other0");
+  TEST(Read("1.bib", indexed));
+  TEST(indexed[1].key == "thirdx0");
+  WriteBib("3.bib", "small", 2);
+  TEST(!Read("3.bib", indexed));
+  TEST(!Read("3.bib", indexed));
+  Utils::SetEnvironmentString("MIKTEX_BIBINDEXTHRESHOLD", "0");
+  WriteBib("4.bib", "off", 100);
+  TEST(!Read("4.bib", indexed));
+  TEST(!Read("4.bib", indexed));
+}
+END_TEST_FUNCTION();
+
+BEGIN_TEST_PROGRAM();
+{
+  CALL_TEST_FUNCTION(1);
+  CALL_TEST_FUNCTION(2);
+  CALL_TEST_FUNCTION(3);
+}
+END_TEST_PROGRAM();
+
+END_TEST_SCRIPT();
+
+RUN_TEST_SCRIPT();
@@ -34,6 +34,12 @@ void miktex_log_info_va(const char* format, va_list args);
 void miktex_log_warn_va(const char* format, va_list args);
 void miktex_read_config_files();
 
+void miktex_start_workers(int numWorkers);
+void miktex_stop_workers();
+void* miktex_start_job(void (*func)(void*), void* data);
+int miktex_job_done(void* job);
+void miktex_wait_for_job(void* job);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -30,7 +30,12 @@ using namespace MiKTeX::Core;
 using namespace MiKTeX::Util;
 using namespace std;
 
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 extern "C"
 {
@@ -108,3 +113,140 @@ extern "C" void miktex_read_config_files()
     }
   }
 }
+
+class WorkerPool
+{
+public:
+  struct Job
+  {
+    void (*func)(void*);
+    void* data;
+    bool done;
+  };
+
+public:
+  void Start(int numWorkers)
+  {
+    for (int n = 0; n < numWorkers; ++n)
+    {
+      workers.push_back(thread(&WorkerPool::Work, this));
+    }
+  }
+
+public:
+  void Stop()
+  {
+    {
+      lock_guard<mutex> lock(mtx);
+      stopping = true;
+    }
+    jobAvailable.notify_all();
+    for (thread& t : workers)
+    {
+      t.join();
+    }
+    workers.clear();
+    stopping = false;
+  }
+
+public:
+  Job* Submit(void (*func)(void*), void* data)
+  {
+    Job* job = new Job{ func, data, false };
+    if (workers.empty())
+    {
+      func(data);
+      job->done = true;
+      return job;
+    }
+    {
+      lock_guard<mutex> lock(mtx);
+      jobs.push_back(job);
+    }
+    jobAvailable.notify_one();
+    return job;
+  }
+
+public:
+  bool IsDone(Job* job)
+  {
+    lock_guard<mutex> lock(mtx);
+    return job->done;
+  }
+
+public:
+  void Wait(Job* job)
+  {
+    {
+      unique_lock<mutex> lock(mtx);
+      jobDone.wait(lock, [job]() { return job->done; });
+    }
+    delete job;
+  }
+
+private:
+  void Work()
+  {
+    unique_lock<mutex> lock(mtx);
+    while (true)
+    {
+      jobAvailable.wait(lock, [this]() { return stopping || !jobs.empty(); });
+      if (jobs.empty())
+      {
+        return;
+      }
+      Job* job = jobs.front();
+      jobs.pop_front();
+      lock.unlock();
+      job->func(job->data);
+      lock.lock();
+      job->done = true;
+      jobDone.notify_all();
+    }
+  }
+
+private:
+  vector<thread> workers;
+
+private:
+  deque<Job*> jobs;
+
+private:
+  bool stopping = false;
+
+private:
+  mutex mtx;
+
+private:
+  condition_variable jobAvailable;
+
+private:
+  condition_variable jobDone;
+};
+
+WorkerPool workerPool;
+
+extern "C" void miktex_start_workers(int numWorkers)
+{
+  workerPool.Start(numWorkers);
+}
+
+extern "C" void miktex_stop_workers()
+{
+  workerPool.Stop();
+}
+
+extern "C" void* miktex_start_job(void (*func)(void*), void* data)
+{
+  return workerPool.Submit(func, data);
+}
+
+extern "C" int miktex_job_done(void* job)
+{
+  return workerPool.IsDone(reinterpret_cast<WorkerPool::Job*>(job)) ? 1 : 0;
+}
+
+extern "C" void miktex_wait_for_job(void* job)
+{
+  workerPool.Wait(reinterpret_cast<WorkerPool::Job*>(job));
+}
@@ -88,6 +88,9 @@ static int    opt_flags = 0;
 static int    pdf_version_major = 1;
 static int    pdf_version_minor = 5;
 static int    compression_level = 9;
+#if defined(MIKTEX)
+static int    compression_threads = 0;
+#endif
 
 static char   ignore_colors    = 0;
 static double annot_grow       = 0.0;
@@ -223,6 +226,9 @@ show_usage (void)
   printf ("  -x dimension\tSet horizontal offset [1.0in]\n");
   printf ("  -y dimension\tSet vertical offset [1.0in]\n");
   printf ("  -z number  \tSet zlib compression level (0-9) [9]\n");
+#if defined(MIKTEX)
+  printf ("  --compression-threads number\tCompress large streams on this many threads [0]\n");
+#endif
 
   printf ("  -C number\tSpecify miscellaneous option flags [0]:\n");
   printf ("\t\t  0x0001 reserved\n");
@@ -504,6 +510,9 @@ static struct option long_options[] = {
   {"dvipdfm", 0, 0, 132},
   {"mvorigin", 0, 0, 1000},
   {"kpathsea-debug", 1, 0, 133},
+#if defined(MIKTEX)
+  {"compression-threads", 1, 0, 1001},
+#endif
   {0, 0, 0, 0}
 };
 
@@ -702,6 +711,12 @@ do_args_second_pass (int argc, char *argv[], const char *source, int unsafe)
       compression_level = atoi(optarg);
       break;
 
+#if defined(MIKTEX)
+    case 1001: /* --compression-threads */
+      compression_threads = atoi(optarg);
+      break;
+#endif
+
     case 'd':
       pdfdecimaldigits = atoi(optarg);
       break;
@@ -1259,6 +1274,9 @@ main (int argc, char *argv[])
     pdf_set_version(version);
   }
   pdf_set_compression(compression_level);
+#if defined(MIKTEX)
+  pdf_set_compression_threads(compression_threads);
+#endif
   if (enable_thumbnail)
     pdf_doc_enable_manual_thumbnails();
 
@@ -52,6 +52,10 @@
 #include "pdfobj.h"
 #include "pdfdev.h"
 
+#if defined(MIKTEX)
+#include <miktex/dvipdfm-x.h>
+#endif
+
 #define STREAM_ALLOC_SIZE      4096u
 #define ARRAY_ALLOC_SIZE       256
 #define IND_OBJECTS_ALLOC_SIZE 512
@@ -260,6 +264,24 @@ static void release_stream (pdf_stream *stream);
 static char compression_level = 9;
 static char compression_use_predictor = 1;
 
+#if defined(MIKTEX) && defined(HAVE_ZLIB)
+static int  deflate_threads = 0;
+static int  deflate_active  = 0;
+
+static int  deflate_defer_output    (const void *buffer, int length);
+static int  deflate_defer_xref_entry (pdf_obj *object);
+static int  deflate_queue_stream    (pdf_obj *object);
+static void deflate_write_pending   (int max_pending);
+
+void
+pdf_set_compression_threads (int num_threads)
+{
+  if (num_threads < 0)
+    ERROR("set_compression_threads: invalid number of threads: %d", num_threads);
+  deflate_threads = num_threads;
+}
+#endif
+
 void
 pdf_set_compression (int level)
 {
@@ -396,6 +418,12 @@ pdf_out_init (const char *filename,
   enc_mode = 0;
   doc_enc_mode = do_encryption;
   compression_use_predictor = enable_predictor;
+#if defined(MIKTEX) && defined(HAVE_ZLIB)
+  if (deflate_threads > 0 && compression_level > 0) {
+    miktex_start_workers(deflate_threads);
+    deflate_active = 1;
+  }
+#endif
 }
 
 static void
@@ -510,6 +538,16 @@ pdf_out_flush (void)
     if (xref_stream)
       pdf_label_obj(xref_stream);
 
+#if defined(MIKTEX) && defined(HAVE_ZLIB)
+    /* Write out streams still being compressed; the xref stream itself
+     * is compressed on the main thread. */
+    if (deflate_active) {
+      deflate_write_pending(0);
+      miktex_stop_workers();
+      deflate_active = 0;
+    }
+#endif
+
     /* Record where this xref is for trailer */
     startxref = pdf_output_file_position;
 
@@ -630,6 +668,11 @@ void pdf_out_char (FILE *file, char c)
 {
   if (output_stream && file ==  pdf_output_file)
     pdf_add_stream(output_stream, &c, 1);
+#if defined(MIKTEX) && defined(HAVE_ZLIB)
+  else if (file == pdf_output_file && deflate_defer_output(&c, 1)) {
+    /* buffered behind a stream which is still being compressed */
+  }
+#endif
   else {
     fputc(c, file);
     /* Keep tallys for xref table *only* if writing a pdf file. */
@@ -655,6 +698,11 @@ void pdf_out (FILE *file, const void *buffer, int length)
 {
   if (output_stream && file ==  pdf_output_file)
     pdf_add_stream(output_stream, buffer, length);
+#if defined(MIKTEX) && defined(HAVE_ZLIB)
+  else if (file == pdf_output_file && deflate_defer_output(buffer, length)) {
+    /* buffered behind a stream which is still being compressed */
+  }
+#endif
   else {
     fwrite(buffer, 1, length, file);
     /* Keep tallys for xref table *only* if writing a pdf file */
@@ -1971,17 +2019,127 @@ filter_create_predictor_dict (int predictor, int32_t columns,
   return  parms;
 }
 
+#ifdef HAVE_ZLIB
+struct deflate_job
+{
+  unsigned char *data;   /* input; replaced by the compressed data */
+  uLong          length;
+  uLong          filtered_length;
+  int            predictor;
+  int32_t        columns;
+  int            bits_per_component;
+  int            colors;
+  int            level;
+  int            status;
+};
+
+/* Adds /DecodeParms, if a predictor is to be applied, and /FlateDecode
+ * to the dictionary of a stream which is going to be compressed, and
+ * sets up the job accordingly.  Returns 1 if the stream already had
+ * filters. */
+static int
+deflate_prepare_stream (pdf_stream *stream, struct deflate_job *job)
+{
+  pdf_obj *filters, *filter_name;
+
+  memset(job, 0, sizeof(*job));
+  job->level = compression_level;
+
+  /* First apply predictor filter if requested. */
+  if ( compression_use_predictor &&
+      (stream->_flags & STREAM_USE_PREDICTOR) &&
+      !pdf_lookup_dict(stream->dict, "DecodeParms")) {
+    switch (stream->decodeparms.predictor) {
+    case 2: /* TIFF2 */
+    case 15: /* PNG optimun */
+      job->predictor          = stream->decodeparms.predictor;
+      job->columns            = stream->decodeparms.columns;
+      job->bits_per_component = stream->decodeparms.bits_per_component;
+      job->colors             = stream->decodeparms.colors;
+      pdf_add_dict(stream->dict, pdf_new_name("DecodeParms"),
+                   filter_create_predictor_dict(job->predictor,
+                                                job->columns,
+                                                job->bits_per_component,
+                                                job->colors));
+      break;
+    default:
+      WARN("Unknown/unsupported Predictor function %d.",
+           stream->decodeparms.predictor);
+      break;
+    }
+  }
+
+  filters     = pdf_lookup_dict(stream->dict, "Filter");
+  filter_name = pdf_new_name("FlateDecode");
+  if (filters)
+    /*
+     * FlateDecode is the first filter to be applied to the stream.
+     */
+    pdf_unshift_array(filters, filter_name);
+  else
+    /*
+     * Adding the filter as a name instead of a one-element array
+     * is crucial because otherwise Adobe Reader cannot read the
+     * cross-reference stream any more, cf. the PDF v1.5 Errata.
+     */
+    pdf_add_dict(stream->dict, pdf_new_name("Filter"), filter_name);
+
+  return filters != NULL;
+}
+
+/* Applies the predictor filter and deflates the data.  Runs on the
+ * compression worker threads, too: must not touch any global state. */
+static void
+deflate_run_job (void *data)
+{
+  struct deflate_job *job = data;
+  unsigned char *filtered = job->data;
+  uLong          filtered_length = job->length;
+  unsigned char *buffer;
+  uLong          buffer_length;
+
+  if (job->predictor) {
+    int      bits_per_pixel = job->colors * job->bits_per_component;
+    int32_t  len  = (job->columns * bits_per_pixel + 7) / 8;
+    int32_t  rows = job->length / len;
+    int32_t  length2 = job->length;
+    unsigned char *filtered2;
+
+    if (job->predictor == 2)
+      filtered2 = filter_TIFF2_apply_filter(filtered, job->columns, rows,
+                                            job->bits_per_component,
+                                            job->colors, &length2);
+    else
+      filtered2 = filter_PNG15_apply_filter(filtered, job->columns, rows,
+                                            job->bits_per_component,
+                                            job->colors, &length2);
+    RELEASE(filtered);
+    filtered = filtered2;
+    filtered_length = length2;
+  }
+
+  buffer_length = filtered_length + filtered_length/1000 + 14;
+  buffer = NEW(buffer_length, unsigned char);
+#ifdef HAVE_ZLIB_COMPRESS2
+  job->status = compress2(buffer, &buffer_length, filtered,
+                          filtered_length, job->level);
+#else
+  job->status = compress(buffer, &buffer_length, filtered,
+                         filtered_length);
+#endif /* HAVE_ZLIB_COMPRESS2 */
+  RELEASE(filtered);
+
+  job->data            = buffer;
+  job->length          = buffer_length;
+  job->filtered_length = filtered_length;
+}
+#endif /* HAVE_ZLIB */
+
 static void
 write_stream (pdf_stream *stream, FILE *file)
 {
   unsigned char *filtered;
   unsigned int   filtered_length;
-#ifdef HAVE_ZLIB
-  uLong          buffer_length;
-#else
-  unsigned int   buffer_length;
-#endif
-  unsigned char *buffer;
 
   /*
    * Always work from a copy of the stream. All filters read from
@@ -2008,90 +2166,21 @@ write_stream (pdf_stream *stream, FILE *file)
   if (stream->stream_length > 0 &&
       (stream->_flags & STREAM_COMPRESS) &&
       compression_level > 0) {
-    pdf_obj *filters;
-
-    /* First apply predictor filter if requested. */
-    if ( compression_use_predictor &&
-        (stream->_flags & STREAM_USE_PREDICTOR) &&
-        !pdf_lookup_dict(stream->dict, "DecodeParms")) {
-      int      bits_per_pixel  = stream->decodeparms.colors *
-                                   stream->decodeparms.bits_per_component;
-      int32_t  len  = (stream->decodeparms.columns * bits_per_pixel + 7) / 8;
-      int32_t  rows = stream->stream_length / len;
-      unsigned char *filtered2 = NULL;
-      int32_t        length2 = stream->stream_length;
-      pdf_obj       *parms;
-
-      parms = filter_create_predictor_dict(stream->decodeparms.predictor,
-                                        stream->decodeparms.columns,
-                                        stream->decodeparms.bits_per_component,
-                                        stream->decodeparms.colors);
-
-      switch (stream->decodeparms.predictor) {
-      case 2: /* TIFF2 */
-        filtered2 = filter_TIFF2_apply_filter(filtered,
-                                         stream->decodeparms.columns,
-                                         rows,
-                                         stream->decodeparms.bits_per_component,
-                                         stream->decodeparms.colors, &length2);
-        break;
-      case 15: /* PNG optimun */
-        filtered2 = filter_PNG15_apply_filter(filtered,
-                                         stream->decodeparms.columns,
-                                         rows,
-                                         stream->decodeparms.bits_per_component,
-                                         stream->decodeparms.colors, &length2);
-        break;
-      default:
-        WARN("Unknown/unsupported Predictor function %d.",
-             stream->decodeparms.predictor);
-        break;
-      }
-      if (parms && filtered2) {
-        RELEASE(filtered);
-        filtered = filtered2;
-        filtered_length = length2;
-        pdf_add_dict(stream->dict, pdf_new_name("DecodeParms"), parms);
-      }
-    }
-
-    filters = pdf_lookup_dict(stream->dict, "Filter");
-
-    buffer_length = filtered_length + filtered_length/1000 + 14;
-    buffer = NEW(buffer_length, unsigned char);
-    {
-      pdf_obj *filter_name = pdf_new_name("FlateDecode");
-
-      if (filters)
-        /*
-         * FlateDecode is the first filter to be applied to the stream.
-         */
-        pdf_unshift_array(filters, filter_name);
-      else
-        /*
-         * Adding the filter as a name instead of a one-element array
-         * is crucial because otherwise Adobe Reader cannot read the
-         * cross-reference stream any more, cf. the PDF v1.5 Errata.
-         */
-        pdf_add_dict(stream->dict, pdf_new_name("Filter"), filter_name);
-    }
-#ifdef HAVE_ZLIB_COMPRESS2    
-    if (compress2(buffer, &buffer_length, filtered,
-		  filtered_length, compression_level)) {
+    struct deflate_job job;
+    int                has_filters;
+
+    has_filters = deflate_prepare_stream(stream, &job);
+    job.data    = filtered;
+    job.length  = filtered_length;
+    deflate_run_job(&job);
+    if (job.status != Z_OK) {
       ERROR("Zlib error");
     }
-#else 
-    if (compress(buffer, &buffer_length, filtered,
-		 filtered_length)) {
-      ERROR ("Zlib error");
-    }
-#endif /* HAVE_ZLIB_COMPRESS2 */
-    RELEASE(filtered);
-    compression_saved += filtered_length - buffer_length
-      - (filters ? strlen("/FlateDecode "): strlen("/Filter/FlateDecode\n"));
+    compression_saved += job.filtered_length - job.length
+      - (has_filters ? strlen("/FlateDecode "): strlen("/Filter/FlateDecode\n"));
 
-    filtered        = buffer;
-    filtered_length = buffer_length;
+    filtered        = job.data;
+    filtered_length = job.length;
   }
 #endif /* HAVE_ZLIB */
 
@@ -2911,12 +3000,247 @@ pdf_write_obj (pdf_obj *object, FILE *file)
   }
 }
 
+#if defined(MIKTEX) && defined(HAVE_ZLIB)
+/*
+ * Parallel stream compression
+ *
+ * Large compressed streams are handed to a pool of worker threads which
+ * apply the predictor filter and deflate the data.  Everything written
+ * after such a stream is buffered until its compressed data arrives, so
+ * objects still appear in the file in the order in which they were
+ * flushed, and the output is identical to the single-threaded case.
+ *
+ * The stream dictionary is written when the stream is queued, minus the
+ * /Length entry which is appended once the compressed length is known.
+ */
+
+/* Smaller streams are compressed on the main thread. */
+#define DEFLATE_MIN_LENGTH  4096u
+/* Maximum number of streams in flight. */
+#define DEFLATE_MAX_PENDING 64
+
+struct deflate_deferred_xref
+{
+  unsigned int   label;
+  unsigned short generation;
+  unsigned int   offset;
+};
+
+struct deflate_pending
+{
+  unsigned int       label;
+  unsigned short     generation;
+  int                enc_mode;
+  int                has_filters;
+  int                line_position;
+  struct deflate_job job;
+  void              *handle;
+  /* Output written after this stream, while it was being compressed */
+  unsigned char     *output;
+  unsigned int       output_length;
+  unsigned int       output_max;
+  struct deflate_deferred_xref *xrefs;
+  int                num_xrefs;
+  int                max_xrefs;
+};
+
+static struct deflate_pending deflate_queue[DEFLATE_MAX_PENDING];
+static int deflate_first   = 0;
+static int deflate_count   = 0;
+static int deflate_writing = 0;
+
+#define DEFLATE_LAST() \
+  (&deflate_queue[(deflate_first + deflate_count - 1) % DEFLATE_MAX_PENDING])
+
+static int
+deflate_defer_output (const void *buffer, int length)
+{
+  struct deflate_pending *last;
+
+  if (deflate_count == 0 || deflate_writing)
+    return 0;
+
+  last = DEFLATE_LAST();
+  if (last->output_length + length > last->output_max) {
+    last->output_max += length + STREAM_ALLOC_SIZE;
+    last->output      = RENEW(last->output, last->output_max, unsigned char);
+  }
+  memcpy(last->output + last->output_length, buffer, length);
+  last->output_length += length;
+
+  pdf_output_line_position += length;
+  if (length > 0 &&
+      ((const char *)buffer)[length-1] == '\n')
+    pdf_output_line_position = 0;
+
+  return 1;
+}
+
+static int
+deflate_defer_xref_entry (pdf_obj *object)
+{
+  struct deflate_pending *last;
+
+  if (deflate_count == 0 || deflate_writing)
+    return 0;
+
+  last = DEFLATE_LAST();
+  if (last->num_xrefs == last->max_xrefs) {
+    last->max_xrefs += 16;
+    last->xrefs      = RENEW(last->xrefs, last->max_xrefs, struct deflate_deferred_xref);
+  }
+  last->xrefs[last->num_xrefs].label      = object->label;
+  last->xrefs[last->num_xrefs].generation = object->generation;
+  last->xrefs[last->num_xrefs].offset     = last->output_length;
+  last->num_xrefs++;
+
+  return 1;
+}
+
+/* Called from pdf_flush_obj() after the "obj" line has been written. */
+static int
+deflate_queue_stream (pdf_obj *object)
+{
+  pdf_stream *stream;
+  pdf_dict   *dict;
+  pdf_obj    *type;
+  struct deflate_pending *p;
+
+  if (object->type != PDF_STREAM)
+    return 0;
+  stream = object->data;
+  if (!(stream->_flags & STREAM_COMPRESS) || compression_level == 0 ||
+      stream->stream_length < DEFLATE_MIN_LENGTH)
+    return 0;
+  /* PDF/A requires Metadata to be not filtered. */
+  type = pdf_lookup_dict(stream->dict, "Type");
+  if (type && !strcmp("Metadata", pdf_name_value(type)))
+    return 0;
+  /* /Length must come last in the dictionary. */
+  if (pdf_lookup_dict(stream->dict, "Length"))
+    return 0;
+
+  p = &deflate_queue[(deflate_first + deflate_count) % DEFLATE_MAX_PENDING];
+  memset(p, 0, sizeof(*p));
+  p->label      = object->label;
+  p->generation = object->generation;
+  p->enc_mode   = enc_mode;
+  p->has_filters = deflate_prepare_stream(stream, &p->job);
+
+  /* Everything but /Length and the closing ">>" (cf. write_dict()) */
+  pdf_out(pdf_output_file, "<<", 2);
+  for (dict = stream->dict->data; dict->key != NULL; dict = dict->next) {
+    pdf_write_obj(dict->key, pdf_output_file);
+    if (pdf_need_white(PDF_NAME, (dict->value)->type)) {
+      pdf_out_white(pdf_output_file);
+    }
+    pdf_write_obj(dict->value, pdf_output_file);
+  }
+  p->line_position = pdf_output_line_position;
+
+  p->job.data   = NEW(stream->stream_length, unsigned char);
+  p->job.length = stream->stream_length;
+  memcpy(p->job.data, stream->stream, stream->stream_length);
+  p->handle = miktex_start_job(deflate_run_job, &p->job);
+  deflate_count++;
+
+  /* What follows is buffered as if the object had been written; the
+   * object ends with "endobj" on a line of its own. */
+  pdf_output_line_position = 0;
+
+  return 1;
+}
+
+/* Write queued streams in order until at most max_pending are left.
+ * Streams whose compressed data has already arrived are written anyway. */
+static void
+deflate_write_pending (int max_pending)
+{
+  while (deflate_count > 0) {
+    struct deflate_pending *p = &deflate_queue[deflate_first];
+    int            line_position = pdf_output_line_position;
+    unsigned char *data;
+    size_t         length;
+    unsigned int   base;
+    int            i;
+
+    if (deflate_count <= max_pending && !miktex_job_done(p->handle))
+      break;
+    miktex_wait_for_job(p->handle);
+    if (p->job.status != Z_OK)
+      ERROR("Zlib error");
+
+    deflate_writing = 1;
+    deflate_first   = (deflate_first + 1) % DEFLATE_MAX_PENDING;
+    deflate_count--;
+
+    compression_saved += p->job.filtered_length - p->job.length
+      - (p->has_filters ? strlen("/FlateDecode "): strlen("/Filter/FlateDecode\n"));
+
+    data   = p->job.data;
+    length = p->job.length;
+    enc_mode = p->enc_mode;
+    if (enc_mode) {
+      unsigned char *cipher = NULL;
+      size_t         cipher_len = 0;
+      pdf_enc_set_label(p->label);
+      pdf_enc_set_generation(p->generation);
+      pdf_encrypt_data(data, length, &cipher, &cipher_len);
+      RELEASE(data);
+      data   = cipher;
+      length = cipher_len;
+    }
+
+    pdf_output_line_position = p->line_position;
+    {
+      pdf_obj *key   = pdf_new_name("Length");
+      pdf_obj *value = pdf_new_number(length);
+      pdf_write_obj(key, pdf_output_file);
+      if (pdf_need_white(PDF_NAME, PDF_NUMBER)) {
+        pdf_out_white(pdf_output_file);
+      }
+      pdf_write_obj(value, pdf_output_file);
+      pdf_release_obj(key);
+      pdf_release_obj(value);
+    }
+    pdf_out(pdf_output_file, ">>", 2);
+    pdf_out(pdf_output_file, "\nstream\n", 8);
+    if (length > 0)
+      pdf_out(pdf_output_file, data, length);
+    RELEASE(data);
+    pdf_out(pdf_output_file, "\n", 1);
+    pdf_out(pdf_output_file, "endstream", 9);
+    pdf_out(pdf_output_file, "\nendobj\n", 8);
+
+    base = pdf_output_file_position;
+    for (i = 0; i < p->num_xrefs; i++) {
+      add_xref_entry(p->xrefs[i].label, 1,
+                     base + p->xrefs[i].offset, p->xrefs[i].generation);
+    }
+    if (p->output_length > 0)
+      pdf_out(pdf_output_file, p->output, p->output_length);
+    if (p->output)
+      RELEASE(p->output);
+    if (p->xrefs)
+      RELEASE(p->xrefs);
+
+    pdf_output_line_position = line_position;
+    deflate_writing = 0;
+  }
+}
+#endif
+
 /* Write the object to the file */ 
 static void
 pdf_flush_obj (pdf_obj *object, FILE *file)
 {
   int length;
 
+#if defined(MIKTEX) && defined(HAVE_ZLIB)
+  if (deflate_active)
+    deflate_write_pending(DEFLATE_MAX_PENDING - 1);
+  if (!deflate_defer_xref_entry(object))
+#endif
   /*
    * Record file position
    */
@@ -2927,6 +3251,10 @@ pdf_flush_obj (pdf_obj *object, FILE *file)
   pdf_enc_set_label(object->label);
   pdf_enc_set_generation(object->generation);
   pdf_out(file, format_buffer, length);
+#if defined(MIKTEX) && defined(HAVE_ZLIB)
+  if (deflate_active && deflate_queue_stream(object))
+    return;
+#endif
   pdf_write_obj(object, file);
   pdf_out(file, "\nendobj\n", 8);
 }
@@ -172,6 +172,9 @@ extern int         pdf_compare_reference (pdf_obj *ref1, pdf_obj *ref2);
  */
 
 extern void      pdf_set_compression (int level);
+#if defined(MIKTEX)
+extern void      pdf_set_compression_threads (int num_threads);
+#endif
 
 extern void      pdf_set_info     (pdf_obj *obj);
 extern void      pdf_set_root     (pdf_obj *obj);
@@ -58,6 +58,10 @@
 
 #include "tfm.h"
 
+#if defined(MIKTEX)
+#include <miktex/fontcache.h>
+#endif
+
 #define FONT_FLAG_FIXEDPITCH (1 << 0)  /* Fixed-width font */
 #define FONT_FLAG_SERIF      (1 << 1)  /* Serif font */
 #define FONT_FLAG_SYMBOLIC   (1 << 2)  /* Symbolic font */
@@ -122,6 +126,59 @@ pdf_font_open_type1 (pdf_font *font)
   return 0;
 }
 
+#if defined(MIKTEX)
+/*
+ * Cross-run subset cache
+ *
+ * The result of subsetting a Type 1 font depends on the font file, the
+ * font name (Flags), the set of used codes and, unless the built-in
+ * encoding is used, the glyph names those codes are mapped to.  Entries
+ * hold everything pdf_font_load_type1() puts into the font dictionary
+ * and descriptor, except what comes from the TFM file.
+ */
+#define CACHE_PROGRAM     "dvipdfmx"
+#define CACHE_KEY_VERSION "type1 1"
+
+struct cache_buffer
+{
+  char     *data;
+  uint32_t  length;
+  uint32_t  max_length;
+};
+
+typedef struct
+{
+  char   usedchars[256]; /* codes left after dropping missing glyphs */
+  double capheight, ascent, descent, italicangle, stemv;
+  int    flags;
+  double bbox[4];
+  int    num_glyphs;
+  double scaling;
+  double widths[256];    /* glyph widths, by code */
+  int    names_length;   /* built-in encoding: names of the used codes */
+  int    charset_length;
+  int    fontfile_length;
+} cache_header;
+
+static cache_header        cache_hdr;
+static struct cache_buffer cache_names, cache_charset, cache_fontfile;
+/* -1: not yet known */
+static int                 cache_enabled = -1;
+
+static void
+cache_append (struct cache_buffer *buf, const void *data, uint32_t length)
+{
+  if (length == 0 || !cache_enabled)
+    return;
+  if (buf->length + length > buf->max_length) {
+    buf->max_length += length + 1024;
+    buf->data = RENEW(buf->data, buf->max_length, char);
+  }
+  memcpy(buf->data + buf->length, data, length);
+  buf->length += length;
+}
+#endif
+
 static void
 get_font_attr (pdf_font *font, cff_font *cffont)
 {
@@ -265,6 +322,14 @@ get_font_attr (pdf_font *font, cff_font *cffont)
                pdf_new_name("StemV"), pdf_new_number(stemv));
   pdf_add_dict(descriptor,
                pdf_new_name("Flags"), pdf_new_number(flags));
+#if defined(MIKTEX)
+  cache_hdr.capheight   = capheight;
+  cache_hdr.ascent      = ascent;
+  cache_hdr.descent     = descent;
+  cache_hdr.italicangle = italicangle;
+  cache_hdr.stemv       = stemv;
+  cache_hdr.flags       = flags;
+#endif
 }
 
 static void
@@ -305,6 +370,9 @@ add_metrics (pdf_font *font, cff_font *cffont, char **enc_vec, double *widths, i
   for (i = 0; i < 4; i++) {
     val = cff_dict_get(cffont->topdict, "FontBBox", i);
     pdf_add_array(tmp_array, pdf_new_number(ROUND(val, 1.0)));
+#if defined(MIKTEX)
+    cache_hdr.bbox[i] = ROUND(val, 1.0);
+#endif
   }
   pdf_add_dict(descriptor, pdf_new_name("FontBBox"), tmp_array);
 
@@ -331,9 +399,15 @@ add_metrics (pdf_font *font, cff_font *cffont, char **enc_vec, double *widths, i
      */
 #endif /* !LIBDPX */
     tfm_id = tfm_open(pdf_font_get_mapname(font), 0);
+#if defined(MIKTEX)
+    cache_hdr.scaling = scaling;
+#endif
     for (code = firstchar; code <= lastchar; code++) {
       if (usedchars[code]) {
         double width;
+#if defined(MIKTEX)
+        cache_hdr.widths[code] = widths[cff_glyph_lookup(cffont, enc_vec[code])];
+#endif
         if (tfm_id < 0) /* tfm is not found */
           width = scaling * widths[cff_glyph_lookup(cffont, enc_vec[code])];
 #if defined(LIBDPX)
@@ -493,6 +567,11 @@ write_fontfile (pdf_font *font, cff_font *cffont, pdf_obj *pdfcharset)
                pdf_new_name("Subtype"),   pdf_new_name("Type1C"));
   pdf_add_stream (fontfile, (void *) stream_data_ptr,  offset);
   pdf_release_obj(fontfile);
+#if defined(MIKTEX)
+  cache_append(&cache_fontfile, stream_data_ptr, offset);
+  cache_append(&cache_charset, pdf_stream_dataptr(pdfcharset),
+               pdf_stream_length(pdfcharset));
+#endif
 #if !defined(LIBDPX)
   pdf_add_dict(descriptor,
                pdf_new_name("CharSet"),
@@ -505,6 +584,194 @@ write_fontfile (pdf_font *font, cff_font *cffont, pdf_obj *pdfcharset)
 }
 
 
+#if defined(MIKTEX)
+static void
+cache_make_key (struct cache_buffer *key, pdf_font *font, int encoding_id)
+{
+  char *usedchars = pdf_font_get_usedchars(font);
+  char *fontname  = pdf_font_get_fontname (font);
+  int   code;
+
+  cache_append(key, CACHE_KEY_VERSION, strlen(CACHE_KEY_VERSION) + 1);
+  cache_append(key, fontname, strlen(fontname) + 1);
+  cache_append(key, usedchars, 256);
+  if (encoding_id >= 0) {
+    char **enc_vec = pdf_encoding_get_encoding(encoding_id);
+    for (code = 0; code < 256; code++) {
+      const char *glyph = usedchars[code] && enc_vec[code] ? enc_vec[code] : "";
+      cache_append(key, glyph, strlen(glyph) + 1);
+    }
+  }
+}
+
+/*
+ * Replays what the code below does on a cache hit.  Objects are
+ * created in the same order, so the output does not depend on whether
+ * the cache was used.
+ */
+static int
+cache_load_font (pdf_font *font, FILE *fp, int encoding_id,
+                 const struct cache_buffer *key)
+{
+  cache_header hdr;
+  pdf_obj     *fontdict, *descriptor, *tmp_array, *fontfile;
+  char        *data, *names, *charset, *usedchars, *fontname, *uniqueTag;
+  card8       *cff_data;
+  size_t       size;
+  int          code, firstchar, lastchar, tfm_id, i;
+
+  data = miktex_font_cache_get(CACHE_PROGRAM, fp, key->data, key->length, &size);
+  if (!data)
+    return 0;
+  memcpy(&hdr, data, size < sizeof(hdr) ? size : sizeof(hdr));
+  if (size < sizeof(hdr) || hdr.fontfile_length < 4 ||
+      size != sizeof(hdr) + hdr.names_length + hdr.charset_length + hdr.fontfile_length ||
+      (encoding_id < 0 && (hdr.names_length == 0 || data[sizeof(hdr) + hdr.names_length - 1] != 0))) {
+    free(data);
+    return 0;
+  }
+  names    = data + sizeof(hdr);
+  charset  = names + hdr.names_length;
+  cff_data = (card8 *) (charset + hdr.charset_length);
+
+  fontdict   = pdf_font_get_resource  (font);
+  descriptor = pdf_font_get_descriptor(font);
+  usedchars  = pdf_font_get_usedchars (font);
+  fontname   = pdf_font_get_fontname  (font);
+  uniqueTag  = pdf_font_get_uniqueTag (font);
+
+  if (encoding_id < 0 && !pdf_lookup_dict(fontdict, "ToUnicode")) {
+    char    *enc_vec[256], *fullname, *p;
+    pdf_obj *tounicode;
+
+    for (p = names, code = 0; code < 256; code++) {
+      enc_vec[code] = p < names + hdr.names_length && *p ? p : NULL;
+      p += p < names + hdr.names_length ? strlen(p) + 1 : 0;
+    }
+    fullname = NEW(strlen(fontname) + 8, char);
+    sprintf(fullname, "%6s+%s", uniqueTag, fontname);
+    tounicode = pdf_create_ToUnicode_CMap(fullname, enc_vec, usedchars);
+    if (tounicode) {
+      pdf_add_dict(fontdict,
+                   pdf_new_name("ToUnicode"),
+                   pdf_ref_obj (tounicode));
+      pdf_release_obj(tounicode);
+    }
+    RELEASE(fullname);
+  }
+  memcpy(usedchars, hdr.usedchars, 256);
+
+  /* get_font_attr() */
+  pdf_add_dict(descriptor,
+               pdf_new_name("CapHeight"), pdf_new_number(hdr.capheight));
+  pdf_add_dict(descriptor,
+               pdf_new_name("Ascent"), pdf_new_number(hdr.ascent));
+  pdf_add_dict(descriptor,
+               pdf_new_name("Descent"), pdf_new_number(hdr.descent));
+  pdf_add_dict(descriptor,
+               pdf_new_name("ItalicAngle"), pdf_new_number(hdr.italicangle));
+  pdf_add_dict(descriptor,
+               pdf_new_name("StemV"), pdf_new_number(hdr.stemv));
+  pdf_add_dict(descriptor,
+               pdf_new_name("Flags"), pdf_new_number(hdr.flags));
+
+  /* add_metrics() */
+  tmp_array = pdf_new_array();
+  for (i = 0; i < 4; i++) {
+    pdf_add_array(tmp_array, pdf_new_number(hdr.bbox[i]));
+  }
+  pdf_add_dict(descriptor, pdf_new_name("FontBBox"), tmp_array);
+  tmp_array = pdf_new_array();
+  if (hdr.num_glyphs <= 1) {
+    firstchar = lastchar = 0;
+    pdf_add_array(tmp_array, pdf_new_number(0.0));
+  } else {
+    for (firstchar = 255, lastchar = 0, code = 0; code < 256; code++) {
+      if (usedchars[code]) {
+        if (code < firstchar) firstchar = code;
+        if (code > lastchar)  lastchar  = code;
+      }
+    }
+    if (firstchar > lastchar) {
+      WARN("No glyphs actually used???");
+      pdf_release_obj(tmp_array);
+      tmp_array = NULL;
+    } else {
+      tfm_id = tfm_open(pdf_font_get_mapname(font), 0);
+      for (code = firstchar; code <= lastchar; code++) {
+        if (usedchars[code]) {
+          double width;
+          if (tfm_id < 0) {
+            width = hdr.scaling * hdr.widths[code];
+          } else {
+            width = 1000.0 * tfm_get_width(tfm_id, code);
+            if (fabs(width - hdr.scaling * hdr.widths[code]) > 1.0) {
+              WARN("Glyph width mismatch for TFM and font (%s)",
+                   pdf_font_get_mapname(font));
+              WARN("TFM: %g vs. Type1 font: %g", width, hdr.widths[code]);
+            }
+          }
+          pdf_add_array(tmp_array, pdf_new_number(ROUND(width, 0.1)));
+        } else {
+          pdf_add_array(tmp_array, pdf_new_number(0.0));
+        }
+      }
+    }
+  }
+  if (tmp_array) {
+    if (pdf_array_length(tmp_array) > 0) {
+      pdf_add_dict(fontdict,
+                   pdf_new_name("Widths"),  pdf_ref_obj(tmp_array));
+    }
+    pdf_release_obj(tmp_array);
+    pdf_add_dict(fontdict,
+                 pdf_new_name("FirstChar"), pdf_new_number(firstchar));
+    pdf_add_dict(fontdict,
+                 pdf_new_name("LastChar"),  pdf_new_number(lastchar));
+  }
+
+  /* write_fontfile(): the cached Name INDEX carries another subset tag */
+  {
+    card8 *name = cff_data + cff_data[2] + 3 + 2 * cff_data[cff_data[2] + 2];
+    if (name + 7 <= cff_data + hdr.fontfile_length && name[6] == '+')
+      memcpy(name, uniqueTag, 6);
+  }
+  fontfile = pdf_new_stream(STREAM_COMPRESS);
+  pdf_add_dict(descriptor,
+               pdf_new_name("FontFile3"), pdf_ref_obj (fontfile));
+  pdf_add_dict(pdf_stream_dict(fontfile),
+               pdf_new_name("Subtype"),   pdf_new_name("Type1C"));
+  pdf_add_stream (fontfile, cff_data, hdr.fontfile_length);
+  pdf_release_obj(fontfile);
+  pdf_add_dict(descriptor,
+               pdf_new_name("CharSet"),
+               pdf_new_string(charset, hdr.charset_length));
+  if (dpx_conf.verbose_level > 1)
+    MESG("[%u glyphs][%ld bytes][cached]", hdr.num_glyphs, (long) hdr.fontfile_length);
+
+  free(data);
+  return 1;
+}
+
+static void
+cache_store_font (FILE *fp, const struct cache_buffer *key, const char *usedchars)
+{
+  struct cache_buffer entry = { NULL, 0, 0 };
+
+  memcpy(cache_hdr.usedchars, usedchars, 256);
+  cache_hdr.names_length    = cache_names.length;
+  cache_hdr.charset_length  = cache_charset.length;
+  cache_hdr.fontfile_length = cache_fontfile.length;
+  cache_append(&entry, &cache_hdr, sizeof(cache_hdr));
+  cache_append(&entry, cache_names.data, cache_names.length);
+  cache_append(&entry, cache_charset.data, cache_charset.length);
+  cache_append(&entry, cache_fontfile.data, cache_fontfile.length);
+  miktex_font_cache_put(CACHE_PROGRAM, fp, key->data, key->length,
+                        entry.data, entry.length);
+  RELEASE(entry.data);
+}
+#endif
+
 int
 pdf_font_load_type1 (pdf_font *font)
 {
@@ -525,6 +792,9 @@ pdf_font_load_type1 (pdf_font *font)
   FILE         *fp;
   int           offset;
   int           code;
+#if defined(MIKTEX)
+  struct cache_buffer cache_key = { NULL, 0, 0 };
+#endif
 
   ASSERT(font);
 
@@ -549,6 +819,21 @@ pdf_font_load_type1 (pdf_font *font)
     ERROR("Type1: Could not open Type1 font: %s", ident);
   }
 
+#if defined(MIKTEX)
+  if (cache_enabled < 0)
+    cache_enabled = miktex_font_cache_enabled(CACHE_PROGRAM);
+  if (cache_enabled) {
+    cache_make_key(&cache_key, font, encoding_id);
+    if (cache_load_font(font, fp, encoding_id, &cache_key)) {
+      RELEASE(cache_key.data);
+      DPXFCLOSE(fp);
+      return 0;
+    }
+    memset(&cache_hdr, 0, sizeof(cache_hdr));
+    cache_names.length = cache_charset.length = cache_fontfile.length = 0;
+  }
+#endif
+
   GIDMap     = NULL;
   num_glyphs = 0;
 
@@ -565,7 +850,9 @@ pdf_font_load_type1 (pdf_font *font)
   if (!cffont) {
     ERROR("Could not load Type 1 font: %s", ident);
   }
+#if !defined(MIKTEX)
   DPXFCLOSE(fp);
+#endif
 
   fullname = NEW(strlen(fontname) + 8, char);
   sprintf(fullname, "%6s+%s", uniqueTag, fontname);
@@ -591,6 +878,12 @@ pdf_font_load_type1 (pdf_font *font)
       pdf_release_obj(tounicode);
       }
     }
+#if defined(MIKTEX)
+    for (code = 0; code < 256; code++) {
+      const char *glyph = usedchars[code] && enc_vec[code] ? enc_vec[code] : "";
+      cache_append(&cache_names, glyph, strlen(glyph) + 1);
+    }
+#endif
   }
 
   cff_set_name(cffont, fullname);
@@ -838,6 +1131,14 @@ pdf_font_load_type1 (pdf_font *font)
 #endif /* LIBDPX */
   if (dpx_conf.verbose_level > 1)
     MESG("[%u glyphs][%ld bytes]", num_glyphs, offset);
+#if defined(MIKTEX)
+  if (cache_enabled) {
+    cache_hdr.num_glyphs = num_glyphs;
+    cache_store_font(fp, &cache_key, usedchars);
+    RELEASE(cache_key.data);
+  }
+  DPXFCLOSE(fp);
+#endif
 
 #if !defined(LIBDPX)
   pdf_release_obj(pdfcharset);
@@ -0,0 +1,55 @@
+## compression-threads.cmake: compare serial and threaded compression -*- CMake -*-
+##
+## Copyright (C) 2026 agent
+## 
+## This file is free software; you can redistribute it and/or modify
+## it under the terms of the GNU General Public License as published
+## by the Free Software Foundation; either version 2, or (at your
+## option) any later version.
+## 
+## This file is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+## General Public License for more details.
+## 
+## You should have received a copy of the GNU General Public License
+## along with this file; if not, write to the Free Software
+## Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+## USA.
+
+## Converts streams.dvi, whose pages include a PNG image (deflated
+## with the PNG predictor) and create large and small stream objects
+## with pdf:stream specials, with and without compression threads,
+## with and without object streams.  The PDF files must be identical.
+
+cmake_minimum_required(VERSION 3.12)
+
+file(REMOVE_RECURSE ${WORK_DIR})
+
+## fixed creation date and document ID
+set(ENV{SOURCE_DATE_EPOCH} 1577836800)
+
+foreach(version 4 5)
+  foreach(threads 0 1 4)
+    set(dir ${WORK_DIR}/v${version}-t${threads})
+    file(MAKE_DIRECTORY ${dir})
+    file(COPY ${SOURCE_DIR}/streams.dvi ${SOURCE_DIR}/image.png DESTINATION ${dir})
+    execute_process(
+      COMMAND ${DVIPDFMX} -q -V ${version} --compression-threads ${threads} -o streams.pdf streams.dvi
+      WORKING_DIRECTORY ${dir}
+      RESULT_VARIABLE exit_code
+    )
+    if(NOT exit_code EQUAL 0)
+      message(FATAL_ERROR "v${version}-t${threads}: dvipdfmx failed: ${exit_code}")
+    endif()
+    if(NOT threads EQUAL 0)
+      execute_process(
+        COMMAND ${CMAKE_COMMAND} -E compare_files ${WORK_DIR}/v${version}-t0/streams.pdf ${dir}/streams.pdf
+        RESULT_VARIABLE differ
+      )
+      if(differ)
+        message(FATAL_ERROR "v${version}-t${threads}: output differs from the single-threaded one")
+      endif()
+    endif()
+  endforeach()
+endforeach()
@@ -23,6 +23,15 @@
 ************************************************************************/
 
 #include "dvipng.h"
+#if defined(MIKTEX) && defined(HAVE_FORK)
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
 
 #ifdef DEBUG
 #include <ctype.h> /* isprint */
@@ -311,6 +320,189 @@ static void DrawPage(dviunits hoffset, dviunits voffset)
   }
 }
 
+#if defined(MIKTEX)
+#if defined(HAVE_FORK)
+/* With -j, the workers leave the daemon replies here, one slot per
+   queued page in memory shared with the parent, which prints them in
+   page order once the workers are done */
+static char *reply_slots=NULL;
+static int   reply_slot=0;
+#endif
+
+static void DaemonReply(void)
+{
+#if defined(HAVE_FORK)
+  if (reply_slots != NULL) {
+    memcpy(reply_slots + (size_t)reply_slot*DAEMON_REPLY_SIZE,
+	   daemon_reply, DAEMON_REPLY_SIZE);
+    return;
+  }
+#endif
+  puts(daemon_reply);
+}
+#endif
+
+static void RenderPage(struct page_list *dvi_pos, int pagecounter,
+		       pixels x_width, pixels y_width,
+		       pixels x_offset, pixels y_offset)
+     /* The second pass over a page: draw it and write the image */
+{
+#if defined(MIKTEX)
+  bool written;
+#endif
+
+  SeekPage(dvi,dvi_pos);
+  CreateImage(x_width,y_width);
+#ifdef DEBUG
+  DEBUG_PRINT(DEBUG_DVI,("\n@%d PAGE START:\tBOP",dvi_pos->offset));
+  {
+    int i;
+    for (i=0;i<10;i++)
+      DEBUG_PRINT(DEBUG_DVI,(" %d",dvi_pos->count[i]));
+    DEBUG_PRINT(DEBUG_DVI,(" (%d)\n",dvi_pos->count[10]));
+  }
+#endif
+  page_flags &= ~PAGE_PREVIEW_BOP;
+  DrawPage(x_offset*dvi->conv*shrinkfactor,
+	   y_offset*dvi->conv*shrinkfactor);
+  if ( ! (option_flags & MODE_PICKY && page_flags & PAGE_GAVE_WARN )) {
+#if defined(MIKTEX)
+    written = WriteImage(dvi->outname,dvi_pos->count[pagecounter]);
+    if (!written)
+      exitcode=EXIT_FAILURE;
+    if (option_flags & DAEMON_MODE) {
+      if (written) {
+	size_t len = strlen(daemon_reply);
+	snprintf(daemon_reply+len, DAEMON_REPLY_SIZE-len,
+		 " depth=%d height=%d width=%d",
+		 y_width-y_offset-1, y_offset+1, x_width);
+      }
+      DaemonReply();
+    }
+#else
+    WriteImage(dvi->outname,dvi_pos->count[pagecounter]);
+#endif
+#ifdef TIMING
+    ++ndone;
+#endif
+  } else {
+    exitcode=EXIT_FAILURE;
+    Message(BE_NONQUIET,"(page not rendered)");
+    DestroyImage();
+  }
+}
+
+#if defined(MIKTEX) && defined(HAVE_FORK)
+/* Parallel rendering (-j #).  The first pass (bounding box, page
+   reports, preview-latex specials) runs for all pages in this process,
+   so that stdout and the state carried from page to page are as in a
+   serial run.  SetChar rasterizes a glyph the first time it is set,
+   also when only the bounding box is computed, so by the end of the
+   first pass every glyph of the queued pages is loaded; the workers
+   inherit them copy-on-write and never rasterize a glyph themselves.
+   The workers fork off afterwards and take the second pass of the
+   queued pages from a pipe. */
+extern bool followmode;
+
+struct page_job {
+  struct page_list *dvi_pos;
+  pixels            x_width, y_width, x_offset, y_offset;
+  uint32_t          page_flags;                /* after the first pass */
+};
+
+static struct page_job *page_jobs=NULL;
+static int              page_jobs_count=0, page_jobs_max=0;
+
+static void QueuePage(struct page_list *dvi_pos,
+		      pixels x_width, pixels y_width,
+		      pixels x_offset, pixels y_offset)
+{
+  if (page_jobs_count == page_jobs_max) {
+    page_jobs_max += 64;
+    page_jobs = realloc(page_jobs, page_jobs_max*sizeof(struct page_job));
+    if (page_jobs == NULL)
+      Fatal("cannot allocate memory for page queue");
+  }
+  page_jobs[page_jobs_count].dvi_pos = dvi_pos;
+  page_jobs[page_jobs_count].x_width = x_width;
+  page_jobs[page_jobs_count].y_width = y_width;
+  page_jobs[page_jobs_count].x_offset = x_offset;
+  page_jobs[page_jobs_count].y_offset = y_offset;
+  page_jobs[page_jobs_count].page_flags = page_flags;
+  page_jobs_count++;
+}
+
+static void RenderJob(int i, int pagecounter)
+{
+  page_flags = page_jobs[i].page_flags;
+  reply_slot = i;
+  RenderPage(page_jobs[i].dvi_pos, pagecounter,
+	     page_jobs[i].x_width, page_jobs[i].y_width,
+	     page_jobs[i].x_offset, page_jobs[i].y_offset);
+  page_flags = 0;
+}
+
+static void RenderQueuedPages(int pagecounter)
+{
+  int   jobpipe[2], i=0, nworkers=0, status;
+  pid_t pid;
+  void  (*sigpipe)(int);
+
+  fflush(stdout);
+  fflush(stderr);
+  if (page_jobs_count > 1 && option_flags & DAEMON_MODE) {
+    /* Replies written by the workers could interleave */
+    reply_slots = mmap(NULL, (size_t)page_jobs_count*DAEMON_REPLY_SIZE,
+		       PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
+    if (reply_slots == MAP_FAILED)
+      reply_slots = NULL;
+  }
+  if (page_jobs_count > 1
+      && (reply_slots != NULL || ~option_flags & DAEMON_MODE)
+      && pipe(jobpipe) == 0) {
+    while (nworkers < jobs && nworkers < page_jobs_count
+	   && (pid = fork()) >= 0) {
+      if (pid == 0) {
+	close(jobpipe[1]);
+	/* Do not share the DVI file offset with the other workers */
+	if ((dvi->filep = fopen(dvi->name,"rb")) == NULL)
+	  _exit(EXIT_FAILURE);
+	exitcode = EXIT_SUCCESS;
+	while (read(jobpipe[0], &i, sizeof(i)) == sizeof(i))
+	  RenderJob(i, pagecounter);
+	fflush(NULL);
+	_exit(exitcode);
+      }
+      nworkers++;
+    }
+    close(jobpipe[0]);
+    /* Writing an int to a pipe is atomic, so every page goes to
+       exactly one worker */
+    sigpipe = signal(SIGPIPE, SIG_IGN);
+    if (nworkers > 0)
+      for (; i < page_jobs_count; i++)
+	if (write(jobpipe[1], &i, sizeof(i)) != sizeof(i))
+	  break;
+    close(jobpipe[1]);
+    signal(SIGPIPE, sigpipe);
+    while (wait(&status) > 0)
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS)
+	exitcode=EXIT_FAILURE;
+  }
+  /* Pages that could not be handed to a worker */
+  for (; i < page_jobs_count; i++)
+    RenderJob(i, pagecounter);
+  if (reply_slots != NULL) {
+    for (i = 0; i < page_jobs_count; i++)
+      if (reply_slots[(size_t)i*DAEMON_REPLY_SIZE] != '\0')
+	puts(reply_slots + (size_t)i*DAEMON_REPLY_SIZE);
+    munmap(reply_slots, (size_t)page_jobs_count*DAEMON_REPLY_SIZE);
+    reply_slots = NULL;
+  }
+  page_jobs_count = 0;
+}
+#endif
+
 void DrawPages(void)
 {
   struct page_list *dvi_pos;
@@ -355,38 +547,23 @@ void DrawPages(void)
 	y_offset=y_offset_def;
       }
       DEBUG_PRINT(DEBUG_DVI,("\n  IMAGE:\t%dx%d",x_width,y_width));
-      SeekPage(dvi,dvi_pos);
-      CreateImage(x_width,y_width);
-#ifdef DEBUG
-      DEBUG_PRINT(DEBUG_DVI,("\n@%d PAGE START:\tBOP",dvi_pos->offset));
-      {
-	int i;
-	for (i=0;i<10;i++)
-	  DEBUG_PRINT(DEBUG_DVI,(" %d",dvi_pos->count[i]));
-	DEBUG_PRINT(DEBUG_DVI,(" (%d)\n",dvi_pos->count[10]));
-      }
-#endif
       Message(REPORT_DEPTH," depth=%d", y_width-y_offset-1);
       Message(REPORT_HEIGHT," height=%d", y_offset+1);
       Message(REPORT_WIDTH," width=%d", x_width);
-      page_flags &= ~PAGE_PREVIEW_BOP;
-      DrawPage(x_offset*dvi->conv*shrinkfactor,
-	       y_offset*dvi->conv*shrinkfactor);
-      if ( ! (option_flags & MODE_PICKY && page_flags & PAGE_GAVE_WARN )) {
-	WriteImage(dvi->outname,dvi_pos->count[pagecounter]);
-#ifdef TIMING
-	++ndone;
+#if defined(MIKTEX) && defined(HAVE_FORK)
+      if (jobs > 1 && !followmode)
+	QueuePage(dvi_pos,x_width,y_width,x_offset,y_offset);
+      else
 #endif
-      } else {
-	exitcode=EXIT_FAILURE;
-	Message(BE_NONQUIET,"(page not rendered)");
-	DestroyImage();
-      }
+      RenderPage(dvi_pos,pagecounter,x_width,y_width,x_offset,y_offset);
       Message(BE_NONQUIET,"] ");
       fflush(stdout);
       page_flags = 0;
       dvi_pos=NextPPage(dvi,dvi_pos);
     }
+#if defined(MIKTEX) && defined(HAVE_FORK)
+    RenderQueuedPages(pagecounter);
+#endif
     Message(BE_NONQUIET,"\n");
     ClearPpList();
   }
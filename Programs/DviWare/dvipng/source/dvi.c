@@ -66,12 +66,29 @@ static unsigned char fgetc_follow(FILE* fp)
   return (unsigned char)got;
 }
 
+#if defined(MIKTEX)
+/* In daemon mode, returns false (after replying) if the file is not a
+   DVI file */
+static bool DVIInit(struct dvi_data* dvi)
+#else
 static void DVIInit(struct dvi_data* dvi)
+#endif
 {
   int     k;
   unsigned char* pre;
   struct stat stat;
 
+#if defined(MIKTEX)
+  if (option_flags & DAEMON_MODE) {
+    /* Do not let DVIGetCommand() run into the end of the file */
+    fstat(fileno(dvi->filep), &stat);
+    fseek(dvi->filep,0,SEEK_SET);
+    if (stat.st_size < 15 || fgetc(dvi->filep) != PRE) {
+      DaemonError("%s is not a DVI file", dvi->name);
+      return(false);
+    }
+  }
+#endif
   fseek(dvi->filep,0,SEEK_SET);
   pre=DVIGetCommand(dvi);
   if (*pre != PRE) {
@@ -80,6 +97,13 @@ static void DVIInit(struct dvi_data* dvi)
   k = UNumRead(pre+1,1);
   DEBUG_PRINT(DEBUG_DVI,("DVI START:\tPRE %d",k));
   if (k != DVIFORMAT) {
+#if defined(MIKTEX)
+    if (option_flags & DAEMON_MODE) {
+      DaemonError("DVI format = %d, can only process DVI format %d files",
+		  k, DVIFORMAT);
+      return(false);
+    }
+#endif
     Fatal("DVI format = %d, can only process DVI format %d files",
 	  k, DVIFORMAT);
   }
@@ -104,6 +128,9 @@ static void DVIInit(struct dvi_data* dvi)
   dvi->mtime = stat.st_mtime;
   dvi->pagelistp=NULL;
   dvi->flags = 0;
+#if defined(MIKTEX)
+  return(true);
+#endif
 }
 
 struct dvi_data* DVIOpen(char* dviname,char* outname)
@@ -159,11 +186,27 @@ struct dvi_data* DVIOpen(char* dviname,char* outname)
     free(dvi->name);
     free(dvi->outname);
     free(dvi);
+#if defined(MIKTEX)
+    if (option_flags & DAEMON_MODE) {
+      DaemonError("%s: %s", dviname, strerror(errno));
+      return(NULL);
+    }
+#endif
     perror(dviname);
     exit (EXIT_FAILURE);
   }
   DEBUG_PRINT(DEBUG_DVI,("OPEN FILE\t%s", dvi->name));
+#if defined(MIKTEX)
+  if (!DVIInit(dvi)) {
+    fclose(dvi->filep);
+    free(dvi->name);
+    free(dvi->outname);
+    free(dvi);
+    return(NULL);
+  }
+#else
   DVIInit(dvi);
+#endif
   return(dvi);
 }
 
@@ -453,6 +496,10 @@ static void DelPageList(struct dvi_data* dvi)
 void DVIClose(struct dvi_data* dvi)
 {
   if (dvi!=NULL) {
+#if defined(MIKTEX)
+    /* A daemon request may have found the file gone */
+    if (dvi->filep!=NULL)
+#endif
     fclose(dvi->filep);
     DelPageList(dvi);
     ClearPSHeaders();
@@ -475,12 +522,27 @@ bool DVIReOpen(struct dvi_data* dvi)
       USLEEP(50);
     }
     if (dvi->filep == NULL) {
+#if defined(MIKTEX)
+      /* The caller closes the file */
+      if (option_flags & DAEMON_MODE) {
+	DaemonError("%s: %s", dvi->name, strerror(errno));
+	return(false);
+      }
+#endif
       perror(dvi->name);
       exit(EXIT_FAILURE);
     }
     Message(PARSE_STDIN,"Reopened file\n");
     DEBUG_PRINT(DEBUG_DVI,("\nREOPEN FILE\t%s", dvi->name));
+#if defined(MIKTEX)
+    if (!DVIInit(dvi)) {
+      fclose(dvi->filep);
+      dvi->filep=NULL;
+      return(false);
+    }
+#else
     DVIInit(dvi);
+#endif
     return(true);
   }
   return(false);
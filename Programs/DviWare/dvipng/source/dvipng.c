@@ -26,6 +26,12 @@
 
 #define MAIN
 #include "dvipng.h"
+#if defined(MIKTEX)
+#  include <time.h>
+#  ifdef HAVE_GETTIMEOFDAY
+#    include <sys/time.h>
+#  endif
+#endif
 
 #ifdef MIKTEX
 #  if defined(MIKTEX)
@@ -34,6 +40,19 @@
 #  define main __cdecl Main
 #  endif
 #endif        /* MIKTEX */
+#if defined(MIKTEX)
+static double WallClock(void)
+{
+# ifdef HAVE_GETTIMEOFDAY
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1000000.0;
+# else
+  return (double)time(NULL);
+# endif
+}
+#endif
+
 /**********************************************************************/
 /*******************************  main  *******************************/
 /**********************************************************************/
@@ -111,16 +130,48 @@ int main(int argc, char ** argv)
 
   if (parsestdin) {
     char    line[STRSIZE];
-
+#if defined(MIKTEX)
+    /* Daemon mode: one request (options and DVI file name) per line.
+       The reply is a line per image written, giving its name and
+       dimensions, and an empty line.  A request that cannot be served
+       is answered with an "error: " line.  Fonts stay loaded. */
+    bool    daemon = (option_flags & DAEMON_MODE) != 0;
+    int     requests = 0;
+    double  start = WallClock();
+
+    if (daemon)
+      setvbuf(stdout, NULL, _IOLBF, 0);
+    else
+#endif
     printf("%s> ",dvi!=NULL?dvi->name:"");
     while(fgets(line,STRSIZE,stdin)) {
       DecodeString(line);
       if (dvi!=NULL) {
 	DVIReOpen(dvi);
+#if defined(MIKTEX)
+	/* In daemon mode, a file that has gone away got an error reply */
+	if (dvi->filep==NULL) {
+	  DVIClose(dvi);
+	  dvi=NULL;
+	} else
+#endif
 	DrawPages();
       }
+#if defined(MIKTEX)
+      if (daemon) {
+	putchar('\n');
+	requests++;
+      } else
+#endif
       printf("%s> ",dvi!=NULL?dvi->name:"");
     }
+#if defined(MIKTEX)
+    if (daemon) {
+      double elapsed = WallClock() - start;
+      fprintf(stderr, "%d request(s) in %.2f s (%.1f requests/s)\n",
+	      requests, elapsed, elapsed > 0 ? requests / elapsed : 0.0);
+    } else
+#endif
     printf("\n");
   }
 
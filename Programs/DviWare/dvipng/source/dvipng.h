@@ -207,6 +207,9 @@ void    UnMmapFile(struct filemmap* fmmap);
 void    Message(int, const char *fmt, ...);
 void    Warning(const char *fmt, ...);
 void    Fatal(const char *fmt, ...);
+#if defined(MIKTEX)
+void    DaemonError(const char *fmt, ...);
+#endif
 
 int32_t   SNumRead(unsigned char*, register int);
 uint32_t   UNumRead(unsigned char*, register int);
@@ -344,7 +347,11 @@ void      CreateImage(pixels width, pixels height);
 void      DestroyImage(void);
 void      DrawCommand(unsigned char*, void* /* dvi/vf */);
 void      DrawPages(void);
+#if defined(MIKTEX)
+bool      WriteImage(char*, int);
+#else
 void      WriteImage(char*, int);
+#endif
 void      LoadPK(int32_t, register struct char_entry *);
 int32_t   SetChar(int32_t);
 dviunits  SetGlyph(struct char_entry *ptr, int32_t hh,int32_t vv);
@@ -409,6 +416,9 @@ EXTERN struct internal_state {
 #define BG_TRANSPARENT_ALPHA         (1<<17)
 #define FORCE_PALETTE                (1<<18)
 #define NO_RAW_PS                    (1<<19)
+#if defined(MIKTEX)
+#define DAEMON_MODE                  (1<<20)
+#endif
 EXTERN uint32_t option_flags INIT(BE_NONQUIET | USE_FREETYPE);
 
 #define PAGE_GAVE_WARN               1
@@ -477,6 +487,12 @@ EXTERN int    dpi                  INIT(100);
 #ifdef HAVE_GDIMAGEPNGEX
 EXTERN int   compression INIT(1);
 #endif
+#if defined(MIKTEX)
+EXTERN int   jobs INIT(1);
+/* The daemon reply line of the page being rendered */
+#define DAEMON_REPLY_SIZE (2*STRSIZE)
+EXTERN char  daemon_reply[DAEMON_REPLY_SIZE];
+#endif
 #undef min
 #undef max
 # define  max(x,y)       if ((y)>(x)) x = y
@@ -94,6 +94,11 @@ bool DecodeArgs(int argc, char ** argv)
 	      Message(PARSE_STDIN,"DVI page number output off\n");
 	    }
 	    break;
+#if defined(MIKTEX)
+	  } else if (strncmp(p,"aemon",5)==0) { /* Serve requests from stdin */
+	    option_flags |= DAEMON_MODE | PARSE_STDIN;
+	    break;
+#endif
 	  } else if (strncmp(p,"epth",4)==0) { /* Depth reporting */
 	    if (p[4] != '0') {
 	      option_flags |= REPORT_DEPTH;
@@ -455,6 +460,24 @@ bool DecodeArgs(int argc, char ** argv)
 	} else
 	  goto DEFAULT;
 	break ;
+#if defined(MIKTEX)
+      case 'j':       /* render pages in parallel */
+	if (*p == 0 && argv[i+1])
+	  p = argv[++i];
+	number = atoi(p);
+	if (number < 1)
+	  Warning("Bad number of jobs (-j) parameter, ignored");
+#ifdef HAVE_FORK
+	else {
+	  jobs=number;
+	  Message(PARSE_STDIN,"Jobs: %d\n",jobs);
+	}
+#else
+	else if (number > 1)
+	  Warning("Parallel rendering (-j) is not supported on this platform, ignored");
+#endif
+	break;
+#endif
       case 'l':
 	{
 	  int32_t lastpage;
@@ -584,7 +607,11 @@ or <http://www.gnu.org/licenses/>.");
     dvi=DVIOpen(dviname,outname);
   }
 
+#if defined(MIKTEX)
+  if (dvi==NULL && ~option_flags & DAEMON_MODE) {
+#else
   if (dvi==NULL) {
+#endif
     fprintf(stdout,"\nUsage: %s [OPTION]... FILENAME[.dvi]\n", programname);
     fprintf(stdout,"Options are chosen to be similar to dvips' options where possible:\n");
 #ifdef DEBUG
@@ -604,6 +631,9 @@ or <http://www.gnu.org/licenses/>.");
     fprintf(stdout,"  -bd #        Transparent border width in dots\n");
     fprintf(stdout,"  -bd s        Transparent border fallback color (TeX-style color)\n");
     fprintf(stdout,"  -bg s        Background color (TeX-style color or 'Transparent')\n");
+#if defined(MIKTEX)
+    fprintf(stdout,"  --daemon     Render requests read from stdin, reply on stdout\n");
+#endif
     fprintf(stdout,"  --depth*     Output the image depth on stdout\n");
     fprintf(stdout,"  --dvinum*    Use TeX page numbers in output filenames\n");
     fprintf(stdout,"  -fg s        Foreground color (TeX-style color)\n");
@@ -616,6 +646,13 @@ or <http://www.gnu.org/licenses/>.");
     fprintf(stdout,"  --gif        Output GIF images (dvigif default)\n");
 #endif
     fprintf(stdout,"  --height*    Output the image height on stdout\n");
+#if defined(MIKTEX)
+#ifdef HAVE_FORK
+    fprintf(stdout,"  -j #         Number of pages rendered in parallel\n");
+#else
+    fprintf(stdout,"  -j #         Number of pages rendered in parallel (unsupported)\n");
+#endif
+#endif
     fprintf(stdout,"  --nogs*      Don't use ghostscript for PostScript specials\n");
     fprintf(stdout,"  --nogssafer* Don't use -dSAFER in ghostscript calls\n");
     fprintf(stdout,"  --norawps*   Don't convert raw PostScript specials\n");
@@ -649,7 +686,13 @@ or <http://www.gnu.org/licenses/>.");
       exit(EXIT_SUCCESS);
     }
   }
+#if defined(MIKTEX)
+  /* A daemon request naming a DVI file renders all pages by default */
+  if (((option_flags & PARSE_STDIN) == 0
+       || (option_flags & DAEMON_MODE && dviname != NULL)) && (!ppused))
+#else
   if ((option_flags & PARSE_STDIN) == 0 && (!ppused))
+#endif
     ParsePages("-");
   return((option_flags & PARSE_STDIN) != 0);
 }
@@ -663,7 +706,11 @@ void DecodeString(char *string)
 
   while (*string==' ' || *string=='\t' || *string=='\r' || *string=='\n')
     string++;
+#if defined(MIKTEX)
+  while (*string!='\0' && strc<PARSEARGS) {
+#else
   while (*string!='\0') {
+#endif
     strv[strc++]=string;
     if (*string!='\'') {
       /* Normal split at whitespace */
@@ -728,6 +775,20 @@ void Fatal (const char *fmt, ...)
   exit(EXIT_FATAL);
 }
 
+#if defined(MIKTEX)
+/* Answer a daemon request that cannot be served, instead of exiting */
+void DaemonError(const char *fmt, ...)
+{
+  va_list args;
+
+  va_start(args, fmt);
+  fputs("error: ", stdout);
+  vfprintf(stdout, fmt, args);
+  putchar('\n');
+  va_end(args);
+}
+#endif
+
 /*-->Warning*/
 /**********************************************************************/
 /*****************************  Warning  ******************************/
@@ -757,7 +818,12 @@ void Message(int activeflags, const char *fmt, ...)
 
   va_start(args, fmt);
   if ( option_flags & activeflags ) {
+#if defined(MIKTEX)
+    /* In daemon mode, stdout carries the replies only */
+    vfprintf(option_flags & DAEMON_MODE ? stderr : stdout, fmt, args);
+#else
     vfprintf(stdout, fmt, args);
+#endif
   }
   va_end(args);
 }
@@ -96,7 +96,13 @@ static void ChangeColor(gdImagePtr imagep,int x1,int y1,
   }
 }
 
+#if defined(MIKTEX)
+/* In daemon mode, the reply is left in daemon_reply: the file name,
+   or an error if the image could not be written */
+bool WriteImage(char *pngname, int pagenum)
+#else
 void WriteImage(char *pngname, int pagenum)
+#endif
 {
   char* pos, *freeme=NULL;
   FILE* outfp=NULL;
@@ -139,6 +145,14 @@ void WriteImage(char *pngname, int pagenum)
   }
 
   if ((pos=strchr(pngname,'%')) != NULL) {
+#if defined(MIKTEX)
+    if (option_flags & DAEMON_MODE && strchr(pos+1,'%')) {
+      snprintf(daemon_reply,DAEMON_REPLY_SIZE,
+	       "error: too many %%s in output file name %s",pngname);
+      DestroyImage();
+      return(false);
+    }
+#endif
     if (strchr(++pos,'%'))
       Fatal("too many %%s in output file name");
     if (*pos == 'd'
@@ -150,6 +164,15 @@ void WriteImage(char *pngname, int pagenum)
       sprintf(freeme,pngname,pagenum);
       pngname = freeme;
     } else {
+#if defined(MIKTEX)
+      if (option_flags & DAEMON_MODE) {
+	snprintf(daemon_reply,DAEMON_REPLY_SIZE,
+		 "error: unacceptable format spec in output file name %s",
+		 pngname);
+	DestroyImage();
+	return(false);
+      }
+#endif
       Fatal("unacceptible format spec in output file name");
     }
   }
@@ -161,8 +184,19 @@ void WriteImage(char *pngname, int pagenum)
     *(pos+3)='f';
   }
 #endif
-  if ((outfp = fopen(pngname,"wb")) == NULL)
+  if ((outfp = fopen(pngname,"wb")) == NULL) {
+#if defined(MIKTEX)
+    if (option_flags & DAEMON_MODE) {
+      snprintf(daemon_reply,DAEMON_REPLY_SIZE,
+	       "error: cannot open output file %s",pngname);
+      if (freeme)
+	free(freeme);
+      DestroyImage();
+      return(false);
+    }
+#endif
       Fatal("cannot open output file %s",pngname);
+  }
 #ifdef HAVE_GDIMAGEGIF
   if (option_flags & GIF_OUTPUT)
     gdImageGif(page_imagep,outfp);
@@ -170,10 +204,18 @@ void WriteImage(char *pngname, int pagenum)
 #endif
     gdImagePngEx(page_imagep,outfp,compression);
   fclose(outfp);
+#if defined(MIKTEX)
+  /* RenderPage() completes the reply */
+  if (option_flags & DAEMON_MODE)
+    snprintf(daemon_reply,DAEMON_REPLY_SIZE,"%s",pngname);
+#endif
   DEBUG_PRINT(DEBUG_DVI,("\n  WROTE:   \t%s\n",pngname));
   if (freeme)
     free(freeme);
   DestroyImage();
+#if defined(MIKTEX)
+  return(true);
+#endif
 }
 
 void DestroyImage(void)
@@ -0,0 +1,112 @@
+## daemon.cmake: test the --daemon request/reply protocol  -*- CMake -*-
+##
+## Copyright (C) 2026 agent
+## 
+## This file is free software; you can redistribute it and/or modify
+## it under the terms of the GNU General Public License as published
+## by the Free Software Foundation; either version 2, or (at your
+## option) any later version.
+## 
+## This file is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+## General Public License for more details.
+## 
+## You should have received a copy of the GNU General Public License
+## along with this file; if not, write to the Free Software
+## Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+## USA.
+
+## Sends a series of requests to dvipng --daemon, once serially and
+## once with four jobs: pages.dvi, a missing file, a file that is not
+## DVI, two output names that cannot be written, and pages.dvi again.
+## Every request must get its reply, in page order, and the daemon
+## must keep serving after the bad ones.  The images must be identical
+## to those of a one-shot run.
+
+cmake_minimum_required(VERSION 3.12)
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+execute_process(
+  COMMAND ${DVIPNG} -q -D 150 -T tight -o oneshot-%d.png ${SOURCE_DIR}/pages.dvi
+  WORKING_DIRECTORY ${WORK_DIR}
+  OUTPUT_QUIET
+  RESULT_VARIABLE exit_code
+)
+if(NOT exit_code EQUAL 0)
+  message(FATAL_ERROR "one-shot run failed: ${exit_code}")
+endif()
+
+file(WRITE ${WORK_DIR}/requests.txt
+  "-o first-%d.png pages.dvi\n"
+  "missing.dvi\n"
+  "notdvi.dvi\n"
+  "-o bad-%s.png pages.dvi\n"
+  "-o nodir/bad-%d.png pages.dvi\n"
+  "-o again-%d.png pages.dvi\n"
+)
+
+## the expected replies, as a regular expression
+set(dimensions "depth=[0-9]+ height=[0-9]+ width=[0-9]+")
+set(expected "^")
+foreach(page RANGE 1 8)
+  string(APPEND expected "first-${page}\\.png ${dimensions}\n")
+endforeach()
+string(APPEND expected "\n")
+string(APPEND expected "error: missing\\.dvi: [^\n]+\n\n")
+string(APPEND expected "error: notdvi\\.dvi is not a DVI file\n\n")
+foreach(page RANGE 1 8)
+  string(APPEND expected "error: unacceptable format spec in output file name bad-%s\\.png\n")
+endforeach()
+string(APPEND expected "\n")
+foreach(page RANGE 1 8)
+  string(APPEND expected "error: cannot open output file nodir/bad-${page}\\.png\n")
+endforeach()
+string(APPEND expected "\n")
+foreach(page RANGE 1 8)
+  string(APPEND expected "again-${page}\\.png ${dimensions}\n")
+endforeach()
+string(APPEND expected "\n$")
+
+foreach(run serial parallel)
+  if(run STREQUAL "serial")
+    set(jobs 1)
+  else()
+    set(jobs 4)
+  endif()
+  set(dir ${WORK_DIR}/${run})
+  file(MAKE_DIRECTORY ${dir})
+  file(COPY ${SOURCE_DIR}/pages.dvi DESTINATION ${dir})
+  file(WRITE ${dir}/notdvi.dvi "This is not a DVI file.\n")
+  execute_process(
+    COMMAND ${DVIPNG} --daemon -q -D 150 -T tight -j ${jobs}
+    WORKING_DIRECTORY ${dir}
+    INPUT_FILE ${WORK_DIR}/requests.txt
+    OUTPUT_VARIABLE output_${run}
+    ERROR_VARIABLE errors
+    RESULT_VARIABLE exit_code
+  )
+  if(NOT output_${run} MATCHES "${expected}")
+    message(FATAL_ERROR "${run}: unexpected replies (exit code ${exit_code}):\n${output_${run}}\n--\n${errors}")
+  endif()
+  if(NOT errors MATCHES "6 request\\(s\\) in [0-9.]+ s")
+    message(FATAL_ERROR "${run}: no request count:\n${errors}")
+  endif()
+  foreach(page RANGE 1 8)
+    foreach(prefix first again)
+      execute_process(
+        COMMAND ${CMAKE_COMMAND} -E compare_files ${WORK_DIR}/oneshot-${page}.png ${dir}/${prefix}-${page}.png
+        RESULT_VARIABLE differ
+      )
+      if(differ)
+        message(FATAL_ERROR "${run}: ${prefix}-${page}.png differs from the one-shot run")
+      endif()
+    endforeach()
+  endforeach()
+endforeach()
+
+if(NOT output_serial STREQUAL output_parallel)
+  message(FATAL_ERROR "replies differ:\n${output_serial}\n--\n${output_parallel}")
+endif()
@@ -0,0 +1,62 @@
+## parallel.cmake: compare serial and parallel rendering  -*- CMake -*-
+##
+## Copyright (C) 2026 agent
+## 
+## This file is free software; you can redistribute it and/or modify
+## it under the terms of the GNU General Public License as published
+## by the Free Software Foundation; either version 2, or (at your
+## option) any later version.
+## 
+## This file is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+## General Public License for more details.
+## 
+## You should have received a copy of the GNU General Public License
+## along with this file; if not, write to the Free Software
+## Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+## USA.
+
+## Renders pages.dvi (eight pages of cmr10 text and rules) once
+## serially and once with four jobs.  The reports written to stdout
+## and every PNG file must be identical.
+
+cmake_minimum_required(VERSION 3.12)
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+foreach(run serial parallel)
+  if(run STREQUAL "serial")
+    set(jobs 1)
+  else()
+    set(jobs 4)
+  endif()
+  execute_process(
+    COMMAND ${DVIPNG} -q -D 150 -T tight --depth --height -j ${jobs} -o ${run}-%d.png ${SOURCE_DIR}/pages.dvi
+    WORKING_DIRECTORY ${WORK_DIR}
+    OUTPUT_VARIABLE output_${run}
+    RESULT_VARIABLE exit_code
+  )
+  if(NOT exit_code EQUAL 0)
+    message(FATAL_ERROR "${run} run failed: ${exit_code}")
+  endif()
+endforeach()
+
+if(NOT output_serial STREQUAL output_parallel)
+  message(FATAL_ERROR "reports differ:\n${output_serial}\n--\n${output_parallel}")
+endif()
+
+foreach(page RANGE 1 8)
+  if(NOT EXISTS ${WORK_DIR}/parallel-${page}.png)
+    message(FATAL_ERROR "page ${page} was not rendered in parallel")
+  endif()
+  execute_process(
+    COMMAND ${CMAKE_COMMAND} -E compare_files serial-${page}.png parallel-${page}.png
+    WORKING_DIRECTORY ${WORK_DIR}
+    RESULT_VARIABLE differ
+  )
+  if(differ)
+    message(FATAL_ERROR "page ${page} differs")
+  endif()
+endforeach()
@@ -15,6 +15,9 @@
  *   The external declarations:
  */
 #include "protos.h"
+#if defined(MIKTEX)
+#include <miktex/fontcache.h>
+#endif
 
 static unsigned char dummyend[8] = { 252 };
 
@@ -430,6 +433,58 @@ static void addGlyph(const char *glyphName) {
 }
 #endif
 
+#if defined(MIKTEX) && defined(DOWNLOAD_USING_PDFTEX)
+/*
+ *   The subset written by t1_subset_2 depends on nothing but the font
+ *   file, the used codes and the extra glyph names, so it can be reused
+ *   by later runs.  On a miss, the subset is written to a temporary
+ *   file first.
+ */
+static boolean
+t1_subset_cached(char *fontfile, unsigned char *g, char *extraGlyphs)
+{
+   FILE *f, *tmp, *saved;
+   char *key, *data;
+   size_t keysize, size;
+   const char *extra = extraGlyphs ? extraGlyphs : "";
+
+   if (!miktex_font_cache_enabled("dvips")
+       || (f = search(type1path, fontfile, FOPEN_RBIN_MODE)) == NULL)
+      return t1_subset_2(fontfile, g, extraGlyphs);
+   keysize = strlen(fontfile) + 1 + 256 + strlen(extra) + 1;
+   key = mymalloc((int)keysize);
+   strcpy(key, fontfile);
+   memcpy(key + strlen(fontfile) + 1, g, 256);
+   strcpy(key + strlen(fontfile) + 1 + 256, extra);
+   data = (char *)miktex_font_cache_get("dvips", f, key, keysize, &size);
+   if (data == NULL && (tmp = tmpfile()) != NULL) {
+      saved = bitfile;
+      bitfile = tmp;
+      t1_subset_2(fontfile, g, extraGlyphs);
+      bitfile = saved;
+      size = ftell(tmp);
+      rewind(tmp);
+      data = (char *)malloc(size > 0 ? size : 1);
+      if (data != NULL && fread(data, 1, size, tmp) != size) {
+         free(data);
+         data = NULL;
+      }
+      if (data != NULL)
+         miktex_font_cache_put("dvips", f, key, keysize, data, size);
+      fclose(tmp);
+   }
+   if (data == NULL) {
+      t1_subset_2(fontfile, g, extraGlyphs);
+   } else {
+      fwrite(data, 1, size, bitfile);
+      free(data);
+   }
+   free(key);
+   fclose(f);
+   return 1;
+}
+#endif
+
 /*
  *   Download a PostScript font, using partial font downloading if
  *   necessary.
@@ -527,7 +582,11 @@ downpsfont(charusetype *p, charusetype *all)
         if (! disablecomments)
            fprintf(bitfile, "%%%%BeginFont: %s\n",  rf->PSname);
 #ifdef DOWNLOAD_USING_PDFTEX
+#if defined(MIKTEX)
+        if (!t1_subset_cached(rf->Fontfile, grid, extraGlyphs))
+#else
         if (!t1_subset_2(rf->Fontfile, grid, extraGlyphs))
+#endif
 #else
         if(FontPart(bitfile, rf->Fontfile, rf->Vectfile) < 0)
 #endif
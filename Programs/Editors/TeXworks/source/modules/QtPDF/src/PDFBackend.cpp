@@ -139,6 +139,185 @@ QString PDFFontDescriptor::pureName() const
 // Backend Rendering
 // =================
 
+#if defined(MIKTEX)
+PDFPageProcessingThread::~PDFPageProcessingThread()
+{
+  _mutex.lock();
+  _quit = true;
+  _waitCondition.wakeAll();
+  _mutex.unlock();
+  foreach(Worker * worker, _workers) {
+    worker->wait();
+    delete worker;
+  }
+}
+
+//static
+int PDFPageProcessingThread::maxWorkerCount()
+{
+  // Backends may keep a renderer per worker thread, so don't spawn too many
+  // workers on machines with lots of cores
+  return qBound(1, QThread::idealThreadCount(), 4);
+}
+
+void PDFPageProcessingThread::addPageProcessingRequest(PageProcessingRequest * request)
+{
+  if (!request)
+    return;
+
+  // `request` must live in the main (GUI) thread, or else destroying it later
+  // on will fail
+  Q_ASSERT(request->thread() == QApplication::instance()->thread());
+
+  QMutexLocker locker(&(this->_mutex));
+
+  // If the same request is still pending (e.g., a prefetched tile that has
+  // been scrolled into view in the meantime), don't process it twice; instead,
+  // move the pending request to the top of the work stack of the higher of
+  // both priorities
+  bool merged = false;
+  for (int p = 0; p < PageProcessingRequest::Priority_Count && !merged; ++p) {
+    QStack<PageProcessingRequest*> & ws = _workStack[p];
+    for (int i = ws.size() - 1; i >= 0; --i) {
+      if (ws[i]->listener != request->listener || !(*(ws[i]) == *request))
+        continue;
+      PageProcessingRequest * pending = ws[i];
+      ws.remove(i);
+      pending->priority = qMax(pending->priority, request->priority);
+      // `request` has not been seen by any other thread yet, so we can safely
+      // delete it directly
+      delete request;
+      request = pending;
+      merged = true;
+      break;
+    }
+  }
+
+  _workStack[request->priority].push(request);
+#ifdef DEBUG
+  qDebug() << "new request:" << *request;
+#endif
+
+  int pending = 0;
+  for (int p = 0; p < PageProcessingRequest::Priority_Count; ++p)
+    pending += _workStack[p].size();
+  if (pending > _workers.size() - _busyWorkers && _workers.size() < maxWorkerCount()) {
+    Worker * worker = new Worker(this);
+    _workers << worker;
+    ++_busyWorkers;
+    worker->start();
+  }
+  else
+    _waitCondition.wakeOne();
+}
+
+PageProcessingRequest * PDFPageProcessingThread::takeRequest()
+{
+  // _mutex must be locked
+  for (int p = PageProcessingRequest::Priority_Count - 1; p >= 0; --p) {
+    if (!_workStack[p].empty())
+      return _workStack[p].pop();
+  }
+  return nullptr;
+}
+
+void PDFPageProcessingThread::work()
+{
+  PageProcessingRequest * workItem;
+
+  _mutex.lock();
+  while (!_quit) {
+    // mutex must be locked at start of loop
+    workItem = takeRequest();
+    if (workItem) {
+      _mutex.unlock();
+
+#ifdef DEBUG
+      qDebug() << "processing work item" << *workItem;
+      QTime renderTimer;
+      renderTimer.start();
+#endif
+      workItem->execute();
+#ifdef DEBUG
+      QString jobDesc;
+      switch (workItem->type()) {
+        case PageProcessingRequest::LoadLinks:
+          jobDesc = QString::fromUtf8("loading links");
+          break;
+        case PageProcessingRequest::PageRendering:
+          jobDesc = QString::fromUtf8("rendering page");
+          break;
+      }
+      qDebug() << "finished " << jobDesc << "for page" << workItem->page->pageNum() << ". Time elapsed: " << renderTimer.elapsed() << " ms.";
+#endif
+
+      // Delete the work item as it has fulfilled its purpose
+      // Note that we can't delete it here or we might risk that some emitted
+      // signals are invalidated; to ensure they reach their destination, we
+      // need to call deleteLater().
+      // Note: workItem *must* live in the main (GUI) thread for this!
+      Q_ASSERT(workItem->thread() == QApplication::instance()->thread());
+      workItem->deleteLater();
+
+      _mutex.lock();
+    }
+    else {
+      --_busyWorkers;
+      if (_busyWorkers == 0)
+        _idleCondition.wakeAll();
+      _waitCondition.wait(&_mutex);
+      ++_busyWorkers;
+    }
+  }
+  --_busyWorkers;
+  _mutex.unlock();
+}
+
+void PDFPageProcessingThread::clearWorkStack()
+{
+  _mutex.lock();
+
+  for (int p = 0; p < PageProcessingRequest::Priority_Count; ++p) {
+    foreach(PageProcessingRequest * workItem, _workStack[p]) {
+      Q_ASSERT(workItem->thread() == QApplication::instance()->thread());
+      workItem->deleteLater();
+    }
+    _workStack[p].clear();
+  }
+
+  // Wait until the current operations finish
+  while (_busyWorkers > 0 && !_quit)
+    _idleCondition.wait(&_mutex);
+  _mutex.unlock();
+}
+
+void PDFPageProcessingThread::cancelRenderRequests(const QSet<QObject*> & listeners)
+{
+  if (listeners.isEmpty())
+    return;
+
+  QList<PageProcessingRenderPageRequest*> cancelled;
+  _mutex.lock();
+  for (int p = 0; p < PageProcessingRequest::Priority_Count; ++p) {
+    QStack<PageProcessingRequest*> & ws = _workStack[p];
+    for (int i = ws.size() - 1; i >= 0; --i) {
+      if (ws[i]->type() != PageProcessingRequest::PageRendering || !listeners.contains(ws[i]->listener))
+        continue;
+      cancelled << static_cast<PageProcessingRenderPageRequest*>(ws[i]);
+      ws.remove(i);
+    }
+  }
+  _mutex.unlock();
+
+  // Note: cancel() acquires the doc-lock and the page-lock, so we must not
+  // hold _mutex here (addPageProcessingRequest() is called with those locks
+  // held)
+  foreach(PageProcessingRenderPageRequest * request, cancelled) {
+    request->cancel();
+    request->deleteLater();
+  }
+}
+#else
 PDFPageProcessingThread::~PDFPageProcessingThread()
 {
   _mutex.lock();
@@ -266,6 +445,7 @@ void PDFPageProcessingThread::clearWorkStack()
   }
   _mutex.unlock();
 }
+#endif
 
 
 // Asynchronous Page Operations
@@ -320,6 +500,15 @@ bool PageProcessingRenderPageRequest::execute()
   return true;
 }
 
+#if defined(MIKTEX)
+void PageProcessingRenderPageRequest::cancel()
+{
+  // Don't leave a placeholder in the cache that would never be replaced
+  if (cache)
+    page->cancelPlaceholder(xres, yres, render_box);
+}
+#endif
+
 bool PageProcessingLoadLinksRequest::execute()
 {
   QCoreApplication::postEvent(listener, new PDFLinksLoadedEvent(page->loadLinks()));
@@ -387,7 +576,13 @@ inline uint qHash(const PDFPageTile &tile)
 
 QSharedPointer<QImage> PDFPageCache::getImage(const PDFPageTile & tile) const
 {
+#if defined(MIKTEX)
+  // QCache::object() moves the item to the front of the LRU list, so this is
+  // a write access
+  _lock.lockForWrite();
+#else
   _lock.lockForRead();
+#endif
   QSharedPointer<QImage> * retVal = object(tile);
   _lock.unlock();
   if (retVal)
@@ -449,6 +644,26 @@ void PDFPageCache::markOutdated()
     it.value() = OUTDATED;
 }
 
+#if defined(MIKTEX)
+void PDFPageCache::markOutdated(const QSet<int> & pages)
+{
+  QWriteLocker l(&_lock);
+  QMap<PDFPageTile, TileStatus>::iterator it;
+  for (it = _tileStatus.begin(); it != _tileStatus.end(); ++it) {
+    if (pages.contains(it.key().page_num))
+      it.value() = OUTDATED;
+  }
+}
+
+void PDFPageCache::cancelPlaceholder(const PDFPageTile & tile)
+{
+  QWriteLocker l(&_lock);
+  QMap<PDFPageTile, TileStatus>::iterator it = _tileStatus.find(tile);
+  if (it != _tileStatus.end() && it.value() == PLACEHOLDER)
+    it.value() = OUTDATED;
+}
+#endif
+
 
 // PDF ABCs
 // ========
@@ -539,6 +754,30 @@ void Document::clearPages()
   _pages.clear();
 }
 
+#if defined(MIKTEX)
+QSet<int> Document::updatePageFingerprints(const QVector<QByteArray> & fingerprints)
+{
+  QWriteLocker docLocker(_docLock.data());
+  QSet<int> changedPages;
+  if (!_pageFingerprints.isEmpty()) {
+    for (int i = 0; i < qMax(qMax(fingerprints.size(), _pageFingerprints.size()), _numPages); ++i) {
+      if (i >= fingerprints.size() || i >= _pageFingerprints.size() || fingerprints[i].isEmpty() || fingerprints[i] != _pageFingerprints[i])
+        changedPages << i;
+    }
+    _pageCache.markOutdated(changedPages);
+  }
+  _pageFingerprints = fingerprints;
+  return changedPages;
+}
+
+void Document::invalidatePageFingerprints()
+{
+  QWriteLocker docLocker(_docLock.data());
+  _pageCache.markOutdated();
+  _pageFingerprints.clear();
+}
+#endif
+
 void Document::clearMetaData()
 {
   QWriteLocker docLocker(_docLock.data());
@@ -667,6 +906,39 @@ QSharedPointer<QImage> Page::getCachedImage(double xres, double yres, QRect rend
   return _parent->pageCache().getImage(tile);
 }
 
+#if defined(MIKTEX)
+void Page::asyncRenderToImage(QObject *listener, double xres, double yres, QRect render_box, bool cache, PageProcessingRequest::Priority priority)
+{
+  QReadLocker docLocker(_docLock.data());
+  QReadLocker pageLocker(_pageLock);
+  if (!_parent)
+    return;
+  PageProcessingRequest * request = new PageProcessingRenderPageRequest(this, listener, xres, yres, render_box, cache);
+  request->priority = priority;
+  _parent->processingThread().addPageProcessingRequest(request);
+}
+
+void Page::cancelPlaceholder(double xres, double yres, QRect render_box)
+{
+  QReadLocker docLocker(_docLock.data());
+  QReadLocker pageLocker(_pageLock);
+  if (!_parent)
+    return;
+  _parent->pageCache().cancelPlaceholder(PDFPageTile(xres, yres, render_box, _n));
+}
+
+void Page::prefetchTileImage(QObject * listener, const double xres, const double yres, QRect render_box)
+{
+  QReadLocker docLocker(_docLock.data());
+  QReadLocker pageLocker(_pageLock);
+  if (!_parent || !listener)
+    return;
+  PDFPageCache::TileStatus status = _parent->pageCache().getStatus(PDFPageTile(xres, yres, render_box, _n));
+  if (status == PDFPageCache::CURRENT || status == PDFPageCache::PLACEHOLDER)
+    return;
+  asyncRenderToImage(listener, xres, yres, render_box, true, PageProcessingRequest::Priority_Prefetch);
+}
+#else
 void Page::asyncRenderToImage(QObject *listener, double xres, double yres, QRect render_box, bool cache)
 {
   QReadLocker docLocker(_docLock.data());
@@ -675,6 +947,7 @@ void Page::asyncRenderToImage(QObject *listener, double xres, double yres, QRect
     return;
   _parent->processingThread().addPageProcessingRequest(new PageProcessingRenderPageRequest(this, listener, xres, yres, render_box, cache));
 }
+#endif
 
 bool higherResolutionThan(const PDFPageTile & t1, const PDFPageTile & t2)
 {
@@ -706,7 +979,11 @@ QSharedPointer<QImage> Page::getTileImage(QObject * listener, const double xres,
     // Note: Start the rendering in the background before constructing the image
     // to take advantage of multi-core CPUs. Since we hold the write lock here
     // there's nothing to worry about
+#if defined(MIKTEX)
+    asyncRenderToImage(listener, xres, yres, render_box, true, PageProcessingRequest::Priority_Visible);
+#else
     asyncRenderToImage(listener, xres, yres, render_box, true);
+#endif
 
     if (retVal && status == PDFPageCache::OUTDATED) {
       // If we have an outdated image, use that as a placeholder
@@ -30,7 +30,13 @@
 #include <QWaitCondition>
 #include <QEvent>
 #include <QMap>
+#if defined(MIKTEX)
+#include <QSet>
+#endif
 #include <QWeakPointer>
+#if defined(MIKTEX)
+#include <QFuture>
+#endif
 
 namespace QtPDF {
 
@@ -176,7 +182,25 @@ public:
 
   bool operator <(const PDFPageTile &other) const
   {
+#if defined(MIKTEX)
+    // Tiles whose hashes collide must not be considered equivalent (or else
+    // they would share their status in PDFPageCache)
+    if (page_num != other.page_num)
+      return page_num < other.page_num;
+    if (xres != other.xres)
+      return xres < other.xres;
+    if (yres != other.yres)
+      return yres < other.yres;
+    if (render_box.y() != other.render_box.y())
+      return render_box.y() < other.render_box.y();
+    if (render_box.x() != other.render_box.x())
+      return render_box.x() < other.render_box.x();
+    if (render_box.width() != other.render_box.width())
+      return render_box.width() < other.render_box.width();
+    return render_box.height() < other.render_box.height();
+#else
     return qHash(*this) < qHash(other);
+#endif
   }
 
 #ifdef DEBUG
@@ -213,8 +237,18 @@ public:
   void clear() { QWriteLocker l(&_lock); Super::clear(); _tileStatus.clear(); }
   // Mark all tiles outdated
   void markOutdated();
+#if defined(MIKTEX)
+  // Mark all tiles of the given pages outdated
+  void markOutdated(const QSet<int> & pages);
+  // Mark the tile outdated if it is a placeholder; used when the rendering
+  // that was supposed to replace the placeholder has been cancelled
+  void cancelPlaceholder(const PDFPageTile & tile);
+
+  QList<PDFPageTile> tiles() const { QReadLocker l(&_lock); return keys(); }
+#else
 
   QList<PDFPageTile> tiles() const { return keys(); }
+#endif
 protected:
   mutable QReadWriteLock _lock;
   // Map to keep track of the current status of tiles; note that the status
@@ -237,12 +271,20 @@ protected:
 
 public:
   enum Type { PageRendering, LoadLinks };
+#if defined(MIKTEX)
+  // Requests of higher priority are processed first; among requests of the
+  // same priority, the most recent one is processed first
+  enum Priority { Priority_Prefetch, Priority_Normal, Priority_Visible, Priority_Count };
+#endif
 
   ~PageProcessingRequest() override = default;
   virtual Type type() const = 0;
 
   Page *page;
   QObject *listener;
+#if defined(MIKTEX)
+  Priority priority{Priority_Normal};
+#endif
   
   virtual bool operator==(const PageProcessingRequest & r) const;
 #ifdef DEBUG
@@ -271,6 +313,10 @@ public:
 
 protected:
   bool execute() override;
+#if defined(MIKTEX)
+  // Called instead of execute() if the request is dropped from the queue
+  void cancel();
+#endif
 
   double xres, yres;
   QRect render_box;
@@ -339,7 +385,14 @@ public:
 // The `PDFPageProcessingThread` is a thread that processes background jobs.
 // Each job is represented by a subclass of `PageProcessingRequest` and
 // contains an `execute` method that performs the actual work.
+#if defined(MIKTEX)
+// Jobs are processed by a pool of worker threads. Jobs are picked by priority
+// (see `PageProcessingRequest::Priority`) and, within a priority, most recent
+// first.
+class PDFPageProcessingThread : public QObject
+#else
 class PDFPageProcessingThread : public QThread
+#endif
 {
   Q_OBJECT
 
@@ -361,6 +414,38 @@ public:
   // finish. However, that lock is held by the caller of clearWorkStack().
   void clearWorkStack();
 
+#if defined(MIKTEX)
+  // drop all pending render requests of the given listeners (e.g., pages that
+  // have been scrolled out of view); requests that are being processed
+  // already are not affected
+  void cancelRenderRequests(const QSet<QObject*> & listeners);
+
+  // the maximum number of worker threads
+  static int maxWorkerCount();
+
+private:
+  class Worker : public QThread
+  {
+  public:
+    explicit Worker(PDFPageProcessingThread * pool) : _pool(pool) { }
+  protected:
+    void run() override { _pool->work(); }
+  private:
+    PDFPageProcessingThread * _pool;
+  };
+
+  void work();
+  PageProcessingRequest * takeRequest();
+
+  QStack<PageProcessingRequest*> _workStack[PageProcessingRequest::Priority_Count];
+  QList<Worker*> _workers;
+  // number of workers that are not waiting for requests
+  int _busyWorkers{0};
+  QMutex _mutex;
+  QWaitCondition _waitCondition;
+  QWaitCondition _idleCondition;
+  bool _quit{false};
+#else
 protected:
   void run() override;
 
@@ -373,6 +458,9 @@ private:
   bool _quit{false};
 #ifdef DEBUG
   QTime _renderTimer;
+#endif
+#endif
+#ifdef DEBUG
   static void dumpWorkStack(const QStack<PageProcessingRequest*> & ws);
 #endif
 
@@ -533,6 +621,26 @@ public:
   //   - See TODO list in `Page::search`
   virtual QList<SearchResult> search(const QString & searchText, const SearchFlags & flags, const int startPage = 0);
 
+#if defined(MIKTEX)
+  // Computes a fingerprint for each page in the background. A fingerprint
+  // changes whenever the rendering of the page may change. An empty
+  // fingerprint (or an empty list) means that the backend can't tell.
+  // Uses doc-read-lock (but the computation itself doesn't).
+  virtual QFuture< QVector<QByteArray> > pageFingerprints() const { return QFuture< QVector<QByteArray> >(); }
+  // Marks the cached tiles of all pages whose fingerprint changed since the
+  // last call outdated, records the new fingerprints, and returns the pages
+  // concerned. Callers pass the result of pageFingerprints() after
+  // (re)loading the document. Without fingerprints to compare with, the new
+  // ones are only recorded.
+  // Uses doc-write-lock.
+  QSet<int> updatePageFingerprints(const QVector<QByteArray> & fingerprints);
+  // Marks all cached tiles outdated and forgets the recorded fingerprints.
+  // Uses doc-write-lock.
+  void invalidatePageFingerprints();
+  // Uses doc-read-lock.
+  bool hasPageFingerprints() const { QReadLocker docLocker(_docLock.data()); return !_pageFingerprints.isEmpty(); }
+#endif
+
 protected:
   void clearPages();
   virtual void clearMetaData();
@@ -558,12 +666,18 @@ protected:
   TrappedState _meta_trapped{Trapped_Unknown};
   QMap<QString, QString> _meta_other;
   QSharedPointer<QReadWriteLock> _docLock{new QReadWriteLock(QReadWriteLock::Recursive)};
+#if defined(MIKTEX)
+  QVector<QByteArray> _pageFingerprints;
+#endif
 };
 
 // This class is thread-safe. See implementation for internals.
 class Page
 {
   friend class Document;
+#if defined(MIKTEX)
+  friend class PageProcessingRenderPageRequest;
+#endif
 
 protected:
   Document *_parent{nullptr};
@@ -583,7 +697,14 @@ protected:
   QSharedPointer<QImage> getCachedImage(double xres, double yres, QRect render_box = QRect(), PDFPageCache::TileStatus * status = nullptr);
 
   // Uses doc-read-lock and page-read-lock.
+#if defined(MIKTEX)
+  virtual void asyncRenderToImage(QObject *listener, double xres, double yres, QRect render_box = QRect(), bool cache = false, PageProcessingRequest::Priority priority = PageProcessingRequest::Priority_Normal);
+
+  // Uses doc-read-lock and page-read-lock.
+  void cancelPlaceholder(double xres, double yres, QRect render_box);
+#else
   virtual void asyncRenderToImage(QObject *listener, double xres, double yres, QRect render_box = QRect(), bool cache = false);
+#endif
 
 public:
   // Class to encapsulate boxes, e.g., for selecting
@@ -637,6 +758,13 @@ public:
   // the result.
   // Uses page-read-lock and doc-read-lock.
   QSharedPointer<QImage> getTileImage(QObject * listener, const double xres, const double yres, QRect render_box = QRect());
+#if defined(MIKTEX)
+  // Triggers a low-priority render request for a tile that is not cached
+  // yet, e.g., one that is likely to be scrolled into view next. No
+  // placeholder is added to the cache.
+  // Uses page-read-lock and doc-read-lock.
+  void prefetchTileImage(QObject * listener, const double xres, const double yres, QRect render_box);
+#endif
 
   virtual QList< QSharedPointer<Annotation::AbstractAnnotation> > loadAnnotations() { return QList< QSharedPointer<Annotation::AbstractAnnotation> >(); }
 
@@ -1289,6 +1289,9 @@ void PDFDocumentView::reinitializeFromScene()
     _lastPage = -1;
     _currentPage = -1;
   }
+#if defined(MIKTEX)
+  _firstVisiblePage = _lastVisiblePage = -1;
+#endif
   // Ensure the text selection marker is reset (if any) as it holds pointers to
   // page items (highlight path, boxes) that are now changed and/or destroyed.
   DocumentTool::Select * selectTool = dynamic_cast<DocumentTool::Select*>(getToolByType(DocumentTool::AbstractTool::Tool_Select));
@@ -1364,6 +1367,37 @@ void PDFDocumentView::paintEvent(QPaintEvent *event)
       _currentPage = nextCurrentPage;
       emit changedPage(_currentPage);
     }
+
+#if defined(MIKTEX)
+    // Drop pending render requests for pages that have been scrolled out of
+    // view (or hidden) since they were requested; they would only delay the
+    // tiles that are actually visible. This only needs to be done when the
+    // range of visible pages changes, not on every repaint.
+    QSharedPointer<Backend::Document> doc(_pdf_scene->document().toStrongRef());
+    if (doc) {
+      int firstVisiblePage = -1, lastVisiblePage = -1;
+      foreach(QGraphicsItem * item, _pdf_scene->pages(mapToScene(viewport()->rect()))) {
+        int pageNum = _pdf_scene->pageNumFor(static_cast<PDFPageGraphicsItem*>(item));
+        if (firstVisiblePage < 0 || pageNum < firstVisiblePage)
+          firstVisiblePage = pageNum;
+        if (pageNum > lastVisiblePage)
+          lastVisiblePage = pageNum;
+      }
+      if (firstVisiblePage != _firstVisiblePage || lastVisiblePage != _lastVisiblePage) {
+        _firstVisiblePage = firstVisiblePage;
+        _lastVisiblePage = lastVisiblePage;
+        QRectF viewRect = mapToScene(viewport()->rect()).boundingRect();
+        QSet<QObject*> offscreenPages;
+        foreach(QGraphicsItem * item, _pdf_scene->pages()) {
+          if (item->type() != PDFPageGraphicsItem::Type)
+            continue;
+          if (!item->isVisible() || !item->sceneBoundingRect().intersects(viewRect))
+            offscreenPages << static_cast<PDFPageGraphicsItem*>(item);
+        }
+        doc->processingThread().cancelRenderRequests(offscreenPages);
+      }
+    }
+#endif
   }
 
   if (_armedTool)
@@ -1822,6 +1856,9 @@ PDFDocumentScene::PDFDocumentScene(QSharedPointer<Backend::Document> a_doc, QObj
   _dpiY = (dpiY > 0 ? dpiY : QApplication::desktop()->physicalDpiY());
 
   connect(&_pageLayout, SIGNAL(layoutChanged(const QRectF)), this, SLOT(pageLayoutChanged(const QRectF)));
+#if defined(MIKTEX)
+  connect(&_fingerprintWatcher, SIGNAL(finished()), this, SLOT(pageFingerprintsReady()));
+#endif
 
   // Initialize the unlock widget
   {
@@ -2094,10 +2131,35 @@ void PDFDocumentScene::reloadDocument()
     return;
 
   _doc->reload();
+#if defined(MIKTEX)
+  // The cached tiles are kept until the fingerprints of the new version tell
+  // which pages changed. That needs the fingerprints of the previous version;
+  // if they are missing (or still being computed), all tiles are outdated.
+  if (_fingerprintWatcher.isRunning() || !_doc->hasPageFingerprints())
+    _doc->invalidatePageFingerprints();
+  _fingerprintWatcher.setFuture(_doc->pageFingerprints());
+#endif
   reinitializeScene();
   emit documentChanged(_doc.toWeakRef());
 }
 
+#if defined(MIKTEX)
+void PDFDocumentScene::pageFingerprintsReady()
+{
+  QFuture< QVector<QByteArray> > future = _fingerprintWatcher.future();
+  QSet<int> changedPages = _doc->updatePageFingerprints(future.resultCount() > 0 ? future.result() : QVector<QByteArray>());
+  if (changedPages.isEmpty())
+    return;
+  foreach(QGraphicsItem * item, _pages) {
+    if (!isPageItem(item))
+      continue;
+    PDFPageGraphicsItem * page = static_cast<PDFPageGraphicsItem*>(item);
+    if (changedPages.contains(pageNumFor(page)))
+      page->update();
+  }
+}
+#endif
+
 
 // Other
 // -----
@@ -2401,6 +2463,23 @@ void PDFPageGraphicsItem::paint(QPainter *painter, const QStyleOptionGraphicsIte
 #endif
       }
     }
+#if defined(MIKTEX)
+    // Prefetch the tiles surrounding the visible ones so they are likely to be
+    // ready by the time they are scrolled into view. Magnifiers (for which
+    // `view` is nullptr) are not worth it as they move around too quickly.
+    if (view) {
+      int icount = (pageRect.width() + effectiveTileSize - 1) / effectiveTileSize;
+      int jcount = (pageRect.height() + effectiveTileSize - 1) / effectiveTileSize;
+      for (j = qMax(jmin - 1, 0); j <= qMin(jmax, jcount - 1); ++j) {
+        for (i = qMax(imin - 1, 0); i <= qMin(imax, icount - 1); ++i) {
+          if (i >= imin && i < imax && j >= jmin && j < jmax)
+            continue;
+          QRect renderTile(i * TILE_SIZE, j * TILE_SIZE, TILE_SIZE, TILE_SIZE);
+          page->prefetchTileImage(this, _dpiX * scaleFactor * painter->device()->devicePixelRatio(), _dpiY * scaleFactor * painter->device()->devicePixelRatio(), renderTile);
+        }
+      }
+    }
+#endif
   }
   painter->restore();
 }
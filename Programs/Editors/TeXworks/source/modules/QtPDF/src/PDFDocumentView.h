@@ -40,6 +40,10 @@ class PDFDocumentView : public QGraphicsView {
 
   qreal _zoomLevel{1.0};
   int _currentPage{-1}, _lastPage{-1};
+#if defined(MIKTEX)
+  // pages intersecting the viewport when render requests were last pruned
+  int _firstVisiblePage{-1}, _lastVisiblePage{-1};
+#endif
 
   QString _searchString;
   QList<QGraphicsItem *> _searchResults;
@@ -451,6 +455,9 @@ class PDFDocumentScene : public QGraphicsScene
   QFileSystemWatcher _fileWatcher;
   QTimer _reloadTimer;
   double _dpiX, _dpiY;
+#if defined(MIKTEX)
+  QFutureWatcher< QVector<QByteArray> > _fingerprintWatcher;
+#endif
 
   void handleActionEvent(const PDFActionEvent * action_event);
 
@@ -496,6 +503,9 @@ protected slots:
   void pageLayoutChanged(const QRectF& sceneRect);
   void reinitializeScene();
   void finishUnlock();
+#if defined(MIKTEX)
+  void pageFingerprintsReady();
+#endif
 
 protected:
   // Used in non-continuous mode to keep track of currently shown page across
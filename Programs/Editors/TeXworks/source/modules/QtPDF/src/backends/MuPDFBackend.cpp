@@ -921,6 +921,9 @@ QImage Page::renderToImage(double xres, double yres, QRect render_box, bool cach
   fz_pixmap *mu_image = fz_new_pixmap_with_rect(fz_device_bgr, render_bbox);
   // Flush to white.
   fz_clear_pixmap_with_color(mu_image, 255);
+#if defined(MIKTEX)
+  QMutexLocker glyphCacheLocker(&static_cast<Document *>(_parent)->_glyph_cacheLock);
+#endif
   fz_device *renderer = fz_new_draw_device(static_cast<Document *>(_parent)->_glyph_cache, mu_image);
 
   // Actually render the page.
@@ -934,6 +937,9 @@ QImage Page::renderToImage(double xres, double yres, QRect render_box, bool cach
 
   // Dispose of unneeded items.
   fz_free_device(renderer);
+#if defined(MIKTEX)
+  glyphCacheLocker.unlock();
+#endif
   fz_drop_pixmap(mu_image);
 
   if( cache ) {
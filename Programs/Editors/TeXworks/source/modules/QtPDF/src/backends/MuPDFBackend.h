@@ -50,6 +50,11 @@ protected:
   // that use it may have to be protected by a mutex.
   pdf_xref *_mupdf_data;
   fz_glyph_cache *_glyph_cache;
+#if defined(MIKTEX)
+  // The glyph cache is shared by all renderings, which may run in several
+  // worker threads concurrently
+  QMutex _glyph_cacheLock;
+#endif
 
   void loadMetaData();
 
@@ -24,6 +24,15 @@
 #include <memory>
 #endif
 
+#if defined(MIKTEX)
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QtConcurrent>
+#if defined(HAVE_POPPLER_XPDF_HEADERS)
+#include "PDFDoc.h"
+#endif
+#endif
+
 
 // Comparison operator for QSizeF needed to use QSizeF as keys in a QMap
 // NB: Must be in the global namespace
@@ -139,11 +148,197 @@ void convertAnnotation(Annotation::AbstractAnnotation * dest, const ::Poppler::A
 }
 
 
+#if defined(MIKTEX) && defined(HAVE_POPPLER_XPDF_HEADERS)
+// Computes fingerprints of pages from everything that goes into rendering
+// them: the content streams (undecoded), the resources, the page boxes, and
+// the annotations. Indirect objects are hashed once and referred to by their
+// digest, so objects shared by many pages (e.g., fonts) are read only once.
+class PageFingerprinter
+{
+public:
+  PageFingerprinter(XRef * xref) : _xref(xref) { }
+
+  QByteArray fingerprint(::Page * page)
+  {
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    _complete = true;
+    const PDFRectangle * box = page->getMediaBox();
+    addData(hash, 'M');
+    addData(hash, box->x1); addData(hash, box->y1); addData(hash, box->x2); addData(hash, box->y2);
+    box = page->getCropBox();
+    addData(hash, 'C');
+    addData(hash, box->x1); addData(hash, box->y1); addData(hash, box->x2); addData(hash, box->y2);
+    addData(hash, page->getRotate());
+    addObject(hash, page->getContents(), 0);
+    Dict * resources = page->getResourceDict();
+    if (resources)
+      addDict(hash, resources, 0);
+    addObject(hash, page->getAnnotsObject(_xref), 0);
+    addObject(hash, _documentWide, 0);
+    return (_complete ? hash.result() : QByteArray());
+  }
+
+  // Objects outside of the pages that influence rendering (e.g., optional
+  // content configurations)
+  void setDocumentWide(Object && obj) { _documentWide = std::move(obj); }
+
+private:
+  // Objects nested more deeply are not hashed; pages containing them get no
+  // fingerprint (i.e., are always considered changed)
+  static const int MAX_DEPTH = 64;
+
+  template<typename T> static void addData(QCryptographicHash & hash, const T & value)
+  {
+    hash.addData(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  // Don't follow links to other parts of the document (parents, link targets,
+  // etc.) that don't affect the rendering of the page.
+  static bool isStructureKey(const char * key)
+  {
+    static const char * const keys[] = { "Parent", "P", "Dest", "A", "PA", "Next", "Prev", "First", "Last", "IRT", "Popup" };
+    for (const char * k : keys) {
+      if (strcmp(key, k) == 0)
+        return true;
+    }
+    return false;
+  }
+
+  void addObject(QCryptographicHash & hash, const Object & obj, int depth)
+  {
+    addData(hash, static_cast<int>(obj.getType()));
+    switch (obj.getType()) {
+      case objBool:
+        addData(hash, static_cast<bool>(obj.getBool()));
+        break;
+      case objInt:
+        addData(hash, obj.getInt());
+        break;
+      case objInt64:
+        addData(hash, obj.getInt64());
+        break;
+      case objReal:
+        addData(hash, obj.getReal());
+        break;
+      case objString:
+        addData(hash, obj.getString()->getLength());
+        hash.addData(obj.getString()->getCString(), obj.getString()->getLength());
+        break;
+      case objName:
+        hash.addData(obj.getName(), static_cast<int>(strlen(obj.getName())) + 1);
+        break;
+      case objArray:
+        if (depth >= MAX_DEPTH) {
+          _complete = false;
+          break;
+        }
+        addData(hash, obj.arrayGetLength());
+        for (int i = 0; i < obj.arrayGetLength(); ++i)
+          addObject(hash, obj.arrayGetNF(i), depth + 1);
+        break;
+      case objDict:
+        addDict(hash, obj.getDict(), depth);
+        break;
+      case objStream:
+        addStream(hash, obj.getStream(), depth);
+        break;
+      case objRef:
+        hash.addData(refDigest(obj.getRef(), depth));
+        break;
+      default:
+        break;
+    }
+  }
+
+  void addDict(QCryptographicHash & hash, Dict * dict, int depth)
+  {
+    if (depth >= MAX_DEPTH) {
+      _complete = false;
+      return;
+    }
+    addData(hash, dict->getLength());
+    for (int i = 0; i < dict->getLength(); ++i) {
+      const char * key = dict->getKey(i);
+      hash.addData(key, static_cast<int>(strlen(key)) + 1);
+      if (!isStructureKey(key))
+        addObject(hash, dict->getValNF(i), depth + 1);
+    }
+  }
+
+  void addStream(QCryptographicHash & hash, Stream * stream, int depth)
+  {
+    if (stream->getDict())
+      addDict(hash, stream->getDict(), depth);
+    // Hash the raw data; it's the same as long as the decoded data is the
+    // same for all practical purposes
+    Stream * raw = stream->getUndecodedStream();
+    Guchar buf[4096];
+    int n;
+    raw->reset();
+    while ((n = raw->doGetChars(sizeof(buf), buf)) > 0)
+      hash.addData(reinterpret_cast<const char *>(buf), n);
+    raw->close();
+  }
+
+  QByteArray refDigest(const Ref & ref, int depth)
+  {
+    QPair<int, int> key(ref.num, ref.gen);
+    QHash<QPair<int, int>, QByteArray>::const_iterator it = _refDigests.constFind(key);
+    if (it != _refDigests.constEnd()) {
+      // An empty digest denotes an object that is being hashed (i.e., a
+      // cycle); the reference itself is all that matters then
+      return (it.value().isEmpty() ? QByteArray(reinterpret_cast<const char *>(&ref), sizeof(ref)) : it.value());
+    }
+    _refDigests.insert(key, QByteArray());
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    addObject(hash, _xref->fetch(ref.num, ref.gen), depth + 1);
+    QByteArray digest = hash.result();
+    _refDigests.insert(key, digest);
+    return digest;
+  }
+
+  XRef * _xref;
+  Object _documentWide;
+  QHash<QPair<int, int>, QByteArray> _refDigests;
+  bool _complete{true};
+};
+#endif
+
 // Document Class
 // ==============
+#if defined(MIKTEX)
+static void setRenderOptions(::Poppler::Document * doc)
+{
+  // **TODO:**
+  //
+  // _Make these configurable._
+  doc->setRenderBackend(::Poppler::Document::SplashBackend);
+  // Make things look pretty.
+  doc->setRenderHint(::Poppler::Document::Antialiasing);
+  doc->setRenderHint(::Poppler::Document::TextAntialiasing);
+}
+
+static QByteArray readFile(const QString & fileName)
+{
+  QFile file(fileName);
+  if (!file.open(QIODevice::ReadOnly))
+    return QByteArray();
+  return file.readAll();
+}
+#endif
+
+#if defined(MIKTEX)
+// Fingerprints are computed only on reload (see pageFingerprints()); there
+// are no cached tiles to keep yet
+Document::Document(const QString & fileName):
+  Super(fileName),
+  _fileData(readFile(fileName)),
+  _poppler_doc(::Poppler::Document::loadFromData(_fileData))
+#else
 Document::Document(const QString & fileName):
   Super(fileName),
   _poppler_doc(::Poppler::Document::load(fileName))
+#endif
 {
 #ifdef DEBUG
 //  qDebug() << "PopplerQt::Document::Document(" << fileName << ")";
@@ -172,12 +367,28 @@ void Document::reload()
   QWriteLocker docLocker(_docLock.data());
 
   clearPages();
+#if !defined(MIKTEX)
   _pageCache.markOutdated();
+#endif
 
+#if defined(MIKTEX)
+  // Read the file only once; the cached tiles are kept until the caller has
+  // compared the page fingerprints (see pageFingerprints())
+  _fileData = readFile(_fileName);
+  {
+    QMutexLocker l(_poppler_docLock);
+    _poppler_doc = QSharedPointer< ::Poppler::Document >(::Poppler::Document::loadFromData(_fileData));
+  }
+  {
+    QMutexLocker l(&_renderDocsLock);
+    _renderDocs.clear();
+  }
+#else
   {
     QMutexLocker l(_poppler_docLock);
     _poppler_doc = QSharedPointer< ::Poppler::Document >(::Poppler::Document::load(_fileName));
   }
+#endif
 
   // TODO: possibly unlock the new document again if it was previously unlocked
   // and the password is still the same
@@ -219,6 +430,9 @@ void Document::parseDocument()
   if (_poppler_doc->okToPrintHighRes())
     _permissions |= Permission_PrintHighRes;
 
+#if defined(MIKTEX)
+  setRenderOptions(_poppler_doc.data());
+#else
   // **TODO:**
   //
   // _Make these configurable._
@@ -226,6 +440,7 @@ void Document::parseDocument()
   // Make things look pretty.
   _poppler_doc->setRenderHint(::Poppler::Document::Antialiasing);
   _poppler_doc->setRenderHint(::Poppler::Document::TextAntialiasing);
+#endif
 
   // Load meta data
   QStringList metaKeys = _poppler_doc->infoKeys();
@@ -507,6 +722,67 @@ bool Document::unlock(const QString password)
   return success;
 }
 
+#if defined(MIKTEX)
+#if defined(HAVE_POPPLER_XPDF_HEADERS)
+// Runs in a worker thread; `data` is a snapshot of the file, so no locks are
+// needed
+static QVector<QByteArray> computePageFingerprints(QByteArray data, int numPages)
+{
+  QVector<QByteArray> fingerprints;
+  // ::Poppler::Document doesn't give access to the underlying PDFDoc, so we
+  // parse the data once more (but don't read the file again)
+  PDFDoc doc(new MemStream(const_cast<char *>(data.constData()), 0, data.size(), Object(objNull)));
+  if (!doc.isOk() || doc.getNumPages() != numPages)
+    return fingerprints;
+  PageFingerprinter fingerprinter(doc.getXRef());
+  Object catalog = doc.getXRef()->getCatalog();
+  if (catalog.isDict())
+    fingerprinter.setDocumentWide(catalog.dictLookupNF("OCProperties"));
+  fingerprints.reserve(numPages);
+  for (int i = 1; i <= numPages; ++i) {
+    ::Page * page = doc.getCatalog()->getPage(i);
+    fingerprints << (page ? fingerprinter.fingerprint(page) : QByteArray());
+  }
+  return fingerprints;
+}
+#endif
+
+QFuture< QVector<QByteArray> > Document::pageFingerprints() const
+{
+  QReadLocker docLocker(_docLock.data());
+#if defined(HAVE_POPPLER_XPDF_HEADERS)
+  if (_isValid() && !_isLocked())
+    return QtConcurrent::run(computePageFingerprints, _fileData, _numPages);
+#endif
+  return QFuture< QVector<QByteArray> >();
+}
+
+QSharedPointer< ::Poppler::Document > Document::renderDocument() const
+{
+  QThread * thread = QThread::currentThread();
+  // The GUI thread renders rarely (e.g., for presentations or thumbnails) and
+  // doesn't need an instance of its own
+  if (thread == QCoreApplication::instance()->thread() || !_isValid() || _isLocked())
+    return QSharedPointer< ::Poppler::Document >();
+  {
+    QMutexLocker l(&_renderDocsLock);
+    QHash<QThread*, QSharedPointer< ::Poppler::Document > >::const_iterator it = _renderDocs.constFind(thread);
+    if (it != _renderDocs.constEnd())
+      return it.value();
+  }
+  QSharedPointer< ::Poppler::Document > doc(::Poppler::Document::loadFromData(_fileData));
+  // Fall back to the shared instance if the document cannot be opened the
+  // same way again (e.g., it requires a password)
+  if (doc && (doc->isLocked() || doc->numPages() != _numPages))
+    doc.clear();
+  if (doc)
+    setRenderOptions(doc.data());
+  QMutexLocker l(&_renderDocsLock);
+  _renderDocs.insert(thread, doc);
+  return doc;
+}
+#endif
+
 
 // Page Class
 // ==========
@@ -542,6 +818,18 @@ QImage Page::renderToImage(double xres, double yres, QRect render_box, bool cach
 
   QImage renderedPage;
 
+#if defined(MIKTEX)
+  QSharedPointer< ::Poppler::Document > renderDoc = dynamic_cast<Backend::PopplerQt::Document *>(_parent)->renderDocument();
+  QScopedPointer< ::Poppler::Page > renderPage(renderDoc ? renderDoc->page(_n) : nullptr);
+  if (renderPage) {
+    // renderDoc is used by this thread only, so no locking is needed
+    if (render_box.isNull())
+      renderedPage = renderPage->renderToImage(xres, yres);
+    else
+      renderedPage = renderPage->renderToImage(xres, yres, render_box.x(), render_box.y(), render_box.width(), render_box.height());
+  }
+  else
+#endif
   {
     // Rendering pages is not thread safe.
     QMutexLocker popplerDocLock(dynamic_cast<Backend::PopplerQt::Document *>(_parent)->_poppler_docLock);
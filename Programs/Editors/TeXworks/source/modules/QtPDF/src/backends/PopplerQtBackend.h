@@ -38,6 +38,12 @@ class Document: public Backend::Document
   typedef Backend::Document Super;
   friend class Page;
 
+#if defined(MIKTEX)
+  // The contents of the file as of the last (re)load. All Poppler documents
+  // (and the fingerprints) are created from this snapshot, so they agree even
+  // if the file is being rewritten.
+  QByteArray _fileData;
+#endif
   QSharedPointer< ::Poppler::Document > _poppler_doc;
 
   void recursiveConvertToC(QList<PDFToCItem> & items, QDomNode node) const;
@@ -56,6 +62,19 @@ protected:
   bool _isValid() const { return (_poppler_doc != nullptr); }
   bool _isLocked() const { return (_poppler_doc ? _poppler_doc->isLocked() : false); }
 
+#if defined(MIKTEX)
+  // To render pages in parallel (rather than one after the other, serialized
+  // by _poppler_docLock), each worker thread of the processing thread renders
+  // with a Poppler document of its own. The instances are created on demand
+  // and dropped when the document is reloaded.
+  mutable QMutex _renderDocsLock;
+  mutable QHash<QThread*, QSharedPointer< ::Poppler::Document > > _renderDocs;
+  // Returns the Poppler document the current thread renders with, or nullptr
+  // if it must use _poppler_doc (and _poppler_docLock).
+  // The caller must hold a doc-read-lock.
+  QSharedPointer< ::Poppler::Document > renderDocument() const;
+#endif
+
 public:
   Document(const QString & fileName);
   ~Document() override;
@@ -73,6 +92,10 @@ public:
   PDFToC toc() const override;
   QList<PDFFontInfo> fonts() const override;
 
+#if defined(MIKTEX)
+  QFuture< QVector<QByteArray> > pageFingerprints() const override;
+#endif
+
 private:
   void parseDocument();
 };
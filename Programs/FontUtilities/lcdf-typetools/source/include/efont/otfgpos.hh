@@ -33,6 +33,9 @@ class GposLookup { public:
     int type() const                    { return _type; }
     uint16_t flags() const              { return _d.u16(2); }
     bool unparse_automatics(Vector<Positioning> &, ErrorHandler * = 0) const;
+#if defined(MIKTEX)
+    bool unparse_automatics(Vector<Positioning> &, const Coverage &limit, ErrorHandler * = 0) const;
+#endif
     enum {
         HEADERSIZE = 6, RECSIZE = 2,
         L_SINGLE = 1, L_PAIR = 2, L_CURSIVE = 3, L_MARKTOBASE = 4,
@@ -70,6 +73,9 @@ class GposSingle { public:
     // default destructor
     Coverage coverage() const noexcept;
     void unparse(Vector<Positioning> &) const;
+#if defined(MIKTEX)
+    void unparse(Vector<Positioning> &, const Coverage &limit) const;
+#endif
     enum { F2_HEADERSIZE = 8 };
   private:
     Data _d;
@@ -80,6 +86,9 @@ class GposPair { public:
     // default destructor
     Coverage coverage() const noexcept;
     void unparse(Vector<Positioning> &) const;
+#if defined(MIKTEX)
+    void unparse(Vector<Positioning> &, const Coverage &limit) const;
+#endif
     enum { F1_HEADERSIZE = 10, F1_RECSIZE = 2,
            PAIRSET_HEADERSIZE = 2, PAIRVALUE_HEADERSIZE = 2,
            F2_HEADERSIZE = 16 };
@@ -12,6 +12,9 @@ class KernTable { public:
     bool ok() const                     { return _error >= 0; }
 
     bool unparse_automatics(Vector<Positioning> &, ErrorHandler * = 0) const;
+#if defined(MIKTEX)
+    bool unparse_automatics(Vector<Positioning> &, const Coverage &limit, ErrorHandler * = 0) const;
+#endif
 
   private:
 
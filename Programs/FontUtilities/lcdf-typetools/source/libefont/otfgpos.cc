@@ -138,6 +138,41 @@ GposLookup::unparse_automatics(Vector<Positioning> &v, ErrorHandler *errh) const
 }
 
 
+#if defined(MIKTEX)
+bool
+GposLookup::unparse_automatics(Vector<Positioning> &v, const Coverage &limit, ErrorHandler *errh) const
+{
+    int nlookup = _d.u16(4), success = 0;
+    switch (_type) {
+      case L_SINGLE:
+        for (int i = 0; i < nlookup; i++)
+            try {
+                GposSingle s(subtable(i));
+                s.unparse(v, limit);
+                success++;
+            } catch (Error e) {
+                if (errh)
+                    errh->warning("%s, continuing", e.description.c_str());
+            }
+        return success > 0;
+      case L_PAIR:
+        for (int i = 0; i < nlookup; i++)
+            try {
+                GposPair p(subtable(i));
+                p.unparse(v, limit);
+                success++;
+            } catch (Error e) {
+                if (errh)
+                    errh->warning("%s, continuing", e.description.c_str());
+            }
+        return success > 0;
+      default:
+        return false;
+    }
+}
+#endif
+
+
 /**************************
  * GposSingle             *
  *                        *
@@ -177,6 +212,26 @@ GposSingle::unparse(Vector<Positioning> &v) const
     }
 }
 
+#if defined(MIKTEX)
+void
+GposSingle::unparse(Vector<Positioning> &v, const Coverage &limit) const
+{
+    if (_d[1] == 1) {
+        int format = _d.u16(4);
+        Data value = _d.subtable(6);
+        for (Coverage::iterator i = coverage().begin(); i; i++)
+            if (limit.covers(*i))
+                v.push_back(Positioning(Position(*i, format, value)));
+    } else {
+        int format = _d.u16(4);
+        int size = GposValue::size(format);
+        for (Coverage::iterator i = coverage().begin(); i; i++)
+            if (limit.covers(*i))
+                v.push_back(Positioning(Position(*i, format, _d.subtable(F2_HEADERSIZE + size*i.coverage_index()))));
+    }
+}
+#endif
+
 
 /**************************
  * GposPair               *
@@ -242,6 +297,75 @@ GposPair::unparse(Vector<Positioning> &v) const
     }
 }
 
+#if defined(MIKTEX)
+void
+GposPair::unparse(Vector<Positioning> &v, const Coverage &limit) const
+{
+    if (_d[1] == 1) {
+        int format1 = _d.u16(4);
+        int format2 = _d.u16(6);
+        int f2_pos = PAIRVALUE_HEADERSIZE + GposValue::size(format1);
+        int pairvalue_size = f2_pos + GposValue::size(format2);
+        for (Coverage::iterator i = coverage().begin(); i; i++) {
+            if (!limit.covers(*i))
+                continue;
+            Data pairset = _d.offset_subtable(F1_HEADERSIZE + i.coverage_index()*F1_RECSIZE);
+            int npair = pairset.u16(0);
+            for (int j = 0; j < npair; j++) {
+                Data pair = pairset.subtable(PAIRSET_HEADERSIZE + j*pairvalue_size);
+                if (limit.covers(pair.u16(0)))
+                    v.push_back(Positioning(Position(*i, format1, pair.subtable(PAIRVALUE_HEADERSIZE)),
+                                            Position(pair.u16(0), format2, pair.subtable(f2_pos))));
+            }
+        }
+    } else {                    // _d[1] == 2
+        int format1 = _d.u16(4);
+        int format2 = _d.u16(6);
+        int f2_pos = GposValue::size(format1);
+        int recsize = f2_pos + GposValue::size(format2);
+        ClassDef class1(_d.offset_subtable(8));
+        ClassDef class2(_d.offset_subtable(10));
+        int nclass1 = _d.u16(12);
+        int nclass2 = _d.u16(14);
+
+        // Sort the glyphs within the limit into their classes once,
+        // instead of walking both class definitions for every class
+        // pair.  Glyphs are visited in increasing order, so the
+        // positionings come out in the same order as unparse() would
+        // produce them.  Class 0 of the second class definition holds
+        // every glyph that is not assigned to another class.
+        // unparse() cannot enumerate it and gives up on the subtable;
+        // here, it is the glyphs of the limit in class 0.
+        Vector<Vector<Glyph> > glyphs1(nclass1, Vector<Glyph>());
+        if (class1.ok())
+            for (Coverage::iterator i = coverage().begin(); i; i++) {
+                int c1 = class1.lookup(*i);
+                if (c1 >= 0 && c1 < nclass1 && limit.covers(*i))
+                    glyphs1[c1].push_back(*i);
+            }
+        Vector<Vector<Glyph> > glyphs2(nclass2, Vector<Glyph>());
+        if (class2.ok())
+            for (Coverage::iterator i = limit.begin(); i; i++) {
+                int c2 = class2.lookup(*i);
+                if (c2 >= 0 && c2 < nclass2)
+                    glyphs2[c2].push_back(*i);
+            }
+
+        int offset = F2_HEADERSIZE;
+        for (int c1 = 0; c1 < nclass1; c1++)
+            for (int c2 = 0; c2 < nclass2; c2++, offset += recsize) {
+                Position p1(format1, _d.subtable(offset));
+                Position p2(format2, _d.subtable(offset + f2_pos));
+                if (p1 || p2) {
+                    for (const Glyph *g1 = glyphs1[c1].begin(); g1 != glyphs1[c1].end(); ++g1)
+                        for (const Glyph *g2 = glyphs2[c2].begin(); g2 != glyphs2[c2].end(); ++g2)
+                            v.push_back(Positioning(Position(*g1, p1), Position(*g2, p2)));
+                }
+            }
+    }
+}
+#endif
+
 
 /**************************
  * Positioning            *
@@ -111,6 +111,67 @@ KernTable::unparse_automatics(Vector<Positioning> &v, ErrorHandler *errh) const
     return success > 0;
 }
 
+#if defined(MIKTEX)
+bool
+KernTable::unparse_automatics(Vector<Positioning> &v, const Coverage &limit, ErrorHandler *errh) const
+{
+    uint32_t ntables = this->ntables();
+    uint32_t off = first_offset();
+    int success = 0;
+    if (_error < 0)
+        return false;
+
+    for (uint16_t i = 0; i < ntables; ++i) {
+        Data subt = _d.subtable(off);
+        uint16_t coverage = subt.u16(4);
+
+        if (_version == 0) {
+            if ((coverage & COV_V0_HORIZONTAL) == 0
+                || (coverage & (COV_V0_MINIMUM | COV_V0_CROSS_STREAM
+                                | COV_V0_OVERRIDE)) != 0
+                || (coverage & COV_V0_FORMAT) != COV_V0_FORMAT0)
+                continue;
+        } else {
+            if ((coverage & (COV_V1_VERTICAL | COV_V1_CROSS_STREAM
+                             | COV_V1_VARIATION)) != 0
+                || (coverage & COV_V1_FORMAT) != COV_V1_FORMAT0)
+                continue;
+        }
+
+        // The pairs are sorted by left and right glyph, so the pairs of
+        // each left glyph in the limit are found by binary search, and
+        // the pairs of the other glyphs are never looked at.
+        try {
+            uint32_t off = (_version ? 16 : 14);
+            uint16_t npairs = subt.u16(off - 8);
+            int first = 0;
+            for (Coverage::iterator g = limit.begin(); g && first < npairs; g++) {
+                int last = npairs;
+                while (first < last) {
+                    int m = first + (last - first) / 2;
+                    if (subt.u16(off + m*6) < *g)
+                        first = m + 1;
+                    else
+                        last = m;
+                }
+                for (; first < npairs && subt.u16(off + first*6) == *g; ++first) {
+                    uint32_t pair = off + first*6;
+                    if (limit.covers(subt.u16(pair + 2)))
+                        v.push_back(Positioning(Position(*g, 0, 0, subt.s16(pair + 4), 0),
+                                                Position(subt.u16(pair + 2), 0, 0, 0, 0)));
+                }
+            }
+            success += npairs;
+        } catch (Error e) {
+            if (errh)
+                errh->warning("%s, continuing", e.description.c_str());
+        }
+    }
+
+    return success > 0;
+}
+#endif
+
 }}
 
 #include <lcdf/vector.cc>
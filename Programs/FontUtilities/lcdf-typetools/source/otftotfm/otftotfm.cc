@@ -1488,6 +1488,25 @@ do_gsub(Metrics& metrics, const OpenType::Font& otf,
     }
 }
 
+#if defined(MIKTEX)
+// Positionings only matter for glyphs that made it into the encoding,
+// so GPOS and kern processing can skip all other glyphs.
+static OpenType::Coverage
+encoded_glyphs(const Metrics& metrics)
+{
+    Vector<bool> used(1, true); // glyph 0 stands for "no glyph"
+    for (Metrics::Code c = 0; c < metrics.encoding_size(); ++c) {
+        Metrics::Glyph g = metrics.glyph(c);
+        if (g > 0 && g < Metrics::VIRTUAL_GLYPH) {
+            if (g >= used.size())
+                used.resize(g + 1, false);
+            used[g] = true;
+        }
+    }
+    return OpenType::Coverage(used);
+}
+#endif
+
 static bool
 kern_feature_requested()
 {
@@ -1504,7 +1523,11 @@ do_try_ttf_kern(Metrics& metrics, const OpenType::Font& otf, HashMap<uint32_t, i
     try {
         OpenType::KernTable kern(otf.table("kern"), errh);
         Vector<OpenType::Positioning> poss;
+#if defined(MIKTEX)
+        bool understood = kern.unparse_automatics(poss, encoded_glyphs(metrics), errh);
+#else
         bool understood = kern.unparse_automatics(poss, errh);
+#endif
         int nunderstood = metrics.apply(poss);
 
         // mark as used
@@ -1535,12 +1558,19 @@ do_gpos(Metrics& metrics, const OpenType::Font& otf, HashMap<uint32_t, int>& fea
     skip_ttf_kern: ;
     }
 
+#if defined(MIKTEX)
+    OpenType::Coverage used_coverage = encoded_glyphs(metrics);
+#endif
     Vector<OpenType::Positioning> poss;
     for (int i = 0; i < lookups.size(); i++)
         if (lookups[i].used) {
             OpenType::GposLookup l = gpos.lookup(i);
             poss.clear();
+#if defined(MIKTEX)
+            bool understood = l.unparse_automatics(poss, used_coverage, errh);
+#else
             bool understood = l.unparse_automatics(poss, errh);
+#endif
             int nunderstood = metrics.apply(poss);
 
             // mark as used
@@ -2345,7 +2375,11 @@ particular purpose.\n");
 
     try {
         // read font
+#if defined(MIKTEX)
+        otf_data = map_file(input_file, errh);
+#else
         otf_data = read_file(input_file, errh);
+#endif
         if (errh->nerrors())
             exit(1);
 
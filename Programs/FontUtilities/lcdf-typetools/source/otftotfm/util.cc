@@ -31,6 +31,11 @@
 #ifdef HAVE_UNISTD_H
 # include <unistd.h>
 #endif
+#if defined(MIKTEX)
+# include <climits>
+# include <memory>
+# include <miktex/Core/MemoryMappedFile>
+#endif
 
 String
 read_file(String filename, ErrorHandler *errh, bool warning)
@@ -64,6 +69,31 @@ read_file(String filename, ErrorHandler *errh, bool warning)
     return sa.take_string();
 }
 
+#if defined(MIKTEX)
+String
+map_file(String filename, ErrorHandler *errh)
+{
+    // Map the file instead of copying it into memory: of a large font,
+    // only the tables and glyphs in use are ever touched.  Mappings
+    // are kept until the program exits, since Strings refer to them.
+    static Vector<MiKTeX::Core::MemoryMappedFile *> mapped_files;
+    if (filename && filename != "-") {
+        try {
+            std::unique_ptr<MiKTeX::Core::MemoryMappedFile> mmap(MiKTeX::Core::MemoryMappedFile::Create());
+            const char *data = (const char *) mmap->Open(MiKTeX::Core::PathName(filename.c_str()), false);
+            size_t size = mmap->GetSize();
+            if (data && size > 0 && size <= INT_MAX) {
+                mapped_files.push_back(mmap.release());
+                return String::make_stable(data, (int) size);
+            }
+        } catch (const std::exception &) {
+            // read the file instead
+        }
+    }
+    return read_file(filename, errh);
+}
+#endif
+
 String
 printable_filename(const String &s)
 {
@@ -0,0 +1,288 @@
+/* limits.cc: test the limited GPOS and kern unparsers
+
+   Copyright (C) 2026 agent
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published
+   by the Free Software Foundation; either version 2, or (at your
+   option) any later version.
+
+   This file is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this file; if not, write to the Free Software
+   Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+   USA.  */
+
+/* Builds small GPOS subtables and a kern table in memory and checks,
+   for every subset of the glyphs as limit, that the limited unparse
+   returns exactly the full unparse filtered to the limit.  A format 2
+   pair subtable with values for class 0 of the second class
+   definition cannot be unparsed in full; the limited unparse must
+   return the pairs with the glyphs of the limit that are in no class. */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <efont/otfgpos.hh>
+#include <efont/ttfkern.hh>
+#include <lcdf/error.hh>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace Efont::OpenType;
+
+const int NGLYPHS = 10;
+
+static int failures = 0;
+
+#define CHECK(exp)                                                      \
+  if (!(exp))                                                           \
+  {                                                                     \
+    fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #exp); \
+    ++failures;                                                         \
+  }
+
+class Bytes
+{
+public:
+  Bytes& u16(int value)
+  {
+    bytes.push_back(static_cast<char>((value >> 8) & 0xff));
+    bytes.push_back(static_cast<char>(value & 0xff));
+    return *this;
+  }
+public:
+  Bytes& append(const Bytes& other)
+  {
+    bytes.insert(bytes.end(), other.bytes.begin(), other.bytes.end());
+    return *this;
+  }
+public:
+  int size() const
+  {
+    return static_cast<int>(bytes.size());
+  }
+public:
+  Data data() const
+  {
+    return Data(String(bytes.data(), size()));
+  }
+private:
+  std::vector<char> bytes;
+};
+
+static Coverage Limit(unsigned mask)
+{
+  Vector<bool> used(NGLYPHS, false);
+  for (int g = 0; g < NGLYPHS; ++g)
+    used[g] = (mask & (1U << g)) != 0;
+  return Coverage(used);
+}
+
+static std::vector<std::string> Unparse(const Vector<Positioning>& v)
+{
+  std::vector<std::string> result;
+  for (const Positioning* p = v.begin(); p != v.end(); ++p)
+    result.push_back(p->unparse().c_str());
+  return result;
+}
+
+static std::vector<std::string> Filter(const Vector<Positioning>& v, const Coverage& limit)
+{
+  Vector<Positioning> filtered;
+  for (const Positioning* p = v.begin(); p != v.end(); ++p)
+    if (p->context_in(limit))
+      filtered.push_back(*p);
+  return Unparse(filtered);
+}
+
+// coverage format 1: glyphs 1, 2, 4, 6, 8
+static Bytes CoverageTable()
+{
+  Bytes coverage;
+  coverage.u16(1).u16(5).u16(1).u16(2).u16(4).u16(6).u16(8);
+  return coverage;
+}
+
+// single positioning, format 2: an x advance per covered glyph
+static Bytes SinglePos()
+{
+  Bytes single;
+  single.u16(2).u16(8 + 5*2).u16(4).u16(5);
+  for (int i = 0; i < 5; ++i)
+    single.u16(10 * (i + 1));
+  return single.append(CoverageTable());
+}
+
+// pair positioning, format 1: every covered glyph kerns with the
+// glyphs above it
+static Bytes PairPos1()
+{
+  static const int covered[] = { 1, 2, 4, 6, 8 };
+  int headerSize = 10 + 5*2;
+  Bytes pairsets;
+  std::vector<int> offsets;
+  for (int first : covered) {
+    offsets.push_back(headerSize + pairsets.size());
+    pairsets.u16(NGLYPHS - 1 - first);
+    for (int second = first + 1; second < NGLYPHS; ++second)
+      pairsets.u16(second).u16(-(first * 10 + second));
+  }
+  Bytes pair;
+  pair.u16(1).u16(headerSize + pairsets.size()).u16(4).u16(0).u16(5);
+  for (int offset : offsets)
+    pair.u16(offset);
+  return pair.append(pairsets).append(CoverageTable());
+}
+
+// pair positioning, format 2: three first classes (glyph 1 and 2 in
+// class 1, 4 in class 2, the others in class 0), three second
+// classes (3-4 in class 1, 5-7 in class 2; 0-2, 8 and 9 in class 0)
+static Bytes PairPos2(bool class0Values)
+{
+  Bytes classDef1;
+  classDef1.u16(1).u16(1).u16(4).u16(1).u16(1).u16(0).u16(2);
+  Bytes classDef2;
+  classDef2.u16(2).u16(2).u16(3).u16(4).u16(1).u16(5).u16(7).u16(2);
+  int nclass1 = 3;
+  int nclass2 = 3;
+  int headerSize = 16 + nclass1*nclass2*2;
+  Bytes pair;
+  pair.u16(2).u16(headerSize).u16(4).u16(0)
+    .u16(headerSize + CoverageTable().size())
+    .u16(headerSize + CoverageTable().size() + classDef1.size())
+    .u16(nclass1).u16(nclass2);
+  for (int c1 = 0; c1 < nclass1; ++c1)
+    for (int c2 = 0; c2 < nclass2; ++c2)
+      pair.u16(c2 == 0 && !class0Values ? 0 : -(c1 * 10 + c2 + 1));
+  return pair.append(CoverageTable()).append(classDef1).append(classDef2);
+}
+
+// kern table, version 0, one format 0 subtable: pairs of glyphs,
+// sorted; glyph 0 is left out, since a positioning takes it for no
+// glyph at all
+static Bytes KernTab()
+{
+  Bytes pairs;
+  int npairs = 0;
+  for (int left = 1; left < NGLYPHS; ++left)
+    for (int right = 1; right < NGLYPHS; ++right)
+      if ((left + right) % 3 == 0) {
+        pairs.u16(left).u16(right).u16(-(left * 10 + right));
+        ++npairs;
+      }
+  Bytes kern;
+  kern.u16(0).u16(1);
+  kern.u16(0).u16(14 + pairs.size()).u16(0x0001).u16(npairs).u16(0).u16(0).u16(0);
+  return kern.append(pairs);
+}
+
+static void TestSingle()
+{
+  GposSingle single(SinglePos().data());
+  Vector<Positioning> all;
+  single.unparse(all);
+  CHECK(all.size() == 5);
+  for (unsigned mask = 0; mask < (1U << NGLYPHS); ++mask) {
+    Coverage limit = Limit(mask);
+    Vector<Positioning> limited;
+    single.unparse(limited, limit);
+    CHECK(Unparse(limited) == Filter(all, limit));
+  }
+}
+
+static void TestPair1()
+{
+  GposPair pair(PairPos1().data());
+  Vector<Positioning> all;
+  pair.unparse(all);
+  CHECK(all.size() > 0);
+  for (unsigned mask = 0; mask < (1U << NGLYPHS); ++mask) {
+    Coverage limit = Limit(mask);
+    Vector<Positioning> limited;
+    pair.unparse(limited, limit);
+    CHECK(Unparse(limited) == Filter(all, limit));
+  }
+}
+
+static void TestPair2()
+{
+  GposPair pair(PairPos2(false).data());
+  Vector<Positioning> all;
+  pair.unparse(all);
+  CHECK(all.size() > 0);
+  for (unsigned mask = 0; mask < (1U << NGLYPHS); ++mask) {
+    Coverage limit = Limit(mask);
+    Vector<Positioning> limited;
+    pair.unparse(limited, limit);
+    CHECK(Unparse(limited) == Filter(all, limit));
+  }
+}
+
+static void TestPair2Class0()
+{
+  GposPair pair(PairPos2(true).data());
+  Vector<Positioning> all;
+  bool failed = false;
+  try {
+    pair.unparse(all);
+  } catch (Error) {
+    failed = true;
+  }
+  CHECK(failed);
+  // glyphs 1 (first class 1), 4 (first class 2; second class 1), 6
+  // (first class 0; second class 2) and 9 (second class 0)
+  Coverage limit = Limit((1U << 1) | (1U << 4) | (1U << 6) | (1U << 9));
+  Vector<Positioning> limited;
+  pair.unparse(limited, limit);
+  std::vector<std::string> expected;
+  // in class order: first 0 (6), 1 (1), 2 (4); second 0 (1, 9), 1
+  // (4), 2 (6)
+  for (int first : { 6, 1, 4 }) {
+    int c1 = first == 1 ? 1 : first == 4 ? 2 : 0;
+    for (int second : { 1, 9, 4, 6 }) {
+      int c2 = second == 4 ? 1 : second == 6 ? 2 : 0;
+      Vector<Positioning> v;
+      v.push_back(Positioning(Position(first, 0, 0, -(c1 * 10 + c2 + 1), 0), Position(second, 0, 0, 0, 0)));
+      expected.push_back(Unparse(v)[0]);
+    }
+  }
+  CHECK(Unparse(limited) == expected);
+}
+
+static void TestKern()
+{
+  KernTable kern(KernTab().data());
+  CHECK(kern.ok());
+  Vector<Positioning> all;
+  CHECK(kern.unparse_automatics(all));
+  for (unsigned mask = 0; mask < (1U << NGLYPHS); ++mask) {
+    Coverage limit = Limit(mask);
+    Vector<Positioning> limited;
+    CHECK(kern.unparse_automatics(limited, limit));
+    CHECK(Unparse(limited) == Filter(all, limit));
+  }
+}
+
+int main()
+{
+  try {
+    TestSingle();
+    TestPair1();
+    TestPair2();
+    TestPair2Class0();
+    TestKern();
+  } catch (Error e) {
+    fprintf(stderr, "unexpected error: %s\n", e.description.c_str());
+    return 1;
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -417,6 +417,9 @@ typedef struct KFIELD
     char    *encap;			/* encapsulator */
     const char    *fn;			/* input filename */
     int     lc;				/* line number */
+#if defined(MIKTEX)
+    struct KSORTKEY *sk;		/* precomputed sort key */
+#endif
 }	FIELD, *FIELD_PTR;
 
 typedef struct KNODE
@@ -34,11 +34,46 @@
 
 static	long	idx_gc;
 
+#if defined(MIKTEX)
+/*
+ * Everything compare() needs to know about the fields of an entry,
+ * computed once before sorting: the group type of each field and,
+ * with locale_sort, the strxfrm() image of each field (strcmp() on the
+ * images orders like strcoll() on the fields).  Images are stored as
+ * offsets into one buffer.
+ */
+typedef struct KSORTKEY
+{
+    int     sf_group[FIELD_MAX];
+    int     af_group[FIELD_MAX];
+    size_t  sf_coll[FIELD_MAX];
+    size_t  af_coll[FIELD_MAX];
+}	SORT_KEY;
+
+static SORT_KEY *sort_keys;
+static char *coll_buf;
+static size_t coll_len;
+static size_t coll_size;
+
+static void make_sort_keys (void);
+static void free_sort_keys (void);
+static int check_mixsym (const char *x, const char *y,
+           const char *cx, const char *cy);
+static int collate (const char *x, const char *y,
+           const char *cx, const char *cy);
+static int compare (const void *va, const void *vb);
+static int compare_one (const char *x, const char *y, int m, int n,
+           const char *cx, const char *cy);
+static int compare_page (const FIELD_PTR *a, const FIELD_PTR *b);
+static int compare_string (const unsigned char *a, const unsigned char *b,
+           const char *ca, const char *cb);
+#else
 static int check_mixsym (const char *x, const char *y);
 static int compare (const void *va, const void *vb);
 static int compare_one (const char *x, const char *y);
 static int compare_page (const FIELD_PTR *a, const FIELD_PTR *b);
 static int compare_string (const unsigned char *a, const unsigned char *b);
+#endif
 static int new_strcmp (const unsigned char *a, const unsigned char *b,
            int option);
 
@@ -56,19 +91,87 @@ sort_idx(void)
 #endif
     idx_dc = 0;
     idx_gc = 0L;
+#if defined(MIKTEX)
+    make_sort_keys();
+#endif
     qqsort(idx_key, (size_t)idx_gt, sizeof(FIELD_PTR), compare);
+#if defined(MIKTEX)
+    free_sort_keys();
+#endif
 #ifdef HAVE_SETLOCALE
     setlocale(LC_COLLATE, prev_locale);
 #endif
     MESSAGE1("done (%ld comparisons).\n", idx_gc);
 }
 
+#if defined(MIKTEX)
+static size_t
+add_coll(const char *s)
+{
+    size_t  offset = coll_len;
+    size_t  n = strxfrm(NULL, s, 0) + 1;
+
+    if (coll_len + n > coll_size) {
+	coll_size = 2 * coll_size + n;
+	if ((coll_buf = (char *) realloc(coll_buf, coll_size)) == NULL)
+	    FATAL("Not enough core...abort.\n");
+    }
+    strxfrm(coll_buf + offset, s, n);
+    coll_len += n;
+    return (offset);
+}
+
+static void
+make_sort_keys(void)
+{
+    long    k;
+    int     i;
+    SORT_KEY *key;
+
+    if ((sort_keys = (SORT_KEY *) malloc((idx_gt + 1) * sizeof(SORT_KEY)))
+	== NULL)
+	FATAL("Not enough core...abort.\n");
+    coll_buf = NULL;
+    coll_len = coll_size = 0;
+    for (k = 0; k < idx_gt; k++) {
+	key = &sort_keys[k];
+	for (i = 0; i < FIELD_MAX; i++) {
+	    key->sf_group[i] = group_type(idx_key[k]->sf[i]);
+	    key->af_group[i] = group_type(idx_key[k]->af[i]);
+	    if (locale_sort) {
+		key->sf_coll[i] = add_coll(idx_key[k]->sf[i]);
+		key->af_coll[i] = add_coll(idx_key[k]->af[i]);
+	    }
+	}
+	idx_key[k]->sk = key;
+    }
+}
+
+static void
+free_sort_keys(void)
+{
+    long    k;
+
+    for (k = 0; k < idx_gt; k++)
+	idx_key[k]->sk = NULL;
+    free(sort_keys);
+    sort_keys = NULL;
+    free(coll_buf);
+    coll_buf = NULL;
+}
+
+#define SF_COLL(k, i) (locale_sort ? coll_buf + (k)->sf_coll[i] : NULL)
+#define AF_COLL(k, i) (locale_sort ? coll_buf + (k)->af_coll[i] : NULL)
+#endif
+
 static int
 compare(const void *va, const void *vb)
 {
 #if defined(MIKTEX)
     const FIELD_PTR *a = (FIELD_PTR*)va;
     const FIELD_PTR *b = (FIELD_PTR*)vb;
+    const SORT_KEY *ka = (*a)->sk;
+    const SORT_KEY *kb = (*b)->sk;
 #else
     const FIELD_PTR *a = va;
     const FIELD_PTR *b = vb;
@@ -80,6 +183,17 @@ compare(const void *va, const void *vb)
     IDX_DOT(CMP_MAX);
 
     for (i = 0; i < FIELD_MAX; i++) {
+#if defined(MIKTEX)
+	if ((dif = compare_one((*a)->sf[i], (*b)->sf[i],
+			       ka->sf_group[i], kb->sf_group[i],
+			       SF_COLL(ka, i), SF_COLL(kb, i))) != 0)
+	    break;
+
+	if ((dif = compare_one((*a)->af[i], (*b)->af[i],
+			       ka->af_group[i], kb->af_group[i],
+			       AF_COLL(ka, i), AF_COLL(kb, i))) != 0)
+	    break;
+#else
 	/* compare the sort fields */
 	if ((dif = compare_one((*a)->sf[i], (*b)->sf[i])) != 0)
 	    break;
@@ -87,6 +201,7 @@ compare(const void *va, const void *vb)
 	/* compare the actual fields */
 	if ((dif = compare_one((*a)->af[i], (*b)->af[i])) != 0)
 	    break;
+#endif
     }
 
     /* both key aggregates are identical, compare page numbers */
@@ -95,11 +210,18 @@ compare(const void *va, const void *vb)
     return (dif);
 }
 
+#if defined(MIKTEX)
+static int
+compare_one(const char *x, const char *y, int m, int n,
+	    const char *cx, const char *cy)
+{
+#else
 static int
 compare_one(const char *x, const char *y)
 {
     int     m;
     int     n;
+#endif
 
     if ((x[0] == NUL) && (y[0] == NUL))
 	return (0);
@@ -110,8 +232,10 @@ compare_one(const char *x, const char *y)
     if (y[0] == NUL)
 	return (1);
 
+#if !defined(MIKTEX)
     m = group_type(x);
     n = group_type(y);
+#endif
 
     /* both pure digits */
     if ((m >= 0) && (n >= 0))
@@ -133,7 +257,11 @@ compare_one(const char *x, const char *y)
     }
     /* strings started with a symbol (including digit) */
     if ((m == SYMBOL) && (n == SYMBOL))
+#if defined(MIKTEX)
+	return (check_mixsym(x, y, cx, cy));
+#else
 	return (check_mixsym(x, y));
+#endif
 
     /* x symbol, y non-symbol */
     if (m == SYMBOL)
@@ -144,11 +272,29 @@ compare_one(const char *x, const char *y)
 	return (1);
 
     /* strings with a leading letter, the ALPHA type */
+#if defined(MIKTEX)
+    return (compare_string((const unsigned char*)x, (const unsigned char*)y,
+			   cx, cy));
+#else
     return (compare_string((const unsigned char*)x, (const unsigned char*)y));
+#endif
+}
+
+#if defined(MIKTEX)
+static int
+collate(const char *x, const char *y, const char *cx, const char *cy)
+{
+    if ((cx != NULL) && (cy != NULL))
+	return (strcmp(cx, cy));
+    return (strcoll(x, y));
 }
 
+static int
+check_mixsym(const char *x, const char *y, const char *cx, const char *cy)
+#else
 static int
 check_mixsym(const char *x, const char *y)
+#endif
 {
     int     m;
     int     n;
@@ -162,19 +308,33 @@ check_mixsym(const char *x, const char *y)
     if (!m && n)
 	return (-1);
 
+#if defined(MIKTEX)
+    return (locale_sort ? collate(x, y, cx, cy) : strcmp(x, y));
+#else
     return (locale_sort ? strcoll(x, y) : strcmp(x, y));
+#endif
 }
 
 
+#if defined(MIKTEX)
+static int
+compare_string(const unsigned char *a, const unsigned char *b,
+	       const char *ca, const char *cb)
+#else
 static int
 compare_string(const unsigned char *a, const unsigned char *b)
+#endif
 {
     int     i = 0;
     int     j = 0;
     int     al;
     int     bl;
 
+#if defined(MIKTEX)
+    if (locale_sort) return collate((const char *)a, (const char *)b, ca, cb);
+#else
     if (locale_sort) return strcoll((const char *)a, (const char *)b);
+#endif
 
     while ((a[i] != NUL) || (b[j] != NUL)) {
 	if (a[i] == NUL)
@@ -286,8 +446,14 @@ compare_page(const FIELD_PTR *a, const FIELD_PTR *b)
 		    m = (*a)->lc - (*b)->lc; /* order by input line number */
 		else			/* order non-range items by */
 					/* their encap strings */
+#if defined(MIKTEX)
+		    m = compare_string((const unsigned char*)((*a)->encap),
+				       (const unsigned char*)((*b)->encap),
+				       NULL, NULL);
+#else
 		    m = compare_string((const unsigned char*)((*a)->encap),
 				       (const unsigned char*)((*b)->encap));
+#endif
 	    }
 	}
 	else if ((i == (*a)->count) && (i < (*b)->count))
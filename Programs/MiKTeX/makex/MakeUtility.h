@@ -34,6 +34,7 @@
 
 #include <miktex/Core/CommandLineBuilder>
 #include <miktex/Core/Directory>
+#include <miktex/Core/Exceptions>
 #include <miktex/Core/File>
 #include <miktex/Core/PathName>
 #include <miktex/Core/Paths>
@@ -302,7 +303,19 @@ protected:
     if (!printOnly)
     {
       Verbose(fmt::format(T_("Installing {0}..."), Q_(dest)));
-      MiKTeX::Core::File::Copy(source, dest, { MiKTeX::Core::FileCopyOption::ReplaceExisting, MiKTeX::Core::FileCopyOption::UpdateFndb });
+      // copy next to the destination and rename, so that concurrent
+      // readers see either the old or the new file, never a partial one
+      MiKTeX::Core::PathName tmp(dest.ToString() + fmt::format(".{}.tmp", MiKTeX::Core::Process::GetCurrentProcess()->GetSystemId()));
+      MiKTeX::Core::File::Copy(source, tmp, { MiKTeX::Core::FileCopyOption::ReplaceExisting });
+      try
+      {
+        MiKTeX::Core::File::Move(tmp, dest, { MiKTeX::Core::FileMoveOption::ReplaceExisting, MiKTeX::Core::FileMoveOption::UpdateFndb });
+      }
+      catch (const MiKTeX::Core::MiKTeXException&)
+      {
+        MiKTeX::Core::File::Delete(tmp);
+        throw;
+      }
     }
   }
 
@@ -0,0 +1,100 @@
+## memory-report.cmake: check the output of --memory-report  -*- CMake -*-
+##
+## Copyright (C) 2026 agent
+## 
+## This file is free software; you can redistribute it and/or modify
+## it under the terms of the GNU General Public License as published
+## by the Free Software Foundation; either version 2, or (at your
+## option) any later version.
+## 
+## This file is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+## General Public License for more details.
+## 
+## You should have received a copy of the GNU General Public License
+## along with this file; if not, write to the Free Software
+## Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+## USA.
+
+## Runs INITEX on three small jobs: an empty one, one which shows a
+## long \message (the string is flushed right after it has been
+## printed), and one which stops with a fatal error.  Every report
+## must parse as JSON, no array may have used more than it has
+## allocated, and the string pool peak must cover the flushed
+## message.
+
+cmake_minimum_required(VERSION 3.19)
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR}/config ${WORK_DIR}/data ${WORK_DIR}/install)
+
+set(ENV{MIKTEX_USERCONFIG} ${WORK_DIR}/config)
+set(ENV{MIKTEX_USERDATA} ${WORK_DIR}/data)
+set(ENV{MIKTEX_USERINSTALL} ${WORK_DIR}/install)
+
+set(MESSAGE_LENGTH 20000)
+string(REPEAT "x" ${MESSAGE_LENGTH} long_message)
+
+file(WRITE ${WORK_DIR}/empty.tex "\\end\n")
+file(WRITE ${WORK_DIR}/message.tex "\\catcode`\\{=1 \\catcode`\\}=2\n\\message{${long_message}}\n\\end\n")
+file(WRITE ${WORK_DIR}/fatal.tex "\\input memory-report-missing-file\n\\end\n")
+
+# runs JOB and checks its report; sets <JOB>_strpool_peak
+function(run_job job expected_exit_code)
+  execute_process(
+    COMMAND ${TEX} -ini -interaction=nonstopmode --disable-installer --memory-report=${job}.json ${job}.tex
+    WORKING_DIRECTORY ${WORK_DIR}
+    OUTPUT_QUIET
+    ERROR_QUIET
+    RESULT_VARIABLE exit_code
+  )
+  if(NOT exit_code EQUAL expected_exit_code)
+    message(FATAL_ERROR "${job}: exit code ${exit_code}, expected ${expected_exit_code}")
+  endif()
+  if(NOT EXISTS ${WORK_DIR}/${job}.json)
+    message(FATAL_ERROR "${job}: no memory report")
+  endif()
+  file(READ ${WORK_DIR}/${job}.json report)
+  string(JSON finished ERROR_VARIABLE error GET "${report}" finished)
+  if(error)
+    message(FATAL_ERROR "${job}: ${error}\n${report}")
+  endif()
+  if(NOT finished)
+    message(FATAL_ERROR "${job}: the job did not finish")
+  endif()
+  string(JSON num_arrays LENGTH "${report}" arrays)
+  if(num_arrays EQUAL 0)
+    message(FATAL_ERROR "${job}: no arrays reported")
+  endif()
+  math(EXPR last "${num_arrays} - 1")
+  set(strpool_peak "")
+  foreach(idx RANGE ${last})
+    string(JSON name GET "${report}" arrays ${idx} name)
+    string(JSON allocated GET "${report}" arrays ${idx} allocated)
+    string(JSON peak_type TYPE "${report}" arrays ${idx} peak_used)
+    if(peak_type STREQUAL "NULL")
+      continue()
+    endif()
+    string(JSON peak GET "${report}" arrays ${idx} peak_used)
+    if(peak GREATER allocated)
+      message(FATAL_ERROR "${job}: ${name}: peak ${peak} exceeds the allocated ${allocated} bytes")
+    endif()
+    if(name STREQUAL "strpool")
+      set(strpool_peak ${peak})
+    endif()
+  endforeach()
+  if(strpool_peak STREQUAL "")
+    message(FATAL_ERROR "${job}: no string pool peak")
+  endif()
+  set(${job}_strpool_peak ${strpool_peak} PARENT_SCOPE)
+endfunction()
+
+run_job(empty 0)
+run_job(message 0)
+run_job(fatal 1)
+
+math(EXPR growth "${message_strpool_peak} - ${empty_strpool_peak}")
+if(growth LESS MESSAGE_LENGTH)
+  message(FATAL_ERROR "string pool peak grew by ${growth} bytes, expected at least ${MESSAGE_LENGTH}")
+endif()
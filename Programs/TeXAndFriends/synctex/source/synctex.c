@@ -564,6 +564,245 @@ static const char *synctex_suffix_busy = "(busy)";
 /*  for kpse_absolute_p */
 #   include <kpathsea/absolute.h>
 
+#if defined(MIKTEX)
+/*  Option 16 asks for a sidecar index foo.synctex.idx, written at the end
+ *  of the run.  It records the inputs, the file offset of each sheet and the
+ *  sheets where each input tag has synchronized nodes.  Each sheet starts a
+ *  new gzip member, such that a client can decompress one sheet without
+ *  inflating everything in front of it.  Forms are not indexed.  */
+#   define SYNCTEX_WITH_INDEX (((synctex_ctxt.options)&16)!=0 && !SYNCTEX_WITH_FORMS)
+static const char *synctex_suffix_idx = ".idx";
+typedef struct {
+    integer sheet;
+    long offset;
+} synctex_index_sheet_t;
+typedef struct {
+    char *name;
+    integer *sheets;
+    size_t count;
+    size_t capacity;
+} synctex_index_tag_t;
+static struct {
+    synctex_index_sheet_t *sheets;
+    size_t sheet_count;
+    size_t sheet_capacity;
+    synctex_index_tag_t *tags;
+    size_t tag_capacity;
+    integer sheet;              /*  the sheet being shipped out, 0 outside */
+    long postamble;
+    char gz_mode[8];            /*  the mode for reopening the gzip file */
+} synctex_index = {NULL, 0, 0, NULL, 0, 0, -1, ""};
+
+static void synctex_index_free(void)
+{
+    size_t i;
+    for (i = 0; i < synctex_index.tag_capacity; ++i) {
+        SYNCTEX_FREE(synctex_index.tags[i].name);
+        SYNCTEX_FREE(synctex_index.tags[i].sheets);
+    }
+    SYNCTEX_FREE(synctex_index.tags);
+    SYNCTEX_FREE(synctex_index.sheets);
+    memset(&synctex_index, 0, sizeof(synctex_index));
+    synctex_index.postamble = -1;
+}
+
+static synctex_index_tag_t *synctex_index_get_tag(integer tag)
+{
+    if (tag <= 0) {
+        return NULL;
+    }
+    if ((size_t)tag >= synctex_index.tag_capacity) {
+        size_t capacity = synctex_index.tag_capacity ? synctex_index.tag_capacity : 64;
+        while (capacity <= (size_t)tag) {
+            capacity *= 2;
+        }
+        synctex_index.tags = (synctex_index_tag_t *)xrealloc(synctex_index.tags, capacity * sizeof(synctex_index_tag_t));
+        memset(synctex_index.tags + synctex_index.tag_capacity, 0, (capacity - synctex_index.tag_capacity) * sizeof(synctex_index_tag_t));
+        synctex_index.tag_capacity = capacity;
+    }
+    return synctex_index.tags + tag;
+}
+
+static void synctex_index_input(integer tag, const char *name)
+{
+    synctex_index_tag_t *t;
+    if (!SYNCTEX_WITH_INDEX || NULL == (t = synctex_index_get_tag(tag))) {
+        return;
+    }
+    SYNCTEX_FREE(t->name);
+    t->name = xstrdup(name);
+}
+
+/*  Called for each synchronized node: remember that tag occurs on the current sheet.  */
+static inline void synctex_index_tag(integer tag)
+{
+    synctex_index_tag_t *t;
+    if (synctex_index.sheet <= 0 || !SYNCTEX_WITH_INDEX || NULL == (t = synctex_index_get_tag(tag))) {
+        return;
+    }
+    if (t->count > 0 && t->sheets[t->count - 1] == synctex_index.sheet) {
+        return;
+    }
+    if (t->count == t->capacity) {
+        t->capacity = t->capacity ? 2 * t->capacity : 8;
+        t->sheets = (integer *)xrealloc(t->sheets, t->capacity * sizeof(integer));
+    }
+    t->sheets[t->count++] = synctex_index.sheet;
+}
+#   define SYNCTEX_INDEX_TAG(TAG) synctex_index_tag(TAG)
+
+/*  Remember the mode the gzip file was opened with: new members are
+ *  appended with the same compression level and strategy.  */
+static void synctex_index_set_gz_mode(const char *mode)
+{
+    size_t i;
+    for (i = 0; mode[i] && i + 1 < sizeof(synctex_index.gz_mode); ++i) {
+        synctex_index.gz_mode[i] = (mode[i] == 'w' ? 'a' : mode[i]);
+    }
+    synctex_index.gz_mode[i] = '\0';
+}
+
+/*  Start a new gzip member (or flush the plain file) and return its file offset, -1 on error.  */
+static long synctex_index_restart(void)
+{
+    if (SYNCTEX_NO_GZ) {
+        if (fflush((FILE *) SYNCTEX_FILE) != 0) {
+            return -1;
+        }
+        return ftell((FILE *) SYNCTEX_FILE);
+    }
+    gzclose((gzFile) SYNCTEX_FILE);
+    SYNCTEX_FILE = gzopen(synctex_ctxt.busy_name, synctex_index.gz_mode);
+    if (NULL == SYNCTEX_FILE) {
+        return -1;
+    }
+    return (long)gzoffset((gzFile) SYNCTEX_FILE);
+}
+
+static int synctex_index_begin_sheet(integer sheet)
+{
+    long offset;
+    if (!SYNCTEX_WITH_INDEX) {
+        return SYNCTEX_NOERR;
+    }
+    if ((offset = synctex_index_restart()) < 0) {
+        return -1;
+    }
+    if (synctex_index.sheet_count == synctex_index.sheet_capacity) {
+        synctex_index.sheet_capacity = synctex_index.sheet_capacity ? 2 * synctex_index.sheet_capacity : 64;
+        synctex_index.sheets = (synctex_index_sheet_t *)xrealloc(synctex_index.sheets, synctex_index.sheet_capacity * sizeof(synctex_index_sheet_t));
+    }
+    synctex_index.sheets[synctex_index.sheet_count].sheet = sheet;
+    synctex_index.sheets[synctex_index.sheet_count].offset = offset;
+    ++synctex_index.sheet_count;
+    synctex_index.sheet = sheet;
+    return SYNCTEX_NOERR;
+}
+
+static int synctex_index_begin_postamble(void)
+{
+    synctex_index.sheet = 0;
+    if (!SYNCTEX_WITH_INDEX) {
+        return SYNCTEX_NOERR;
+    }
+    return (synctex_index.postamble = synctex_index_restart()) < 0 ? -1 : SYNCTEX_NOERR;
+}
+
+/*  The name of the index of foo.synctex(.gz): foo.synctex.idx  */
+static char *synctex_index_name(const char *real_syncname)
+{
+    size_t len = strlen(real_syncname);
+    char *idx_name = (char *)xmalloc(len + strlen(synctex_suffix_idx) + 1);
+    strcpy(idx_name, real_syncname);
+    if (len > strlen(synctex_suffix_gz) && 0 == strcmp(idx_name + len - strlen(synctex_suffix_gz), synctex_suffix_gz)) {
+        idx_name[len - strlen(synctex_suffix_gz)] = '\0';
+    }
+    strcat(idx_name, synctex_suffix_idx);
+    return idx_name;
+}
+
+/*  Remove the index written by a previous run.  */
+static void synctex_index_remove(const char *real_syncname)
+{
+    char *idx_name = synctex_index_name(real_syncname);
+    remove(idx_name);
+    SYNCTEX_FREE(idx_name);
+}
+
+/*  The length and the CRC-32 of the file contents; -1, if the file cannot be read.  */
+static long synctex_index_checksum(const char *path, unsigned long *crc)
+{
+    unsigned char buffer[16384];
+    long length = 0;
+    size_t n;
+    FILE *f = fopen(path, FOPEN_RBIN_MODE);
+    if (NULL == f) {
+        return -1;
+    }
+    *crc = crc32(0L, Z_NULL, 0);
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        *crc = crc32(*crc, buffer, (uInt)n);
+        length += (long)n;
+    }
+    if (ferror(f)) {
+        length = -1;
+    }
+    fclose(f);
+    return length;
+}
+
+/*  Write foo.synctex.idx next to foo.synctex(.gz), or remove a stale one.
+ *  The length and the checksum of the synctex file are recorded such that
+ *  clients can detect an index that does not belong to the synctex file,
+ *  even if a later run wrote a file of the same length. */
+static void synctex_index_write(const char *real_syncname)
+{
+    char *idx_name = synctex_index_name(real_syncname);
+    FILE *f;
+    long length;
+    unsigned long crc = 0;
+    size_t i, j;
+    remove(idx_name);
+    if (!SYNCTEX_WITH_INDEX || synctex_index.postamble < 0) {
+        SYNCTEX_FREE(idx_name);
+        return;
+    }
+    length = synctex_index_checksum(real_syncname, &crc);
+    if (length < 0 || NULL == (f = fopen(idx_name, FOPEN_W_MODE))) {
+        SYNCTEX_FREE(idx_name);
+        return;
+    }
+    fprintf(f, "SyncTeX Index:1\nLength:%ld\nChecksum:%08lx\n", length, crc);
+    for (i = 0; i < synctex_index.tag_capacity; ++i) {
+        if (synctex_index.tags[i].name) {
+            fprintf(f, "Input:%i:%s\n", (int)i, synctex_index.tags[i].name);
+        }
+    }
+    for (i = 0; i < synctex_index.sheet_count; ++i) {
+        fprintf(f, "Sheet:%i:%ld\n", synctex_index.sheets[i].sheet, synctex_index.sheets[i].offset);
+    }
+    fprintf(f, "Postamble:%ld\n", synctex_index.postamble);
+    for (i = 0; i < synctex_index.tag_capacity; ++i) {
+        if (synctex_index.tags[i].count > 0) {
+            fprintf(f, "Tag:%i:", (int)i);
+            for (j = 0; j < synctex_index.tags[i].count; ++j) {
+                fprintf(f, j > 0 ? ",%i" : "%i", synctex_index.tags[i].sheets[j]);
+            }
+            fputc('\n', f);
+        }
+    }
+    if (ferror(f)) {
+        fclose(f);
+        remove(idx_name);
+    } else {
+        fclose(f);
+    }
+    SYNCTEX_FREE(idx_name);
+}
+#else
+#   define SYNCTEX_INDEX_TAG(TAG)
+#endif
+
 #ifdef W32UPTEXSYNCTEX
 static char *chgto_oem(char *src)
 {
@@ -719,6 +958,9 @@ static void *synctex_dot_open(void)
             } else {
                 SYNCTEX_FILE = gzopen(the_busy_name, FOPEN_WBIN_MODE);
                 synctex_ctxt.fprintf = (synctex_fprintf_t) (&gzprintf);
+#if defined(MIKTEX)
+                synctex_index_set_gz_mode(FOPEN_WBIN_MODE);
+#endif
             }
 #   if SYNCTEX_DEBUG
             printf("\nwarning: Synchronize DEBUG: synctex_dot_open 2\n");
@@ -979,8 +1221,15 @@ void synctexterminate(boolean log_opened)
                     "SyncTeX: Can't remove %s (file is open or read only)\n",
                     the_real_syncname);
         }
+#if defined(MIKTEX)
+        /*  the index goes with the synctex file of the previous run */
+        synctex_index_remove(the_real_syncname);
+#endif
         if (SYNCTEX_FILE) {
             if (SYNCTEX_NOT_VOID) {
+#if defined(MIKTEX)
+                synctex_index_begin_postamble();
+#endif
                 synctex_record_postamble();
                 /* close the synctex file */
                 if (SYNCTEX_NO_GZ) {
@@ -1008,6 +1257,10 @@ void synctexterminate(boolean log_opened)
 #endif
                 /*  renaming the working synctex file */
                 if (0 == rename(synctex_ctxt.busy_name, the_real_syncname)) {
+#if defined(MIKTEX)
+                    synctex_index_write(the_real_syncname);
+                    synctex_index_free();
+#endif
                     if (log_opened) {
                         tmp = the_real_syncname;
 #                       if SYNCTEX_DO_NOT_LOG_OUTPUT_DIRECTORY
@@ -1121,6 +1374,10 @@ void synctexterminate(boolean log_opened)
         remove(the_real_syncname);
         strcat(the_real_syncname, synctex_suffix_gz);
         remove(the_real_syncname);
+#if defined(MIKTEX)
+        synctex_index_remove(the_real_syncname);
+        synctex_index_free();
+#endif
         if (SYNCTEX_FILE) {
             /* close the synctex file */
             if (SYNCTEX_NO_GZ) {
@@ -1438,6 +1695,7 @@ void synctexvlist(halfword this_box)
     synctex_ctxt.node = this_box;   /*  0 to reset  */
     synctex_ctxt.recorder = NULL;   /*  reset  */
     synctex_ctxt.tag = SYNCTEX_TAG_MODEL(this_box,box);
+    SYNCTEX_INDEX_TAG(synctex_ctxt.tag);
     synctex_ctxt.line = SYNCTEX_LINE_MODEL(this_box,box);
     synctex_ctxt.curh = SYNCTEX_CURH;
     synctex_ctxt.curv = SYNCTEX_CURV;
@@ -1462,6 +1720,7 @@ void synctextsilv(halfword this_box)
     /*  Ignoring any pending info to be recorded  */
     synctex_ctxt.node = this_box; /*  0 to reset  */
     synctex_ctxt.tag = SYNCTEX_TAG_MODEL(this_box,box);
+    SYNCTEX_INDEX_TAG(synctex_ctxt.tag);
     synctex_ctxt.line = SYNCTEX_LINE_MODEL(this_box,box);
     synctex_ctxt.curh = SYNCTEX_CURH;
     synctex_ctxt.curv = SYNCTEX_CURV;
@@ -1484,6 +1743,7 @@ void synctexvoidvlist(halfword p, halfword this_box __attribute__ ((unused)))
     }
     synctex_ctxt.node = p;          /*  reset  */
     synctex_ctxt.tag = SYNCTEX_TAG_MODEL(p,box);
+    SYNCTEX_INDEX_TAG(synctex_ctxt.tag);
     synctex_ctxt.line = SYNCTEX_LINE_MODEL(p,box);
     synctex_ctxt.curh = SYNCTEX_CURH;
     synctex_ctxt.curv = SYNCTEX_CURV;
@@ -1508,6 +1768,7 @@ void synctexhlist(halfword this_box)
     }
     synctex_ctxt.node = this_box;   /*  0 to reset  */
     synctex_ctxt.tag = SYNCTEX_TAG_MODEL(this_box,box);
+    SYNCTEX_INDEX_TAG(synctex_ctxt.tag);
     synctex_ctxt.line = SYNCTEX_LINE_MODEL(this_box,box);
     synctex_ctxt.curh = SYNCTEX_CURH;
     synctex_ctxt.curv = SYNCTEX_CURV;
@@ -1533,6 +1794,7 @@ void synctextsilh(halfword this_box)
     /*  Ignoring any pending info to be recorded  */
     synctex_ctxt.node = this_box;     /*  0 to force next node to be recorded!  */
     synctex_ctxt.tag = SYNCTEX_TAG_MODEL(this_box,box);
+    SYNCTEX_INDEX_TAG(synctex_ctxt.tag);
     synctex_ctxt.line = SYNCTEX_LINE_MODEL(this_box,box);
     synctex_ctxt.curh = SYNCTEX_CURH;
     synctex_ctxt.curv = SYNCTEX_CURV;
@@ -1560,6 +1822,7 @@ void synctexvoidhlist(halfword p, halfword this_box __attribute__ ((unused)))
     }
     synctex_ctxt.node = p;          /*  0 to reset  */
     synctex_ctxt.tag = SYNCTEX_TAG_MODEL(p,box);
+    SYNCTEX_INDEX_TAG(synctex_ctxt.tag);
     synctex_ctxt.line = SYNCTEX_LINE_MODEL(p,box);
     synctex_ctxt.curh = SYNCTEX_CURH;
     synctex_ctxt.curv = SYNCTEX_CURV;
@@ -1599,6 +1862,7 @@ void synctexmath(halfword p, halfword this_box __attribute__ ((unused)))
     }
     synctex_ctxt.node = p;
     synctex_ctxt.tag = SYNCTEX_TAG_MODEL(p,math);
+    SYNCTEX_INDEX_TAG(synctex_ctxt.tag);
     synctex_ctxt.line = SYNCTEX_LINE_MODEL(p,math);
     synctex_ctxt.curh = SYNCTEX_CURH;
     synctex_ctxt.curv = SYNCTEX_CURV;
@@ -1649,16 +1913,19 @@ void synctexhorizontalruleorglue(halfword p, halfword this_box
     switch (SYNCTEX_TYPE(p)) {
         case rule_node:
             synctex_ctxt.tag = SYNCTEX_TAG_MODEL(p,rule);
+            SYNCTEX_INDEX_TAG(synctex_ctxt.tag);
             synctex_ctxt.line = SYNCTEX_LINE_MODEL(p,rule);
             synctex_record_node_rule(p); /*  always record synchronously: maybe some text is outside the box  */
             break;
         case glue_node:
             synctex_ctxt.tag = SYNCTEX_TAG_MODEL(p,glue);
+            SYNCTEX_INDEX_TAG(synctex_ctxt.tag);
             synctex_ctxt.line = SYNCTEX_LINE_MODEL(p,glue);
             synctex_record_node_glue(p); /*  always record synchronously: maybe some text is outside the box  */
             break;
         case kern_node:
             synctex_ctxt.tag = SYNCTEX_TAG_MODEL(p,kern);
+            SYNCTEX_INDEX_TAG(synctex_ctxt.tag);
             synctex_ctxt.line = SYNCTEX_LINE_MODEL(p,kern);
             synctex_record_node_kern(p); /*  always record synchronously: maybe some text is outside the box  */
             break;
@@ -1688,11 +1955,13 @@ void synctexkern(halfword p, halfword this_box)
             /* first node in the list */
             synctex_ctxt.node = p;
             synctex_ctxt.tag = SYNCTEX_TAG_MODEL(p,kern);
+            SYNCTEX_INDEX_TAG(synctex_ctxt.tag);
             synctex_ctxt.line = SYNCTEX_LINE_MODEL(p,kern);
             synctex_ctxt.recorder = &synctex_record_node_kern;
         } else {
             synctex_ctxt.node = p;
             synctex_ctxt.tag = SYNCTEX_TAG_MODEL(p,kern);
+            SYNCTEX_INDEX_TAG(synctex_ctxt.tag);
             synctex_ctxt.line = SYNCTEX_LINE_MODEL(p,kern);
             synctex_ctxt.recorder = NULL;
             /*  always record when the context has just changed
@@ -1703,6 +1972,7 @@ void synctexkern(halfword p, halfword this_box)
         /*  just update the geometry and type (for future improvements)  */
         synctex_ctxt.node = p;
         synctex_ctxt.tag = SYNCTEX_TAG_MODEL(p,kern);
+        SYNCTEX_INDEX_TAG(synctex_ctxt.tag);
         synctex_ctxt.line = SYNCTEX_LINE_MODEL(p,kern);
         synctex_ctxt.recorder = &synctex_record_node_kern;
     }
@@ -1842,6 +2112,9 @@ static inline int synctex_record_input(integer tag, char *name)
     len = SYNCTEX_fprintf(SYNCTEX_FILE, "Input:%i:%s\n", tag, name);
     if (len > 0) {
         synctex_ctxt.total_length += len;
+#if defined(MIKTEX)
+        synctex_index_input(tag, name);
+#endif
         return SYNCTEX_NOERR;
     }
     synctexabort(0);
@@ -1892,6 +2165,12 @@ static inline int synctex_record_sheet(integer sheet)
 #   if SYNCTEX_DEBUG > 999
     printf("\nSynchronize DEBUG: synctex_record_sheet\n");
 #   endif
+#if defined(MIKTEX)
+    if (SYNCTEX_NOERR != synctex_index_begin_sheet(sheet)) {
+        synctexabort(0);
+        return -1;
+    }
+#endif
     if (SYNCTEX_NOERR == synctex_record_anchor()) {
         int len = SYNCTEX_fprintf(SYNCTEX_FILE, "{%i\n", sheet);
         SYNCTEX_RECORD_LEN_AND_RETURN_NOERR;
@@ -105,6 +105,13 @@
 #include <string.h>
 #include <errno.h>
 #include <limits.h>
+#if defined(MIKTEX)
+#   if defined(_WIN32)
+#       include <io.h>
+#   else
+#       include <unistd.h>
+#   endif
+#endif
 
 #if defined(HAVE_LOCALE_H)
 #include <locale.h>
@@ -785,6 +792,33 @@ synctex_reader_p synctex_reader_init_with_output_file(synctex_reader_p reader, c
  *  Is is initialized with the contents of a text file or a gzipped file.
  *  The buffer_.* are first used to parse the text.
  */
+#if defined(MIKTEX)
+/*  The sidecar index, see _synctex_scanner_read_index */
+typedef struct {
+    int page;
+    long offset;
+    synctex_bool_t wanted;
+    synctex_bool_t loaded;
+} synctex_index_sheet_s;
+
+typedef struct {
+    int tag;
+    int * pages;
+    int count;
+} synctex_index_tag_s;
+
+struct synctex_index_t {
+    synctex_index_sheet_s * sheets;
+    int sheet_count;
+    synctex_index_tag_s * tags;
+    int tag_count;
+    long postamble;
+    synctex_bool_t loading;
+};
+
+typedef struct synctex_index_t synctex_index_s;
+typedef synctex_index_s * synctex_index_p;
+#endif
 struct synctex_scanner_t {
     synctex_reader_p reader;
     SYNCTEX_DECLARE_NODE_COUNT
@@ -815,6 +849,9 @@ struct synctex_scanner_t {
     synctex_class_s class_[synctex_node_number_of_types]; /*  The classes of the nodes of the scanner */
     int display_switcher;
     char * display_prompt;
+#if defined(MIKTEX)
+    synctex_index_p index;  /*  The sidecar index, NULL when the whole content was parsed */
+#endif
 };
 
 /**
@@ -4714,6 +4751,21 @@ static synctex_ns_s _synctex_parse_new_sheet(synctex_scanner_p scanner) {
             _synctex_error("Missing end of sheet.");
         } else {
             /* Now set the owner */
+#if defined(MIKTEX)
+            if (scanner->index && scanner->sheet && _synctex_data_page(scanner->sheet) > _synctex_data_page(node)) {
+                /*  Sheets loaded on demand may come in any order */
+                __synctex_tree_set_sibling(node,scanner->sheet);
+                scanner->sheet = node;
+            } else if (scanner->index && scanner->sheet) {
+                synctex_node_p last_sheet = scanner->sheet;
+                synctex_node_p next_sheet = NULL;
+                while ((next_sheet = __synctex_tree_sibling(last_sheet)) && _synctex_data_page(next_sheet) < _synctex_data_page(node)) {
+                    last_sheet = next_sheet;
+                }
+                __synctex_tree_set_sibling(node,next_sheet);
+                __synctex_tree_set_sibling(last_sheet,node);
+            } else
+#endif
             if (scanner->sheet) {
                 synctex_node_p last_sheet = scanner->sheet;
                 synctex_node_p next_sheet = NULL;
@@ -5644,6 +5696,12 @@ _synctex_make_hbox_contain_box(parent,_synctex_data_box(child));
                     _synctex_error("Missing anchor.");
                 }
                 parent = sheet = NULL;
+#if defined(MIKTEX)
+                if (scanner->index && scanner->index->loading) {
+                    /*  Sheets are loaded one at a time */
+                    SYNCTEX_RETURN(SYNCTEX_STATUS_OK);
+                }
+#endif
                 goto main_loop;
             }
         } else if (SYNCTEX_START_SCAN(END_FORM)) {
@@ -5972,6 +6030,374 @@ content_not_found:
     }
     return status;
 }
+#if defined(MIKTEX)
+#	ifdef SYNCTEX_NOTHING
+#       pragma mark -
+#       pragma mark INDEX
+#   endif
+/*  The engines write foo.synctex.idx when asked to (-synctex=17).
+ *  It records the inputs, the file offset of each sheet and of the postamble,
+ *  and the pages where each input tag occurs.  Each recorded offset is the
+ *  start of a gzip member, such that decompression can start there.
+ *  When a valid index is available, the content is not parsed up front:
+ *  sheets are loaded when a query needs them.  */
+static const char * synctex_suffix_idx = ".idx";
+
+static void _synctex_index_free(synctex_index_p index) {
+    if (index) {
+        int i;
+        for (i = 0; i < index->tag_count; ++i) {
+            _synctex_free(index->tags[i].pages);
+        }
+        _synctex_free(index->tags);
+        _synctex_free(index->sheets);
+        _synctex_free(index);
+    }
+}
+
+/*  Read one line of the index, without the line terminator.
+ *  Returns NULL at the end of the file. */
+static char * _synctex_index_get_line(FILE * file, char ** buffer, size_t * capacity) {
+    size_t length = 0;
+    if (NULL == *buffer) {
+        *capacity = 256;
+        if (NULL == (*buffer = (char *)_synctex_malloc(*capacity))) {
+            return NULL;
+        }
+    }
+    while (fgets(*buffer+length, (int)(*capacity-length), file)) {
+        length += strlen(*buffer+length);
+        if (length > 0 && (*buffer)[length-1] == '\n') {
+            (*buffer)[--length] = '\0';
+            if (length > 0 && (*buffer)[length-1] == '\r') {
+                (*buffer)[--length] = '\0';
+            }
+            return *buffer;
+        }
+        if (length+1 < *capacity) {
+            /*  Last line without line terminator */
+            return *buffer;
+        }
+        {
+            char * larger = (char *)realloc(*buffer, 2 * *capacity);
+            if (NULL == larger) {
+                return NULL;
+            }
+            *buffer = larger;
+            *capacity *= 2;
+        }
+    }
+    return length > 0 ? *buffer : NULL;
+}
+
+/*  The length and the CRC-32 of the file contents; -1, if the file cannot be read.
+ *  Reading the bytes is much cheaper than parsing the content.  */
+static long _synctex_file_checksum(const char * path, unsigned long * crc) {
+    unsigned char buffer[16384];
+    long length = 0;
+    size_t n;
+    FILE * file = fopen(path, "rb");
+    if (NULL == file) {
+        return -1;
+    }
+    *crc = crc32(0L, Z_NULL, 0);
+    while ((n = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        *crc = crc32(*crc, buffer, (uInt)n);
+        length += (long)n;
+    }
+    if (ferror(file)) {
+        length = -1;
+    }
+    fclose(file);
+    return length;
+}
+
+/*  Create the input node for tag unless the preamble already did. */
+static synctex_status_t _synctex_index_add_input(synctex_scanner_p scanner, int tag, const char * name) {
+    synctex_node_p input = NULL;
+    char * copy = NULL;
+    if (synctex_scanner_input_with_tag(scanner, tag)) {
+        return SYNCTEX_STATUS_OK;
+    }
+    if (NULL == (input = _synctex_new_input(scanner))) {
+        return SYNCTEX_STATUS_ERROR;
+    }
+    if (NULL == (copy = (char *)_synctex_malloc(strlen(name)+1))) {
+        synctex_node_free(input);
+        return SYNCTEX_STATUS_ERROR;
+    }
+    strcpy(copy, name);
+    _synctex_data_set_tag(input, tag);
+    _synctex_data_set_name(input, copy);
+    __synctex_tree_set_sibling(input, scanner->input);
+    scanner->input = input;
+    return SYNCTEX_STATUS_OK;
+}
+
+static synctex_status_t _synctex_index_add_tag(synctex_index_p index, int tag, const char * pages) {
+    synctex_index_tag_s * t = NULL;
+    int capacity = 1;
+    const char * ptr;
+    char * end = NULL;
+    if (0 == (index->tag_count & (index->tag_count - 1))) {
+        /*  tag_count is 0 or a power of 2: grow */
+        synctex_index_tag_s * tags = (synctex_index_tag_s *)realloc(index->tags, (index->tag_count ? 2 * index->tag_count : 16) * sizeof(synctex_index_tag_s));
+        if (NULL == tags) {
+            return SYNCTEX_STATUS_ERROR;
+        }
+        index->tags = tags;
+    }
+    for (ptr = pages; *ptr; ++ptr) {
+        if (*ptr == ',') {
+            ++capacity;
+        }
+    }
+    t = index->tags + index->tag_count;
+    t->tag = tag;
+    t->count = 0;
+    if (NULL == (t->pages = (int *)_synctex_malloc(capacity * sizeof(int)))) {
+        return SYNCTEX_STATUS_ERROR;
+    }
+    ++index->tag_count;
+    for (ptr = pages; *ptr && t->count < capacity; ptr = (*end == ',' ? end + 1 : end)) {
+        t->pages[t->count] = (int)strtol(ptr, &end, 10);
+        if (end == ptr) {
+            return SYNCTEX_STATUS_ERROR;
+        }
+        ++t->count;
+    }
+    return SYNCTEX_STATUS_OK;
+}
+
+static synctex_status_t _synctex_index_add_sheet(synctex_index_p index, int page, long offset) {
+    if (0 == (index->sheet_count & (index->sheet_count - 1))) {
+        synctex_index_sheet_s * sheets = (synctex_index_sheet_s *)realloc(index->sheets, (index->sheet_count ? 2 * index->sheet_count : 16) * sizeof(synctex_index_sheet_s));
+        if (NULL == sheets) {
+            return SYNCTEX_STATUS_ERROR;
+        }
+        index->sheets = sheets;
+    }
+    if (index->sheet_count > 0 && index->sheets[index->sheet_count-1].page >= page) {
+        /*  Pages are shipped out in increasing order */
+        return SYNCTEX_STATUS_ERROR;
+    }
+    index->sheets[index->sheet_count].page = page;
+    index->sheets[index->sheet_count].offset = offset;
+    index->sheets[index->sheet_count].wanted = synctex_NO;
+    index->sheets[index->sheet_count].loaded = synctex_NO;
+    ++index->sheet_count;
+    return SYNCTEX_STATUS_OK;
+}
+
+/*  Read foo.synctex.idx next to the synctex file.
+ *  The index is only used when it was written for this very synctex file,
+ *  which is checked against the recorded length and checksum.  */
+static synctex_status_t _synctex_scanner_read_index(synctex_scanner_p scanner) {
+    synctex_status_t status = SYNCTEX_STATUS_NOT_OK;
+    synctex_index_p index = NULL;
+    size_t length = strlen(scanner->reader->synctex);
+    size_t capacity = 0;
+    char * name = NULL;
+    char * line = NULL;
+    char * end = NULL;
+    FILE * file = NULL;
+    unsigned long crc = 0;
+    long file_length = -1;
+    if (NULL == (name = (char *)_synctex_malloc(length+strlen(synctex_suffix_idx)+1))) {
+        return SYNCTEX_STATUS_ERROR;
+    }
+    strcpy(name, scanner->reader->synctex);
+    if (length > strlen(synctex_suffix_gz) && 0 == strcmp(name+length-strlen(synctex_suffix_gz), synctex_suffix_gz)) {
+        name[length-strlen(synctex_suffix_gz)] = '\0';
+    }
+    strcat(name, synctex_suffix_idx);
+    file = fopen(name, "r");
+    _synctex_free(name);
+    if (NULL == file) {
+        return SYNCTEX_STATUS_NOT_OK;
+    }
+    if (NULL == (index = (synctex_index_p)_synctex_malloc(sizeof(synctex_index_s)))) {
+        fclose(file);
+        return SYNCTEX_STATUS_ERROR;
+    }
+    index->postamble = -1;
+    if (NULL == _synctex_index_get_line(file, &line, &capacity) || strcmp(line, "SyncTeX Index:1")
+        || NULL == _synctex_index_get_line(file, &line, &capacity) || strncmp(line, "Length:", 7)
+        || (file_length = _synctex_file_checksum(scanner->reader->synctex, &crc)) < 0
+        || strtol(line+7, NULL, 10) != file_length
+        || NULL == _synctex_index_get_line(file, &line, &capacity) || strncmp(line, "Checksum:", 9)
+        || strtoul(line+9, NULL, 16) != crc) {
+        goto bail;
+    }
+    while (_synctex_index_get_line(file, &line, &capacity)) {
+        if (0 == strncmp(line, "Input:", 6)) {
+            int tag = (int)strtol(line+6, &end, 10);
+            if (*end != ':' || _synctex_index_add_input(scanner, tag, end+1) < SYNCTEX_STATUS_OK) {
+                goto bail;
+            }
+        } else if (0 == strncmp(line, "Sheet:", 6)) {
+            int page = (int)strtol(line+6, &end, 10);
+            if (*end != ':' || _synctex_index_add_sheet(index, page, strtol(end+1, NULL, 10)) < SYNCTEX_STATUS_OK) {
+                goto bail;
+            }
+        } else if (0 == strncmp(line, "Postamble:", 10)) {
+            index->postamble = strtol(line+10, NULL, 10);
+        } else if (0 == strncmp(line, "Tag:", 4)) {
+            int tag = (int)strtol(line+4, &end, 10);
+            if (*end != ':' || _synctex_index_add_tag(index, tag, end+1) < SYNCTEX_STATUS_OK) {
+                goto bail;
+            }
+        }
+    }
+    if (!ferror(file) && index->postamble > 0) {
+        scanner->index = index;
+        index = NULL;
+        status = SYNCTEX_STATUS_OK;
+    }
+bail:
+    _synctex_index_free(index);
+    _synctex_free(line);
+    fclose(file);
+    return status;
+}
+
+/*  Let the reader continue at the given offset of the synctex file.
+ *  The offset must be the start of a gzip member, or any offset
+ *  for an uncompressed synctex file.  */
+static synctex_status_t _synctex_reader_open_at(synctex_scanner_p scanner, long offset) {
+    FILE * file = NULL;
+    int fd = -1;
+    if (SYNCTEX_FILE) {
+        gzclose(SYNCTEX_FILE);
+        SYNCTEX_FILE = NULL;
+    }
+    SYNCTEX_CUR = SYNCTEX_END = SYNCTEX_START;
+    *SYNCTEX_END = '\0';
+    if (NULL == (file = fopen(scanner->reader->synctex, "rb"))) {
+        return SYNCTEX_STATUS_ERROR;
+    }
+    if (0 == fseek(file, offset, SEEK_SET)) {
+        fd = dup(fileno(file));
+    }
+    fclose(file);
+    if (fd < 0) {
+        return SYNCTEX_STATUS_ERROR;
+    }
+    /*  gzdopen starts reading at the current position of the descriptor */
+    if (NULL == (SYNCTEX_FILE = gzdopen(fd, "rb"))) {
+        close(fd);
+        return SYNCTEX_STATUS_ERROR;
+    }
+    return SYNCTEX_STATUS_OK;
+}
+
+/*  Parse the wanted sheets that are not yet loaded.  */
+static synctex_status_t _synctex_scanner_load_wanted(synctex_scanner_p scanner) {
+    synctex_status_t status = SYNCTEX_STATUS_OK;
+    synctex_index_p index = scanner->index;
+    int loaded = 0;
+    int i;
+    for (i = 0; i < index->sheet_count; ++i) {
+        if (index->sheets[i].wanted && !index->sheets[i].loaded) {
+            break;
+        }
+    }
+    if (i == index->sheet_count) {
+        return SYNCTEX_STATUS_OK;
+    }
+    if (NULL == (SYNCTEX_START = (char *)malloc(SYNCTEX_BUFFER_SIZE+1))) {
+        _synctex_error("!  malloc error in _synctex_scanner_load_wanted.");
+        return SYNCTEX_STATUS_ERROR;
+    }
+    index->loading = synctex_YES;
+    for (; i < index->sheet_count; ++i) {
+        synctex_index_sheet_s * sheet = index->sheets + i;
+        if (!sheet->wanted || sheet->loaded) {
+            continue;
+        }
+        /*  Do not try again, even on failure */
+        sheet->loaded = synctex_YES;
+        if ((status = _synctex_reader_open_at(scanner, sheet->offset)) < SYNCTEX_STATUS_OK
+            || (status = __synctex_parse_sfi(scanner)) < SYNCTEX_STATUS_OK) {
+            _synctex_error("Could not load sheet %i.", sheet->page);
+            break;
+        }
+        ++loaded;
+    }
+    index->loading = synctex_NO;
+    if (loaded > 0) {
+        synctex_status_t post_status = _synctex_post_process(scanner);
+        if (post_status < status) {
+            status = post_status;
+        }
+    }
+    if (SYNCTEX_FILE) {
+        gzclose(SYNCTEX_FILE);
+        SYNCTEX_FILE = NULL;
+    }
+    free((void *)SYNCTEX_START);
+    SYNCTEX_START = SYNCTEX_CUR = SYNCTEX_END = NULL;
+    return status;
+}
+
+static synctex_index_sheet_s * _synctex_index_sheet_with_page(synctex_index_p index, int page) {
+    int low = 0;
+    int high = index->sheet_count;
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (index->sheets[mid].page < page) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low < index->sheet_count && index->sheets[low].page == page ? index->sheets + low : NULL;
+}
+
+/*  Load the sheet with the given page, page 0 means the first sheet. */
+static void _synctex_scanner_load_page(synctex_scanner_p scanner, int page) {
+    synctex_index_sheet_s * sheet;
+    if (NULL == scanner->index || 0 == scanner->index->sheet_count) {
+        return;
+    }
+    sheet = page == 0 ? scanner->index->sheets : _synctex_index_sheet_with_page(scanner->index, page);
+    if (sheet) {
+        sheet->wanted = synctex_YES;
+        _synctex_scanner_load_wanted(scanner);
+    }
+}
+
+/*  Load all the sheets where the given input tag occurs. */
+static void _synctex_scanner_load_tag(synctex_scanner_p scanner, int tag) {
+    int i, j;
+    if (NULL == scanner->index) {
+        return;
+    }
+    for (i = 0; i < scanner->index->tag_count; ++i) {
+        synctex_index_tag_s * t = scanner->index->tags + i;
+        if (t->tag == tag) {
+            for (j = 0; j < t->count; ++j) {
+                synctex_index_sheet_s * sheet = _synctex_index_sheet_with_page(scanner->index, t->pages[j]);
+                if (sheet) {
+                    sheet->wanted = synctex_YES;
+                }
+            }
+        }
+    }
+    _synctex_scanner_load_wanted(scanner);
+}
+
+static void _synctex_scanner_load_all(synctex_scanner_p scanner) {
+    int i;
+    if (NULL == scanner->index) {
+        return;
+    }
+    for (i = 0; i < scanner->index->sheet_count; ++i) {
+        scanner->index->sheets[i].wanted = synctex_YES;
+    }
+    _synctex_scanner_load_wanted(scanner);
+}
+#endif
 synctex_scanner_p synctex_scanner_new() {
     synctex_scanner_p scanner =(synctex_scanner_p)_synctex_malloc(sizeof(synctex_scanner_s));
     if (scanner) {
@@ -6044,6 +6470,9 @@ int synctex_scanner_free(synctex_scanner_p scanner) {
         synctex_node_free(scanner->form);
         synctex_node_free(scanner->input);
         synctex_reader_free(scanner->reader);
+#if defined(MIKTEX)
+        _synctex_index_free(scanner->index);
+#endif
         SYNCTEX_SCANNER_FREE_HANDLE(scanner);
         synctex_iterator_free(scanner->iterator);
         free(scanner->output_fmt);
@@ -6097,11 +6526,28 @@ synctex_scanner_p synctex_scanner_parse(synctex_scanner_p scanner) {
         _synctex_error("Bad preamble\n");
         goto bailey;
     }
+#if defined(MIKTEX)
+    if (_synctex_scanner_read_index(scanner) == SYNCTEX_STATUS_OK) {
+        /*  Skip the content, sheets are loaded on demand */
+        if (_synctex_reader_open_at(scanner, scanner->index->postamble)<SYNCTEX_STATUS_OK) {
+            _synctex_error("Bad index\n");
+            _synctex_index_free(scanner->index);
+            scanner->index = NULL;
+            if (_synctex_reader_open_at(scanner, 0)<SYNCTEX_STATUS_OK) {
+                goto bailey;
+            }
+        }
+    }
+    if (NULL == scanner->index) {
+#endif
     status = _synctex_scan_content(scanner);
     if (status<SYNCTEX_STATUS_OK) {
         _synctex_error("Bad content\n");
         goto bailey;
     }
+#if defined(MIKTEX)
+    }
+#endif
     status = _synctex_scan_postamble(scanner);
     if (status<SYNCTEX_STATUS_OK) {
         _synctex_error("Bad postamble. Ignored\n");
@@ -6168,6 +6614,9 @@ void synctex_scanner_display(synctex_scanner_p scanner) {
     if (NULL == scanner) {
         return;
     }
+#if defined(MIKTEX)
+    _synctex_scanner_load_all(scanner);
+#endif
     printf("The scanner:\noutput:%s\noutput_fmt:%s\nversion:%i\n",scanner->reader->output,scanner->output_fmt,scanner->version);
     printf("pre_unit:%i\nx_offset:%i\ny_offset:%i\n",scanner->pre_unit,scanner->pre_x_offset,scanner->pre_y_offset);
     printf("count:%i\npost_magnification:%f\npost_x_offset:%f\npost_y_offset:%f\n",
@@ -6992,7 +7441,11 @@ int synctex_node_child_count(synctex_node_p node) {
  */
 synctex_node_p synctex_sheet(synctex_scanner_p scanner,int page) {
     if (scanner) {
-        synctex_node_p sheet = scanner->sheet;
+        synctex_node_p sheet = NULL;
+#if defined(MIKTEX)
+        _synctex_scanner_load_page(scanner,page);
+#endif
+        sheet = scanner->sheet;
         while(sheet) {
             if (page == _synctex_data_page(sheet)) {
                 return sheet;
@@ -7475,6 +7928,9 @@ synctex_iterator_p synctex_iterator_new_display(synctex_scanner_p scanner,const
             printf("SyncTeX Warning: No tag for %s\n",name);
             return NULL;
         }
+#if defined(MIKTEX)
+        _synctex_scanner_load_tag(scanner, tag);
+#endif
         node = synctex_scanner_input_with_tag(scanner, tag);
         max_line = _synctex_data_line(node);
         /*  node = NULL; */
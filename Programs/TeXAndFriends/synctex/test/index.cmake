@@ -0,0 +1,122 @@
+## index.cmake: check the SyncTeX sidecar index          -*- CMake -*-
+##
+## Copyright (C) 2026 agent
+## 
+## This file is free software; you can redistribute it and/or modify
+## it under the terms of the GNU General Public License as published
+## by the Free Software Foundation; either version 2, or (at your
+## option) any later version.
+## 
+## This file is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+## General Public License for more details.
+## 
+## You should have received a copy of the GNU General Public License
+## along with this file; if not, write to the Free Software
+## Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+## USA.
+
+## Runs INITEX with -synctex=17 on a two-page job and checks that:
+##  - the index is written and lists both sheets;
+##  - queries give the same results with and without the index;
+##  - a doctored index with the right checksum is used, one with a
+##    wrong checksum (but the right length) is ignored;
+##  - a run without pages removes the index of the previous run.
+
+cmake_minimum_required(VERSION 3.12)
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(MAKE_DIRECTORY ${WORK_DIR}/config ${WORK_DIR}/data ${WORK_DIR}/install)
+
+set(ENV{MIKTEX_USERCONFIG} ${WORK_DIR}/config)
+set(ENV{MIKTEX_USERDATA} ${WORK_DIR}/data)
+set(ENV{MIKTEX_USERINSTALL} ${WORK_DIR}/install)
+
+set(idx_file ${WORK_DIR}/test.synctex.idx)
+
+function(run_tex)
+  execute_process(
+    COMMAND ${TEX} -ini -interaction=nonstopmode --disable-installer -synctex=17 test.tex
+    WORKING_DIRECTORY ${WORK_DIR}
+    OUTPUT_QUIET
+    ERROR_QUIET
+    RESULT_VARIABLE exit_code
+  )
+  if(NOT exit_code EQUAL 0)
+    message(FATAL_ERROR "TeX failed: ${exit_code}")
+  endif()
+endfunction()
+
+# sets RESULT to the answer for LINE of test.tex
+function(view line result)
+  execute_process(
+    COMMAND ${SYNCTEX} view -i ${line}:0:test.tex -o test.dvi
+    WORKING_DIRECTORY ${WORK_DIR}
+    OUTPUT_VARIABLE output
+    ERROR_QUIET
+  )
+  set(${result} "${output}" PARENT_SCOPE)
+endfunction()
+
+# line 2 goes to page 1, line 3 to page 2
+file(WRITE ${WORK_DIR}/test.tex
+  "\\catcode`\\{=1 \\catcode`\\}=2\n"
+  "\\shipout\\hbox{\\vrule width 10pt height 10pt}\n"
+  "\\shipout\\hbox{\\vrule width 20pt height 20pt}\n"
+  "\\end\n"
+)
+run_tex()
+
+if(NOT EXISTS ${WORK_DIR}/test.synctex.gz OR NOT EXISTS ${idx_file})
+  message(FATAL_ERROR "no SyncTeX output or no index")
+endif()
+file(STRINGS ${idx_file} sheets REGEX "^Sheet:")
+list(LENGTH sheets num_sheets)
+if(NOT num_sheets EQUAL 2)
+  message(FATAL_ERROR "the index lists ${num_sheets} sheets, expected 2")
+endif()
+file(STRINGS ${idx_file} checksum REGEX "^Checksum:[0-9a-f]+$")
+if(checksum STREQUAL "")
+  message(FATAL_ERROR "the index has no checksum")
+endif()
+file(READ ${idx_file} index)
+
+view(2 with_index_2)
+view(3 with_index_3)
+file(REMOVE ${idx_file})
+view(2 without_index_2)
+view(3 without_index_3)
+if(NOT without_index_3 MATCHES "Page:2")
+  message(FATAL_ERROR "line 3 not found on page 2:\n${without_index_3}")
+endif()
+if(NOT with_index_2 STREQUAL without_index_2 OR NOT with_index_3 STREQUAL without_index_3)
+  message(FATAL_ERROR "the index changes the results:\n${with_index_3}\n--\n${without_index_3}")
+endif()
+
+# claim that the input occurs on page 1 only
+string(REGEX REPLACE "\nTag:([0-9]+):[0-9,]+" "\nTag:\\1:1" doctored "${index}")
+file(WRITE ${idx_file} "${doctored}")
+view(3 doctored_3)
+if(doctored_3 STREQUAL without_index_3)
+  message(FATAL_ERROR "a doctored index with the right checksum is not used")
+endif()
+if(checksum STREQUAL "Checksum:00000000")
+  set(wrong_checksum "Checksum:00000001")
+else()
+  set(wrong_checksum "Checksum:00000000")
+endif()
+string(REPLACE "${checksum}" "${wrong_checksum}" stale "${doctored}")
+file(WRITE ${idx_file} "${stale}")
+view(3 stale_3)
+if(NOT stale_3 STREQUAL without_index_3)
+  message(FATAL_ERROR "an index with a wrong checksum is used:\n${stale_3}")
+endif()
+
+# no pages: the index of the previous run must go away
+file(WRITE ${idx_file} "${index}")
+file(WRITE ${WORK_DIR}/test.tex "\\end\n")
+run_tex()
+if(EXISTS ${idx_file})
+  message(FATAL_ERROR "the index of the previous run has not been removed")
+endif()
@@ -0,0 +1,402 @@
+/* bench.cpp: run a program and measure its resource usage
+
+   Copyright (C) 2026 agent
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published
+   by the Free Software Foundation; either version 2, or (at your
+   option) any later version.
+
+   This file is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this file; if not, write to the Free Software
+   Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+   USA.  */
+
+/* Usage:
+
+     miktex-bench [--repeat N] [--strace PROGRAM] [--input FILE]
+                  [--loop M] [--requests M] NAME LOGFILE -- COMMAND [ARG...]
+
+   Runs COMMAND N times (default: 3) in the current directory, with
+   its standard output and standard error redirected to LOGFILE, and
+   writes a JSON object to standard output:
+
+     {"name": NAME, "command": [...], "exit_code": ..., "runs": N,
+      "wall_seconds": ..., "user_seconds": ..., "system_seconds": ...,
+      "peak_rss_kb": ..., "syscalls": ..., "requests": ...,
+      "requests_per_second": ...}
+
+   Times are medians over the runs, peak_rss_kb is the maximum.
+   Syscalls are counted in an extra run under strace -c, if --strace
+   is given; otherwise (and on Windows) syscalls is null.  Standard
+   input is read from FILE, if --input is given, otherwise from the
+   null device.
+
+   With --loop M, a run consists of M invocations of COMMAND, one
+   after the other, and is timed as a whole.  --requests M declares
+   that a run serves M requests (e.g., a server reading them from
+   FILE); --loop M implies --requests M.  requests_per_second is then
+   M divided by the median wall time; otherwise both are null.
+   Syscalls are counted for a single invocation. */
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#  include <psapi.h>
+#else
+#  include <fcntl.h>
+#  include <spawn.h>
+#  include <sys/resource.h>
+#  include <sys/time.h>
+#  include <sys/types.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+extern char** environ;
+#endif
+
+using namespace std;
+
+struct Measurement
+{
+  int exitCode = -1;
+  double wallSeconds = 0;
+  double userSeconds = 0;
+  double systemSeconds = 0;
+  long peakRssKb = 0;
+};
+
+static void Fatal(const string& message)
+{
+  fprintf(stderr, "miktex-bench: %s\n", message.c_str());
+  exit(2);
+}
+
+#if defined(_WIN32)
+
+static wstring Widen(const string& s)
+{
+  int len = MultiByteToWideChar(CP_UTF8, 0, s.c_str(), -1, nullptr, 0);
+  vector<wchar_t> buf(len);
+  MultiByteToWideChar(CP_UTF8, 0, s.c_str(), -1, buf.data(), len);
+  return buf.data();
+}
+
+static wstring QuoteArgument(const string& arg)
+{
+  if (!arg.empty() && arg.find_first_of(" \t\"") == string::npos)
+  {
+    return Widen(arg);
+  }
+  string quoted = "\"";
+  size_t backslashes = 0;
+  for (char ch : arg)
+  {
+    if (ch == '\\')
+    {
+      ++backslashes;
+      continue;
+    }
+    quoted.append(ch == '"' ? backslashes * 2 + 1 : backslashes, '\\');
+    backslashes = 0;
+    quoted += ch;
+  }
+  quoted.append(backslashes * 2, '\\');
+  quoted += '"';
+  return Widen(quoted);
+}
+
+static double Seconds(const FILETIME& ft)
+{
+  ULARGE_INTEGER li;
+  li.LowPart = ft.dwLowDateTime;
+  li.HighPart = ft.dwHighDateTime;
+  return li.QuadPart / 1e7;
+}
+
+static Measurement Run(const vector<string>& command, const string& inputFile, const string& logFile)
+{
+  wstring commandLine;
+  for (const string& arg : command)
+  {
+    if (!commandLine.empty())
+    {
+      commandLine += L' ';
+    }
+    commandLine += QuoteArgument(arg);
+  }
+  SECURITY_ATTRIBUTES sa = { sizeof(sa), nullptr, TRUE };
+  HANDLE log = CreateFileW(Widen(logFile).c_str(), GENERIC_WRITE, FILE_SHARE_READ, &sa, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (log == INVALID_HANDLE_VALUE)
+  {
+    Fatal("cannot create " + logFile);
+  }
+  HANDLE input = CreateFileW(inputFile.empty() ? L"NUL" : Widen(inputFile).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, &sa, OPEN_EXISTING, 0, nullptr);
+  if (input == INVALID_HANDLE_VALUE)
+  {
+    Fatal("cannot open " + inputFile);
+  }
+  STARTUPINFOW si;
+  ZeroMemory(&si, sizeof(si));
+  si.cb = sizeof(si);
+  si.dwFlags = STARTF_USESTDHANDLES;
+  si.hStdInput = input;
+  si.hStdOutput = log;
+  si.hStdError = log;
+  PROCESS_INFORMATION pi;
+  vector<wchar_t> buf(commandLine.begin(), commandLine.end());
+  buf.push_back(0);
+  auto start = chrono::steady_clock::now();
+  if (!CreateProcessW(nullptr, buf.data(), nullptr, nullptr, TRUE, 0, nullptr, nullptr, &si, &pi))
+  {
+    Fatal("cannot start " + command[0]);
+  }
+  WaitForSingleObject(pi.hProcess, INFINITE);
+  Measurement m;
+  m.wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  DWORD exitCode;
+  GetExitCodeProcess(pi.hProcess, &exitCode);
+  m.exitCode = static_cast<int>(exitCode);
+  FILETIME creationTime, exitTime, kernelTime, userTime;
+  if (GetProcessTimes(pi.hProcess, &creationTime, &exitTime, &kernelTime, &userTime))
+  {
+    m.userSeconds = Seconds(userTime);
+    m.systemSeconds = Seconds(kernelTime);
+  }
+  PROCESS_MEMORY_COUNTERS pmc;
+  if (GetProcessMemoryInfo(pi.hProcess, &pmc, sizeof(pmc)))
+  {
+    m.peakRssKb = static_cast<long>(pmc.PeakWorkingSetSize / 1024);
+  }
+  CloseHandle(pi.hThread);
+  CloseHandle(pi.hProcess);
+  CloseHandle(input);
+  CloseHandle(log);
+  return m;
+}
+
+#else
+
+static Measurement Run(const vector<string>& command, const string& inputFile, const string& logFile)
+{
+  vector<char*> argv;
+  for (const string& arg : command)
+  {
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+  posix_spawn_file_actions_t fileActions;
+  posix_spawn_file_actions_init(&fileActions);
+  posix_spawn_file_actions_addopen(&fileActions, 0, inputFile.empty() ? "/dev/null" : inputFile.c_str(), O_RDONLY, 0);
+  posix_spawn_file_actions_addopen(&fileActions, 1, logFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  posix_spawn_file_actions_adddup2(&fileActions, 1, 2);
+  pid_t pid;
+  auto start = chrono::steady_clock::now();
+  int err = posix_spawnp(&pid, argv[0], &fileActions, nullptr, argv.data(), environ);
+  posix_spawn_file_actions_destroy(&fileActions);
+  if (err != 0)
+  {
+    Fatal("cannot start " + command[0] + ": " + strerror(err));
+  }
+  int status;
+  struct rusage usage;
+  if (wait4(pid, &status, 0, &usage) < 0)
+  {
+    Fatal("wait4 failed");
+  }
+  Measurement m;
+  m.wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  m.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+  m.userSeconds = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6;
+  m.systemSeconds = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+#if defined(__APPLE__)
+  m.peakRssKb = usage.ru_maxrss / 1024;
+#else
+  m.peakRssKb = usage.ru_maxrss;
+#endif
+  return m;
+}
+
+#endif
+
+// the total line of strace -c reads: % time, seconds, usecs/call, calls, [errors,] "total"
+static long CountSyscalls(const string& strace, const vector<string>& command, const string& inputFile, const string& logFile)
+{
+  string traceFile = logFile + ".strace";
+  vector<string> tracedCommand = { strace, "-f", "-c", "-o", traceFile, "--" };
+  tracedCommand.insert(tracedCommand.end(), command.begin(), command.end());
+  Run(tracedCommand, inputFile, logFile);
+  ifstream stream(traceFile);
+  string line;
+  long calls = -1;
+  while (getline(stream, line))
+  {
+    istringstream words(line);
+    vector<string> fields;
+    string field;
+    while (words >> field)
+    {
+      fields.push_back(field);
+    }
+    if (fields.size() >= 5 && fields.back() == "total")
+    {
+      calls = atol(fields[3].c_str());
+    }
+  }
+  stream.close();
+  remove(traceFile.c_str());
+  return calls;
+}
+
+static string JsonString(const string& s)
+{
+  string result = "\"";
+  for (unsigned char ch : s)
+  {
+    if (ch == '"' || ch == '\\')
+    {
+      result += '\\';
+      result += ch;
+    }
+    else if (ch < 0x20)
+    {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", ch);
+      result += buf;
+    }
+    else
+    {
+      result += ch;
+    }
+  }
+  return result + "\"";
+}
+
+static double Median(vector<double> values)
+{
+  sort(values.begin(), values.end());
+  size_t n = values.size();
+  return n % 2 == 1 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+}
+
+int main(int argc, char** argv)
+{
+  int repeat = 3;
+  string strace;
+  string inputFile;
+  int loop = 1;
+  int requests = 0;
+  int argIdx = 1;
+  for (; argIdx < argc && strncmp(argv[argIdx], "--", 2) == 0 && argv[argIdx][2] != 0; argIdx += 2)
+  {
+    if (argIdx + 1 >= argc)
+    {
+      Fatal(string("missing argument for ") + argv[argIdx]);
+    }
+    if (strcmp(argv[argIdx], "--repeat") == 0)
+    {
+      repeat = max(1, atoi(argv[argIdx + 1]));
+    }
+    else if (strcmp(argv[argIdx], "--strace") == 0)
+    {
+      strace = argv[argIdx + 1];
+    }
+    else if (strcmp(argv[argIdx], "--input") == 0)
+    {
+      inputFile = argv[argIdx + 1];
+    }
+    else if (strcmp(argv[argIdx], "--loop") == 0)
+    {
+      loop = max(1, atoi(argv[argIdx + 1]));
+      requests = loop;
+    }
+    else if (strcmp(argv[argIdx], "--requests") == 0)
+    {
+      requests = max(1, atoi(argv[argIdx + 1]));
+    }
+    else
+    {
+      Fatal(string("unknown option ") + argv[argIdx]);
+    }
+  }
+  if (argIdx + 3 >= argc || strcmp(argv[argIdx + 2], "--") != 0)
+  {
+    Fatal("usage: miktex-bench [--repeat N] [--strace PROGRAM] [--input FILE] [--loop M] [--requests M] NAME LOGFILE -- COMMAND [ARG...]");
+  }
+  string name = argv[argIdx];
+  string logFile = argv[argIdx + 1];
+  vector<string> command(argv + argIdx + 3, argv + argc);
+
+  vector<double> wall;
+  vector<double> user;
+  vector<double> sys;
+  long peakRssKb = 0;
+  int exitCode = 0;
+  for (int run = 0; run < repeat; ++run)
+  {
+    Measurement total;
+    total.exitCode = 0;
+    for (int iteration = 0; iteration < loop && total.exitCode == 0; ++iteration)
+    {
+      Measurement m = Run(command, inputFile, logFile);
+      total.exitCode = m.exitCode;
+      total.wallSeconds += m.wallSeconds;
+      total.userSeconds += m.userSeconds;
+      total.systemSeconds += m.systemSeconds;
+      total.peakRssKb = max(total.peakRssKb, m.peakRssKb);
+    }
+    wall.push_back(total.wallSeconds);
+    user.push_back(total.userSeconds);
+    sys.push_back(total.systemSeconds);
+    peakRssKb = max(peakRssKb, total.peakRssKb);
+    if (total.exitCode != 0)
+    {
+      exitCode = total.exitCode;
+    }
+  }
+  long syscalls = strace.empty() ? -1 : CountSyscalls(strace, command, inputFile, logFile);
+
+  ostringstream json;
+  json << "{\"name\": " << JsonString(name) << ", \"command\": [";
+  for (size_t idx = 0; idx < command.size(); ++idx)
+  {
+    json << (idx > 0 ? ", " : "") << JsonString(command[idx]);
+  }
+  json << "], \"exit_code\": " << exitCode
+    << ", \"runs\": " << repeat
+    << ", \"wall_seconds\": " << Median(wall)
+    << ", \"user_seconds\": " << Median(user)
+    << ", \"system_seconds\": " << Median(sys)
+    << ", \"peak_rss_kb\": " << peakRssKb
+    << ", \"syscalls\": " << (syscalls < 0 ? string("null") : std::to_string(syscalls));
+  if (requests > 0 && Median(wall) > 0)
+  {
+    json << ", \"requests\": " << requests
+      << ", \"requests_per_second\": " << requests / Median(wall);
+  }
+  else
+  {
+    json << ", \"requests\": null, \"requests_per_second\": null";
+  }
+  json << "}";
+  puts(json.str().c_str());
+  return exitCode == 0 ? 0 : 1;
+}
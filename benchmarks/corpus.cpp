@@ -0,0 +1,486 @@
+/* corpus.cpp: generate the benchmark documents
+
+   Copyright (C) 2026 agent
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published
+   by the Free Software Foundation; either version 2, or (at your
+   option) any later version.
+
+   This file is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this file; if not, write to the Free Software
+   Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+   USA.  */
+
+/* Usage: miktex-bench-corpus DIRECTORY
+
+   Writes the synthetic documents into DIRECTORY.  The documents are
+   generated from a fixed seed, i.e., they are the same on every
+   machine and in every run. */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+const int PROSE_PARAGRAPHS = 2000;
+const int LONG_LINE_PARAGRAPHS = 400;
+const int LONG_LINE_WORDS = 2500;
+const int BIB_LONG_LINE_ENTRIES = 1000;
+const int BIB_LONG_LINE_WORDS = 1000;
+const int MATH_FORMULAS = 2000;
+const int TIKZ_PICTURES = 150;
+const int BIB_ENTRIES = 100000;
+const int INDEX_ENTRIES = 100000;
+const int IMAGES = 48;
+const int IMAGE_SIZE = 512;
+const int PROBES = 20000;
+
+class Random
+{
+public:
+  explicit Random(uint32_t seed) :
+    state(seed)
+  {
+  }
+
+public:
+  uint32_t Next()
+  {
+    // xorshift32
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+  }
+
+public:
+  int Next(int n)
+  {
+    return static_cast<int>(Next() % static_cast<uint32_t>(n));
+  }
+
+private:
+  uint32_t state;
+};
+
+const char* const WORDS[] = {
+  "the", "of", "and", "a", "to", "in", "is", "that", "for", "it", "as", "was", "with", "be", "by", "on", "not",
+  "this", "are", "which", "from", "or", "have", "an", "they", "one", "had", "there", "were", "been", "has", "their",
+  "typesetting", "paragraph", "hyphenation", "justification", "glue", "penalty", "kerning", "ligature", "baseline",
+  "manuscript", "mathematics", "quadrilateral", "extraordinary", "characteristically", "incomprehensibilities",
+  "document", "reproducible", "benchmark", "throughput", "regression", "performance", "measurement", "interval",
+};
+
+const char* const UNICODE_WORDS[] = {
+  "Grüße", "Straße", "naïve", "façade", "déjà", "smørrebrød", "Ærø", "Łódź", "Dvořák", "Ελληνικά", "αλφάβητο",
+  "Кириллица", "Москва", "Україна", "Ελευθερία", "čeština", "İstanbul", "Ångström", "œuvre", "Zürich",
+};
+
+template<size_t N> string Words(Random& random, const char* const (&words)[N], int count)
+{
+  string text;
+  for (int idx = 0; idx < count; ++idx)
+  {
+    if (idx > 0)
+    {
+      text += ' ';
+    }
+    text += words[random.Next(N)];
+  }
+  return text;
+}
+
+static ofstream Create(const string& dir, const string& fileName)
+{
+  ofstream stream(dir + "/" + fileName, ios_base::binary);
+  if (!stream.is_open())
+  {
+    fprintf(stderr, "miktex-bench-corpus: cannot create %s/%s\n", dir.c_str(), fileName.c_str());
+    exit(1);
+  }
+  return stream;
+}
+
+// long prose, plain TeX
+static void WriteProse(const string& dir)
+{
+  Random random(1);
+  ofstream stream = Create(dir, "prose.tex");
+  for (int idx = 0; idx < PROSE_PARAGRAPHS; ++idx)
+  {
+    if (idx % 25 == 0)
+    {
+      stream << "\\beginsection Section " << idx / 25 + 1 << ".\n\n";
+    }
+    // wrap lines, as an editor would
+    string paragraph = Words(random, WORDS, 80 + random.Next(120));
+    size_t column = 0;
+    for (char ch : paragraph)
+    {
+      if (ch == ' ' && column > 70)
+      {
+        stream << '\n';
+        column = 0;
+        continue;
+      }
+      stream << ch;
+      ++column;
+    }
+    stream << "\n\n";
+  }
+  stream << "\\bye\n";
+}
+
+// one very long input line per paragraph, plain TeX
+static void WriteLongLines(const string& dir)
+{
+  Random random(2);
+  ofstream stream = Create(dir, "longlines.tex");
+  for (int idx = 0; idx < LONG_LINE_PARAGRAPHS; ++idx)
+  {
+    stream << Words(random, WORDS, LONG_LINE_WORDS) << "\n\n";
+  }
+  stream << "\\bye\n";
+}
+
+// as above, with non-ASCII (UTF-8) words, so that 8-bit engines
+// translate bytes through xord and 16-bit engines decode the lines
+static void WriteLongLines8(const string& dir)
+{
+  Random random(11);
+  ofstream stream = Create(dir, "longlines8.tex");
+  // the fonts have no glyphs for most of these characters
+  stream << "\\tracinglostchars=0\n";
+  for (int idx = 0; idx < LONG_LINE_PARAGRAPHS; ++idx)
+  {
+    stream << Words(random, UNICODE_WORDS, LONG_LINE_WORDS / 5) << " " << Words(random, WORDS, LONG_LINE_WORDS - LONG_LINE_WORDS / 5) << "\n\n";
+  }
+  stream << "\\bye\n";
+}
+
+// a single displayed formula on a page of its own, as rendered by
+// previewers and formula services, plain TeX
+static void WriteSnippet(const string& dir)
+{
+  ofstream stream = Create(dir, "snippet.tex");
+  stream
+    << "\\nopagenumbers\n"
+    << "$$\\sum_{k=1}^{n} {k^2 \\over (k+1)!} = \\int_0^\\infty e^{-x} \\sqrt{x^3+1}\\,dx$$\n"
+    << "\\bye\n";
+}
+
+// math-heavy, plain TeX
+static void WriteMath(const string& dir)
+{
+  Random random(3);
+  ofstream stream = Create(dir, "math.tex");
+  for (int idx = 0; idx < MATH_FORMULAS; ++idx)
+  {
+    int a = random.Next(9) + 1;
+    int b = random.Next(9) + 1;
+    switch (idx % 5)
+    {
+    case 0:
+      stream << "$$\\sum_{k=" << a << "}^{n} {k^{" << b << "} \\over (k+" << a << ")!} = \\int_0^\\infty e^{-" << b << "x} \\sqrt{x^{" << a << "}+1}\\,dx$$\n";
+      break;
+    case 1:
+      stream << "$$\\pmatrix{" << a << " & x_{" << b << "} \\cr y^{" << a << "} & \\alpha_{" << b << "}}\\pmatrix{\\beta \\cr \\gamma} = \\left( {" << a << " \\over " << b << "} \\right)^{\\!n}$$\n";
+      break;
+    case 2:
+      stream << "Since $f_{" << a << "}(x) = \\prod_{i=1}^{" << b << "} (x - \\lambda_i)$, we get $\\lim_{x\\to\\infty} {f'(x) \\over f(x)} = 0$ for all $x \\in \\Omega_{" << a << "}$.\n\n";
+      break;
+    case 3:
+      stream << "$$\\eqalign{\\nabla \\cdot E &= {\\rho \\over \\varepsilon_" << a << "} \\cr \\nabla \\times B &= \\mu_" << b << " J + \\mu_0\\varepsilon_0 {\\partial E \\over \\partial t}}$$\n";
+      break;
+    default:
+      stream << "$$\\Gamma(z) = \\int_0^\\infty t^{z-" << a << "} e^{-t}\\,dt \\quad \\hbox{for } \\Re z > " << b << "$$\n";
+      break;
+    }
+  }
+  stream << "\\bye\n";
+}
+
+// TikZ-heavy, LaTeX
+static void WriteTikz(const string& dir)
+{
+  Random random(4);
+  ofstream stream = Create(dir, "tikz.tex");
+  stream << "\\documentclass{article}\n\\usepackage{tikz}\n\\usetikzlibrary{arrows.meta,calc,shapes.geometric}\n\\begin{document}\n";
+  for (int idx = 0; idx < TIKZ_PICTURES; ++idx)
+  {
+    int n = 6 + random.Next(12);
+    stream
+      << "\\begin{tikzpicture}\n"
+      << "  \\foreach \\i in {1,...," << n << "} {\n"
+      << "    \\node[draw,regular polygon,regular polygon sides=" << 3 + idx % 6 << ",fill=blue!\\i0] (n\\i) at ({360/" << n << "*\\i}:2cm) {\\i};\n"
+      << "  }\n"
+      << "  \\foreach \\i in {2,...," << n << "} {\n"
+      << "    \\pgfmathtruncatemacro{\\j}{\\i-1}\n"
+      << "    \\draw[-{Stealth}] (n\\j) to[bend left] (n\\i);\n"
+      << "  }\n"
+      << "  \\draw[domain=0:6.28,samples=100,smooth] plot (\\x, {sin(" << 1 + random.Next(5) << "*\\x r)});\n"
+      << "\\end{tikzpicture}\n\n";
+  }
+  stream << "\\end{document}\n";
+}
+
+// many packages, LaTeX
+static void WritePackages(const string& dir)
+{
+  Random random(5);
+  ofstream stream = Create(dir, "packages.tex");
+  stream
+    << "\\documentclass{article}\n"
+    << "\\usepackage[T1]{fontenc}\n"
+    << "\\usepackage{lmodern,microtype,geometry,fancyhdr,amsmath,amssymb,amsthm,graphicx,xcolor,booktabs,\n"
+    << "  tabularx,longtable,enumitem,caption,float,listings,siunitx,array,multirow,url}\n"
+    << "\\usepackage{hyperref}\n"
+    << "\\pagestyle{fancy}\n"
+    << "\\newtheorem{theorem}{Theorem}\n"
+    << "\\begin{document}\n"
+    << "\\tableofcontents\n";
+  for (int idx = 0; idx < 100; ++idx)
+  {
+    stream
+      << "\\section{Section " << idx + 1 << "}\\label{sec:" << idx << "}\n"
+      << Words(random, WORDS, 150) << " See Section~\\ref{sec:" << random.Next(100) << "}.\n\n"
+      << "\\begin{theorem}\n" << Words(random, WORDS, 30) << "\n\\begin{align}\n  f(x) &= \\SI{" << random.Next(1000) << "}{\\metre\\per\\second} \\\\\n  g(x) &= \\textcolor{red}{\\frac{x}{" << 1 + random.Next(9) << "}}\n\\end{align}\n\\end{theorem}\n"
+      << "\\begin{table}[H]\n\\centering\n\\begin{tabularx}{\\linewidth}{lXr}\n\\toprule\nA & B & C \\\\\n\\midrule\n";
+    for (int row = 0; row < 5; ++row)
+    {
+      stream << row << " & " << Words(random, WORDS, 8) << " & " << random.Next(100) << " \\\\\n";
+    }
+    stream
+      << "\\bottomrule\n\\end{tabularx}\n\\caption{Table " << idx + 1 << "}\n\\end{table}\n"
+      << "\\begin{itemize}[noitemsep]\n\\item " << Words(random, WORDS, 12) << "\n\\item \\url{https://example.org/" << idx << "}\n\\end{itemize}\n\n";
+  }
+  stream << "\\end{document}\n";
+}
+
+// Unicode-heavy, LaTeX for XeTeX and LuaTeX
+static void WriteUnicode(const string& dir)
+{
+  Random random(6);
+  ofstream stream = Create(dir, "unicode.tex");
+  stream << "\\documentclass{article}\n\\usepackage{fontspec}\n\\begin{document}\n";
+  for (int idx = 0; idx < 800; ++idx)
+  {
+    stream << Words(random, UNICODE_WORDS, 60) << " " << Words(random, WORDS, 60) << "\n\n";
+  }
+  stream << "\\end{document}\n";
+}
+
+// large bibliography; the .aux file cites all entries, so no LaTeX run is needed
+static void WriteBibliography(const string& dir)
+{
+  Random random(7);
+  ofstream bib = Create(dir, "biblio.bib");
+  const char* const lastNames[] = { "Knuth", "Lamport", "Goossens", "Mittelbach", "Schenk", "Oetiker", "Carlisle", "Rahtz", "Braams", "Patashnik" };
+  const char* const firstNames[] = { "Donald E.", "Leslie", "Michel", "Frank", "Christian", "Tobias", "David", "Sebastian", "Johannes", "Oren" };
+  for (int idx = 0; idx < BIB_ENTRIES; ++idx)
+  {
+    string author = string(firstNames[random.Next(10)]) + " " + lastNames[random.Next(10)];
+    if (random.Next(3) == 0)
+    {
+      author += string(" and ") + firstNames[random.Next(10)] + " " + lastNames[random.Next(10)];
+    }
+    int year = 1970 + random.Next(50);
+    switch (idx % 3)
+    {
+    case 0:
+      bib << "@article{key" << idx << ",\n  author = {" << author << "},\n  title = {" << Words(random, WORDS, 6) << "},\n  journal = {TUGboat},\n  volume = {" << random.Next(40) << "},\n  pages = {" << random.Next(300) << "--" << 300 + random.Next(300) << "},\n  year = " << year << "\n}\n\n";
+      break;
+    case 1:
+      bib << "@book{key" << idx << ",\n  author = {" << author << "},\n  title = {" << Words(random, WORDS, 4) << "},\n  publisher = {Addison-Wesley},\n  address = {Reading, MA},\n  year = " << year << "\n}\n\n";
+      break;
+    default:
+      bib << "@inproceedings{key" << idx << ",\n  author = {" << author << "},\n  title = {" << Words(random, WORDS, 7) << "},\n  booktitle = {Proceedings of the " << random.Next(40) << "th Annual Meeting},\n  year = " << year << ",\n  note = {" << Words(random, WORDS, 10) << "}\n}\n\n";
+      break;
+    }
+  }
+  ofstream aux = Create(dir, "biblio.aux");
+  aux << "\\relax\n\\citation{*}\n\\bibstyle{plain}\n\\bibdata{biblio}\n";
+}
+
+// bibliography entries with one long line each; the abstract field
+// is unknown to plain.bst, so BibTeX mostly just reads the lines
+static void WriteBibLongLines(const string& dir)
+{
+  Random random(12);
+  ofstream bib = Create(dir, "longlines.bib");
+  for (int idx = 0; idx < BIB_LONG_LINE_ENTRIES; ++idx)
+  {
+    bib << "@misc{key" << idx << ",\n  title = {" << Words(random, WORDS, 6) << "},\n  abstract = {" << Words(random, WORDS, BIB_LONG_LINE_WORDS) << "},\n  year = " << 1970 + random.Next(50) << "\n}\n\n";
+  }
+  ofstream aux = Create(dir, "longlines.aux");
+  aux << "\\relax\n\\citation{*}\n\\bibstyle{plain}\n\\bibdata{longlines}\n";
+}
+
+// large index for makeindex
+static void WriteIndex(const string& dir)
+{
+  Random random(8);
+  ofstream stream = Create(dir, "index.idx");
+  for (int idx = 0; idx < INDEX_ENTRIES; ++idx)
+  {
+    string term = WORDS[random.Next(sizeof(WORDS) / sizeof(WORDS[0]))];
+    switch (idx % 4)
+    {
+    case 0:
+      stream << "\\indexentry{" << term << "}{" << 1 + random.Next(2000) << "}\n";
+      break;
+    case 1:
+      stream << "\\indexentry{" << term << "!" << WORDS[random.Next(sizeof(WORDS) / sizeof(WORDS[0]))] << "}{" << 1 + random.Next(2000) << "}\n";
+      break;
+    case 2:
+      stream << "\\indexentry{" << term << "@\\textit{" << term << "}|textbf}{" << 1 + random.Next(2000) << "}\n";
+      break;
+    default:
+      stream << "\\indexentry{" << term << "|(}{" << 1 + random.Next(1000) << "}\n";
+      stream << "\\indexentry{" << term << "|)}{" << 1001 + random.Next(1000) << "}\n";
+      break;
+    }
+  }
+}
+
+// file name probes, most of which miss: \IfFileExists, configuration
+// files, language definitions, hyphenation patterns, font definitions;
+// the list is synthetic: the names are modeled on these kinds of
+// lookups and the miss rate is assumed, not taken from a recorded trace
+const char* const PROBE_HITS[] = {
+  "article.cls", "size10.clo", "fontenc.sty", "t1enc.def", "t1lmr.fd", "amsmath.sty", "graphicx.sty", "xcolor.sty",
+  "hyperref.sty", "geometry.sty", "fancyhdr.sty", "booktabs.sty", "url.sty", "color.cfg", "graphics.cfg",
+};
+
+const char* const PROBE_MISSES[] = {
+  "zz{}.cfg", "zz{}.sty", "zz{}.ldf", "hyph-zz{}.tex", "t1zz{}.fd", "ot1zz{}.fd", "zz{}.def", "zz{}.clo",
+};
+
+static void WriteProbes(const string& dir)
+{
+  Random random(10);
+  vector<string> names;
+  for (int idx = 0; idx < PROBES; ++idx)
+  {
+    if (random.Next(10) == 0)
+    {
+      names.push_back(PROBE_HITS[random.Next(sizeof(PROBE_HITS) / sizeof(PROBE_HITS[0]))]);
+      continue;
+    }
+    string name = PROBE_MISSES[random.Next(sizeof(PROBE_MISSES) / sizeof(PROBE_MISSES[0]))];
+    name.replace(name.find("{}"), 2, WORDS[random.Next(sizeof(WORDS) / sizeof(WORDS[0]))] + std::to_string(random.Next(PROBES)));
+    names.push_back(name);
+  }
+  ofstream list = Create(dir, "probes.txt");
+  for (const string& name : names)
+  {
+    list << name << "\n";
+  }
+  ofstream stream = Create(dir, "probes.tex");
+  stream
+    << "\\documentclass{article}\n"
+    << "\\newcount\\found\n"
+    << "\\newcount\\missed\n";
+  for (const string& name : names)
+  {
+    stream << "\\IfFileExists{" << name << "}{\\advance\\found1 }{\\advance\\missed1 }\n";
+  }
+  stream
+    << "\\typeout{found: \\the\\found, missed: \\the\\missed}\n"
+    << "\\begin{document}\n"
+    << "Probes: \\the\\found\\ found, \\the\\missed\\ missed.\n"
+    << "\\end{document}\n";
+}
+
+static void Put16(ofstream& stream, uint16_t value)
+{
+  stream.put(static_cast<char>(value & 0xff));
+  stream.put(static_cast<char>(value >> 8));
+}
+
+static void Put32(ofstream& stream, uint32_t value)
+{
+  Put16(stream, static_cast<uint16_t>(value & 0xffff));
+  Put16(stream, static_cast<uint16_t>(value >> 16));
+}
+
+// image-heavy document for dvipdfmx: uncompressed 24-bit BMP files
+static void WriteImages(const string& dir)
+{
+  Random random(9);
+  ofstream stream = Create(dir, "images.tex");
+  const uint32_t rowSize = IMAGE_SIZE * 3;
+  const uint32_t imageSize = rowSize * IMAGE_SIZE;
+  for (int idx = 0; idx < IMAGES; ++idx)
+  {
+    char fileName[32];
+    snprintf(fileName, sizeof(fileName), "image%03d.bmp", idx);
+    ofstream bmp = Create(dir, fileName);
+    bmp.write("BM", 2);
+    Put32(bmp, 54 + imageSize);
+    Put32(bmp, 0);
+    Put32(bmp, 54);
+    Put32(bmp, 40);
+    Put32(bmp, IMAGE_SIZE);
+    Put32(bmp, IMAGE_SIZE);
+    Put16(bmp, 1);
+    Put16(bmp, 24);
+    Put32(bmp, 0);
+    Put32(bmp, imageSize);
+    Put32(bmp, 2835);
+    Put32(bmp, 2835);
+    Put32(bmp, 0);
+    Put32(bmp, 0);
+    vector<char> row(rowSize);
+    for (int y = 0; y < IMAGE_SIZE; ++y)
+    {
+      for (int x = 0; x < IMAGE_SIZE; ++x)
+      {
+        // gradients with some noise: compressible, but not trivially
+        int noise = random.Next(16);
+        row[x * 3] = static_cast<char>((x + idx * 7 + noise) & 0xff);
+        row[x * 3 + 1] = static_cast<char>((y * 2 + noise) & 0xff);
+        row[x * 3 + 2] = static_cast<char>(((x ^ y) + idx) & 0xff);
+      }
+      bmp.write(row.data(), row.size());
+    }
+    // the image is placed with its lower left corner at the reference point
+    stream << "\\centerline{\\vbox to 12cm{\\vss\\hbox to 12cm{\\special{pdf:image width 12cm (" << fileName << ")}\\hfil}}}\\vfill\\eject\n";
+  }
+  stream << "\\bye\n";
+}
+
+int main(int argc, char** argv)
+{
+  if (argc != 2)
+  {
+    fprintf(stderr, "Usage: miktex-bench-corpus DIRECTORY\n");
+    return 1;
+  }
+  string dir = argv[1];
+  WriteProse(dir);
+  WriteLongLines(dir);
+  WriteLongLines8(dir);
+  WriteMath(dir);
+  WriteSnippet(dir);
+  WriteTikz(dir);
+  WritePackages(dir);
+  WriteUnicode(dir);
+  WriteBibliography(dir);
+  WriteBibLongLines(dir);
+  WriteIndex(dir);
+  WriteImages(dir);
+  WriteProbes(dir);
+  return 0;
+}
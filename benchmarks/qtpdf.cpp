@@ -0,0 +1,263 @@
+/* qtpdf.cpp: measure page rendering in the QtPDF viewer
+
+   Copyright (C) 2026 agent
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published
+   by the Free Software Foundation; either version 2, or (at your
+   option) any later version.
+
+   This file is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this file; if not, write to the Free Software
+   Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+   USA.  */
+
+/* Usage:
+
+     miktex-bench-qtpdf [--dpi N] FILE.pdf
+
+   Renders every page of FILE.pdf at N dpi (default: 144), first one
+   page after the other on the calling thread, then through the pool
+   of render threads.  Then opens a document view and measures the
+   time until the first page is on screen, and finally scrolls the
+   view from the first to the last page.  After each step, the clock
+   runs until the tiles of the visible pages are rendered and painted
+   from the cache.  Writes the time per page, to the first paint and
+   per scroll step to standard output.  Runs headless: the offscreen
+   platform is used unless QT_QPA_PLATFORM says otherwise. */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <iostream>
+#include <string>
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QScrollBar>
+#include <QThread>
+
+#include "PDFBackend.h"
+#include "PDFDocumentView.h"
+#include "backends/PopplerQtBackend.h"
+
+using namespace std;
+
+using namespace QtPDF;
+
+static void Fatal(const string& message)
+{
+  fprintf(stderr, "miktex-bench-qtpdf: %s\n", message.c_str());
+  exit(2);
+}
+
+class RenderListener : public QObject
+{
+public:
+  int pending = 0;
+protected:
+  bool event(QEvent* e) override
+  {
+    if (e->type() != Backend::PDFPageRenderedEvent::PageRenderedEvent)
+    {
+      return QObject::event(e);
+    }
+    if (--pending == 0)
+    {
+      QCoreApplication::quit();
+    }
+    return true;
+  }
+};
+
+static double RenderSerially(QSharedPointer<Backend::Document> doc, double dpi)
+{
+  doc->pageCache().clear();
+  QElapsedTimer timer;
+  timer.start();
+  for (int n = 0; n < doc->numPages(); ++n)
+  {
+    QSharedPointer<Backend::Page> page(doc->page(n).toStrongRef());
+    if (!page || page->renderToImage(dpi, dpi).isNull())
+    {
+      Fatal("page " + to_string(n + 1) + " could not be rendered");
+    }
+  }
+  return static_cast<double>(timer.nsecsElapsed()) / 1000000.0 / doc->numPages();
+}
+
+static double RenderInPool(QSharedPointer<Backend::Document> doc, double dpi)
+{
+  doc->pageCache().clear();
+  RenderListener listener;
+  QElapsedTimer timer;
+  timer.start();
+  for (int n = 0; n < doc->numPages(); ++n)
+  {
+    QSharedPointer<Backend::Page> page(doc->page(n).toStrongRef());
+    if (!page)
+    {
+      Fatal("page " + to_string(n + 1) + " could not be loaded");
+    }
+    ++listener.pending;
+    page->getTileImage(&listener, dpi, dpi);
+  }
+  QCoreApplication::exec();
+  return static_cast<double>(timer.nsecsElapsed()) / 1000000.0 / doc->numPages();
+}
+
+// Returns true when every tile the view needs for its visible pages has
+// been rendered.  The tiles are computed as in PDFPageGraphicsItem::paint;
+// tiles the view never asked for do not count.
+static bool VisibleTilesCached(QSharedPointer<Backend::Document> doc, PDFDocumentView& view, double dpi)
+{
+  QRectF visibleScene = view.mapToScene(view.viewport()->rect()).boundingRect();
+  qreal scaleFactor = view.transform().m11();
+  int dpr = view.viewport()->devicePixelRatio();
+  QTransform scaleT = QTransform::fromScale(scaleFactor, scaleFactor);
+  int effectiveTileSize = TILE_SIZE / dpr;
+  for (QGraphicsItem* item : view.scene()->items(visibleScene))
+  {
+    if (item->type() != PDFPageGraphicsItem::Type)
+    {
+      continue;
+    }
+    PDFPageGraphicsItem* pageItem = static_cast<PDFPageGraphicsItem*>(item);
+    QRectF exposed = pageItem->mapFromScene(visibleScene).boundingRect() & pageItem->boundingRect();
+    QRect pageRect = scaleT.mapRect(pageItem->boundingRect()).toAlignedRect();
+    QRect visibleRect = scaleT.mapRect(exposed).toAlignedRect();
+    int imin = (visibleRect.left() - pageRect.left()) / effectiveTileSize;
+    int imax = (visibleRect.right() - pageRect.left() + effectiveTileSize - 1) / effectiveTileSize;
+    int jmin = (visibleRect.top() - pageRect.top()) / effectiveTileSize;
+    int jmax = (visibleRect.bottom() - pageRect.top() + effectiveTileSize - 1) / effectiveTileSize;
+    for (int j = jmin; j < jmax; ++j)
+    {
+      for (int i = imin; i < imax; ++i)
+      {
+        Backend::PDFPageTile tile(dpi * scaleFactor * dpr, dpi * scaleFactor * dpr, QRect(i * TILE_SIZE, j * TILE_SIZE, TILE_SIZE, TILE_SIZE), pageItem->pageNum());
+        Backend::PDFPageCache::TileStatus status = doc->pageCache().getStatus(tile);
+        if (status == Backend::PDFPageCache::PLACEHOLDER || status == Backend::PDFPageCache::OUTDATED)
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Returns once the view shows the rendered tiles of all visible pages:
+// waits for the render threads to deliver them, then paints the view
+// from the page cache.
+static void WaitForTiles(QSharedPointer<Backend::Document> doc, PDFDocumentView& view, double dpi)
+{
+  for (;;)
+  {
+    QCoreApplication::processEvents();
+    if (VisibleTilesCached(doc, view, dpi))
+    {
+      break;
+    }
+    QThread::usleep(100);
+  }
+  view.viewport()->repaint();
+}
+
+static double FirstPaint(QSharedPointer<Backend::Document> doc, double dpi)
+{
+  doc->pageCache().clear();
+  QElapsedTimer timer;
+  timer.start();
+  PDFDocumentView view;
+  view.resize(800, 1000);
+  view.setScene(QSharedPointer<PDFDocumentScene>(new PDFDocumentScene(doc, nullptr, dpi, dpi)));
+  view.setOneColContPageMode();
+  view.show();
+  WaitForTiles(doc, view, dpi);
+  double result = static_cast<double>(timer.nsecsElapsed()) / 1000000.0;
+  doc->processingThread().clearWorkStack();
+  return result;
+}
+
+static double ScrollThrough(QSharedPointer<Backend::Document> doc, double dpi, int* steps)
+{
+  doc->pageCache().clear();
+  PDFDocumentView view;
+  view.resize(800, 1000);
+  view.setScene(QSharedPointer<PDFDocumentScene>(new PDFDocumentScene(doc, nullptr, dpi, dpi)));
+  view.setOneColContPageMode();
+  view.show();
+  WaitForTiles(doc, view, dpi);
+  QScrollBar* scrollBar = view.verticalScrollBar();
+  int step = qMax(1, view.viewport()->height() / 4);
+  *steps = 0;
+  QElapsedTimer timer;
+  timer.start();
+  for (int value = scrollBar->minimum(); ; value += step)
+  {
+    scrollBar->setValue(qMin(value, scrollBar->maximum()));
+    view.viewport()->repaint();
+    WaitForTiles(doc, view, dpi);
+    ++*steps;
+    if (value >= scrollBar->maximum())
+    {
+      break;
+    }
+  }
+  double result = static_cast<double>(timer.nsecsElapsed()) / 1000000.0 / *steps;
+  doc->processingThread().clearWorkStack();
+  return result;
+}
+
+int main(int argc, char** argv)
+{
+  if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+  {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+  QApplication app(argc, argv);
+  double dpi = 144;
+  const char* fileName = nullptr;
+  for (int idx = 1; idx < argc; ++idx)
+  {
+    if (strcmp(argv[idx], "--dpi") == 0)
+    {
+      if (++idx >= argc)
+      {
+        Fatal("missing argument for --dpi");
+      }
+      dpi = atof(argv[idx]);
+    }
+    else if (fileName == nullptr)
+    {
+      fileName = argv[idx];
+    }
+    else
+    {
+      Fatal(string("unexpected argument ") + argv[idx]);
+    }
+  }
+  if (fileName == nullptr || dpi <= 0)
+  {
+    Fatal("usage: miktex-bench-qtpdf [--dpi N] FILE.pdf");
+  }
+  QSharedPointer<Backend::Document> doc(new Backend::PopplerQt::Document(QString::fromLocal8Bit(fileName)));
+  if (!doc->isValid() || doc->numPages() <= 0)
+  {
+    Fatal(string(fileName) + " could not be loaded");
+  }
+  cout << "pages: " << doc->numPages() << endl;
+  cout << "render (serial): " << RenderSerially(doc, dpi) << "ms per page" << endl;
+  cout << "render (threads): " << RenderInPool(doc, dpi) << "ms per page" << endl;
+  cout << "first paint: " << FirstPaint(doc, dpi) << "ms" << endl;
+  int steps;
+  double msPerStep = ScrollThrough(doc, dpi, &steps);
+  cout << "scroll: " << msPerStep << "ms per step (" << steps << " steps)" << endl;
+  return 0;
+}
@@ -0,0 +1,231 @@
+## run-benchmarks.cmake: run the benchmark cases        -*- CMake -*-
+##
+## Copyright (C) 2026 agent
+## 
+## This file is free software; you can redistribute it and/or modify
+## it under the terms of the GNU General Public License as published
+## by the Free Software Foundation; either version 2, or (at your
+## option) any later version.
+## 
+## This file is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+## General Public License for more details.
+## 
+## You should have received a copy of the GNU General Public License
+## along with this file; if not, write to the Free Software
+## Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+## USA.
+
+## Usage:
+##
+##   cmake -DBENCH=... -DCORPUS_DIR=... -DWORK_DIR=... -DRESULTS_FILE=...
+##         [-DBIN_DIR=...] [-DREPEAT=N] [-DSTRACE=...] [-DCASES=a;b]
+##         [-DCOMPARE_BIN_DIR=...] [-DSPAWN=...] [-DQTPDF=...]
+##         -P run-benchmarks.cmake
+##
+## The programs must find their formats and packages without going
+## online, i.e., the MiKTeX installation must be set up beforehand.
+## A failing case does not stop the run; it is reported with a
+## non-zero exit_code.
+
+cmake_minimum_required(VERSION 3.12)
+
+foreach(v BENCH CORPUS_DIR WORK_DIR RESULTS_FILE)
+  if(NOT ${v})
+    message(FATAL_ERROR "${v} is not set")
+  endif()
+endforeach()
+
+if(NOT REPEAT)
+  set(REPEAT 3)
+endif()
+
+set(bench_options --repeat ${REPEAT})
+if(STRACE)
+  list(APPEND bench_options --strace ${STRACE})
+endif()
+
+## start from a pristine copy of the corpus
+file(REMOVE_RECURSE ${WORK_DIR})
+file(COPY ${CORPUS_DIR}/ DESTINATION ${WORK_DIR})
+
+set(results "")
+
+## benchmark_case(NAME PROGRAM [INPUT FILE] [LOOP M] [REQUESTS M] [ARG...])
+##
+## LOOP and REQUESTS are passed on to miktex-bench as --loop and
+## --requests: a case that serves M requests reports requests per
+## second.
+##
+## With COMPARE_BIN_DIR, a case whose program is looked up by name runs
+## a second time, as NAME-compare, with the program found there.  This
+## times two builds against each other, e.g., one configured with
+## WITH_C4P_OPTIMIZE and one without, or the current and the previous
+## tree.
+function(benchmark_case name program)
+  if(CASES AND NOT name IN_LIST CASES)
+    return()
+  endif()
+  cmake_parse_arguments(PARSE_ARGV 2 case "" "INPUT;LOOP;REQUESTS" "")
+  set(case_options ${bench_options})
+  if(case_INPUT)
+    list(APPEND case_options --input ${case_INPUT})
+  endif()
+  if(case_LOOP)
+    list(APPEND case_options --loop ${case_LOOP})
+  endif()
+  if(case_REQUESTS)
+    list(APPEND case_options --requests ${case_REQUESTS})
+  endif()
+  set(runs ${name})
+  if(IS_ABSOLUTE ${program})
+    if(EXISTS ${program})
+      set(program_path_${name} ${program})
+    endif()
+  else()
+    if(BIN_DIR)
+      find_program(program_path_${name} ${program} PATHS ${BIN_DIR} NO_DEFAULT_PATH)
+    else()
+      find_program(program_path_${name} ${program})
+    endif()
+    if(COMPARE_BIN_DIR)
+      find_program(program_path_${name}-compare ${program} PATHS ${COMPARE_BIN_DIR} NO_DEFAULT_PATH)
+      list(APPEND runs ${name}-compare)
+    endif()
+  endif()
+  foreach(run ${runs})
+    set(path ${program_path_${run}})
+    if(NOT path)
+      message(STATUS "${run}: ${program} not found")
+      set(json "{\"name\": \"${run}\", \"command\": [\"${program}\"], \"exit_code\": null, \"skipped\": \"program not found\"}")
+    else()
+      message(STATUS "${run}")
+      execute_process(
+        COMMAND ${BENCH} ${case_options} ${run} ${run}.log -- ${path} ${case_UNPARSED_ARGUMENTS}
+        WORKING_DIRECTORY ${WORK_DIR}
+        OUTPUT_VARIABLE json
+        OUTPUT_STRIP_TRAILING_WHITESPACE
+        RESULT_VARIABLE exit_code
+      )
+      if(NOT exit_code EQUAL 0)
+        message(STATUS "${run}: failed (see ${WORK_DIR}/${run}.log)")
+      endif()
+    endif()
+    if(results)
+      set(results "${results},\n  ${json}")
+    else()
+      set(results "  ${json}")
+    endif()
+  endforeach()
+  set(results "${results}" PARENT_SCOPE)
+endfunction()
+
+## the order matters: later cases use the output of earlier ones
+
+## engines and the line reader
+benchmark_case(tex-prose tex -interaction=batchmode prose.tex)
+benchmark_case(tex-longlines tex -interaction=batchmode longlines.tex)
+benchmark_case(tex-math tex -interaction=batchmode math.tex)
+benchmark_case(pdftex-prose pdftex -interaction=batchmode prose.tex)
+benchmark_case(pdftex-longlines pdftex -interaction=batchmode longlines.tex)
+benchmark_case(pdftex-longlines8 pdftex -interaction=batchmode longlines8.tex)
+benchmark_case(pdftex-math pdftex -interaction=batchmode math.tex)
+benchmark_case(xetex-prose xetex -interaction=batchmode prose.tex)
+benchmark_case(xetex-longlines xetex -interaction=batchmode longlines.tex)
+benchmark_case(xetex-longlines8 xetex -interaction=batchmode longlines8.tex)
+benchmark_case(luatex-prose luatex -interaction=batchmode prose.tex)
+benchmark_case(luatex-longlines luatex -interaction=batchmode longlines.tex)
+benchmark_case(luatex-longlines8 luatex -interaction=batchmode longlines8.tex)
+
+## LaTeX documents with many packages
+benchmark_case(pdflatex-tikz pdflatex -interaction=batchmode tikz.tex)
+benchmark_case(pdflatex-packages pdflatex -interaction=batchmode packages.tex)
+benchmark_case(xelatex-unicode xelatex -interaction=batchmode unicode.tex)
+benchmark_case(lualatex-unicode lualatex -interaction=batchmode unicode.tex)
+
+## bibliography and index processing
+benchmark_case(bibtex-large bibtex biblio)
+benchmark_case(bibtex8-large bibtex8 biblio)
+benchmark_case(bibtex-longlines bibtex longlines)
+benchmark_case(makeindex-large makeindex -q index.idx)
+
+## DVI drivers
+benchmark_case(tex-images tex -interaction=batchmode images.tex)
+benchmark_case(dvips-prose dvips -q -o prose.ps prose.dvi)
+benchmark_case(dvipdfmx-prose dvipdfmx -q prose.dvi)
+benchmark_case(dvipdfmx-images dvipdfmx -q images.dvi)
+benchmark_case(dvipdfmx-images-threads dvipdfmx -q --compression-threads 4 images.dvi)
+benchmark_case(dvisvgm-math dvisvgm --page=1- math.dvi)
+benchmark_case(dvipng-prose dvipng -q -o prose-%d.png prose.dvi)
+benchmark_case(dvipng-prose-j4 dvipng -q -j 4 -o prose-%d.png prose.dvi)
+
+## dvipng as a formula renderer: the same requests served by one
+## --daemon process and by a one-shot run each; compare their
+## requests_per_second
+set(dvipng_requests 100)
+benchmark_case(tex-snippet tex -interaction=batchmode snippet.tex)
+set(snippet_requests "")
+foreach(idx RANGE 1 ${dvipng_requests})
+  string(APPEND snippet_requests "-o snippet-daemon.png snippet.dvi\n")
+endforeach()
+file(WRITE ${WORK_DIR}/snippet-requests.txt "${snippet_requests}")
+benchmark_case(dvipng-snippet-oneshot dvipng LOOP ${dvipng_requests} -q -D 150 -T tight -o snippet-oneshot.png snippet.dvi)
+benchmark_case(dvipng-snippet-daemon dvipng INPUT snippet-requests.txt REQUESTS ${dvipng_requests} --daemon -q -D 150 -T tight)
+
+## file name lookups: resolve the fonts of the installed pdftex.map,
+## one name at a time and as a batch
+if(BIN_DIR)
+  find_program(kpsewhich_path kpsewhich PATHS ${BIN_DIR} NO_DEFAULT_PATH)
+else()
+  find_program(kpsewhich_path kpsewhich)
+endif()
+set(map_file "")
+if(kpsewhich_path)
+  execute_process(
+    COMMAND ${kpsewhich_path} pdftex.map
+    OUTPUT_VARIABLE map_file
+    OUTPUT_STRIP_TRAILING_WHITESPACE
+  )
+endif()
+set(map_fonts "")
+if(map_file AND EXISTS ${map_file})
+  file(STRINGS ${map_file} map_lines REGEX "^[^%#*; \t]")
+  foreach(line IN LISTS map_lines)
+    string(REGEX MATCH "^[^ \t]+" tfm "${line}")
+    list(APPEND map_fonts ${tfm}.tfm)
+    string(REGEX MATCHALL "<[<[]?[^ \t\"<]+\\.(pfb|pfa|otf|ttf)" font_files "${line}")
+    foreach(font_file IN LISTS font_files)
+      string(REGEX REPLACE "^<[<[]?" "" font_file ${font_file})
+      list(APPEND map_fonts ${font_file})
+    endforeach()
+  endforeach()
+  list(REMOVE_DUPLICATES map_fonts)
+  list(LENGTH map_fonts num_map_fonts)
+  message(STATUS "${num_map_fonts} font files in ${map_file}")
+else()
+  message(STATUS "pdftex.map not found: font lookups have nothing to do")
+endif()
+string(REPLACE ";" "\n" map_fonts "${map_fonts}")
+file(WRITE ${WORK_DIR}/mapfonts.txt "${map_fonts}\n")
+benchmark_case(kpsewhich-mapfonts kpsewhich INPUT mapfonts.txt -interactive)
+benchmark_case(kpsewhich-mapfonts-batch kpsewhich INPUT mapfonts.txt -stdin)
+
+## file name probes, nine out of ten miss (a synthetic list, see
+## corpus.cpp); kpsewhich exits with the number of names not found
+benchmark_case(pdflatex-probes pdflatex -interaction=batchmode probes.tex)
+benchmark_case(kpsewhich-probes kpsewhich INPUT probes.txt -interactive)
+benchmark_case(kpsewhich-probes-batch kpsewhich INPUT probes.txt -stdin)
+
+## process creation from a parent with a large resident set
+if(SPAWN)
+  benchmark_case(process-spawn ${SPAWN} --rss 256 --count 1000)
+endif()
+
+# renders the output of the pdftex-prose case
+if(QTPDF AND EXISTS ${WORK_DIR}/prose.pdf)
+  benchmark_case(qtpdf-render-prose ${QTPDF} prose.pdf)
+endif()
+
+file(WRITE ${RESULTS_FILE} "[\n${results}\n]\n")
+message(STATUS "Results written to ${RESULTS_FILE}")
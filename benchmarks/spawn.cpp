@@ -0,0 +1,122 @@
+/* spawn.cpp: measure the cost of spawning child processes
+
+   Copyright (C) 2026 agent
+
+   This file is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published
+   by the Free Software Foundation; either version 2, or (at your
+   option) any later version.
+
+   This file is distributed in the hope that it will be useful, but
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this file; if not, write to the Free Software
+   Foundation, 59 Temple Place - Suite 330, Boston, MA 02111-1307,
+   USA.  */
+
+/* Usage:
+
+     miktex-bench-spawn [--rss MB] [--count N]
+
+   Spawns itself N times (default: 1000) through the Process API of
+   the MiKTeX Core Library, from a parent with MB megabytes resident
+   (default: 256), first without and then with output redirection.
+   Writes the time per child process to standard output.  A large
+   resident set is what makes fork() expensive. */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <miktex/Core/Process>
+#include <miktex/Core/Session>
+
+using namespace std;
+
+using namespace MiKTeX::Core;
+
+static void Fatal(const string& message)
+{
+  fprintf(stderr, "miktex-bench-spawn: %s\n", message.c_str());
+  exit(2);
+}
+
+static double SpawnChildren(const PathName& self, int count, bool redirect)
+{
+  auto start = chrono::steady_clock::now();
+  for (int n = 0; n < count; ++n)
+  {
+    int exitCode = -1;
+    if (redirect)
+    {
+      ProcessOutput<16> processOutput;
+      if (!Process::Run(self, { self.ToString(), "--child", "ok" }, &processOutput, &exitCode, nullptr) || exitCode != 0 || processOutput.StdoutToString() != "ok\n")
+      {
+        Fatal("child process failed");
+      }
+    }
+    else
+    {
+      if (!Process::Run(self, { self.ToString(), "--child" }, nullptr, &exitCode, nullptr) || exitCode != 0)
+      {
+        Fatal("child process failed");
+      }
+    }
+  }
+  return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / count;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc >= 2 && strcmp(argv[1], "--child") == 0)
+  {
+    for (int idx = 2; idx < argc; ++idx)
+    {
+      cout << argv[idx] << endl;
+    }
+    return 0;
+  }
+  size_t rssMb = 256;
+  int count = 1000;
+  for (int idx = 1; idx < argc; idx += 2)
+  {
+    if (idx + 1 >= argc)
+    {
+      Fatal(string("missing argument for ") + argv[idx]);
+    }
+    if (strcmp(argv[idx], "--rss") == 0)
+    {
+      rssMb = atoi(argv[idx + 1]);
+    }
+    else if (strcmp(argv[idx], "--count") == 0)
+    {
+      count = max(1, atoi(argv[idx + 1]));
+    }
+    else
+    {
+      Fatal(string("unknown option ") + argv[idx]);
+    }
+  }
+  shared_ptr<Session> session = Session::Create(Session::InitInfo(argv[0]));
+  PathName self = session->GetMyProgramFile(true);
+  // touch every page so that it is really resident
+  vector<char> ballast(rssMb * 1024 * 1024);
+  for (size_t idx = 0; idx < ballast.size(); idx += 4096)
+  {
+    ballast[idx] = static_cast<char>(idx);
+  }
+  cout << "spawn: " << SpawnChildren(self, count, false) << "us per child process" << endl;
+  cout << "spawn (redirected): " << SpawnChildren(self, count, true) << "us per child process" << endl;
+  session = nullptr;
+  return 0;
+}
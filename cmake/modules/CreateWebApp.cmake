@@ -177,6 +177,12 @@ MIKTEX_DEFINE_WEBAPP(MiKTeX_${_name_u},
     set(_sed_script ${CMAKE_CURRENT_SOURCE_DIR}/dyn.sed)
   endif()
 
+  if(C4P_PROFILE)
+    set(_c4p_profile_flag --profile=${C4P_PROFILE})
+  else()
+    set(_c4p_profile_flag)
+  endif()
+
   add_custom_command(
     OUTPUT
       ${CMAKE_CURRENT_BINARY_DIR}/${_short_name_l}.cc
@@ -193,6 +199,7 @@ MIKTEX_DEFINE_WEBAPP(MiKTeX_${_name_u},
       -C
       --class=${_name}Program
       ${C4P_FLAGS}
+      ${_c4p_profile_flag}
       ${CMAKE_CURRENT_BINARY_DIR}/${_short_name_l}.p
     COMMAND
       ${CMAKE_COMMAND} -E rename ${${_short_name_l}_header_file} ${${_short_name_l}_header_file}.intermediate
@@ -202,6 +209,7 @@ MIKTEX_DEFINE_WEBAPP(MiKTeX_${_name_u},
       ${CMAKE_CURRENT_BINARY_DIR}/${_short_name_l}.p
     DEPENDS
       c4p
+      ${C4P_PROFILE}
     VERBATIM
   )
 
@@ -60,6 +60,7 @@ define_library(egl_registry)
 define_library(expat)
 define_library(extractor)
 define_library(fmt)
+define_library(fontcache)
 define_library(fontconfig)
 define_library(freeglut)
 define_library(freetype2)
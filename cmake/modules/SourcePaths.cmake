@@ -60,6 +60,7 @@ set(MIKTEX_REL_EXPAT_DIR                "Libraries/3rd/expat")
 set(MIKTEX_REL_EXTRACTOR_DIR            "Libraries/MiKTeX/Extractor")
 set(MIKTEX_REL_FINDTEXMF_DIR            "Programs/MiKTeX/findtexmf")
 set(MIKTEX_REL_FMT_DIR                  "Libraries/3rd/fmt")
+set(MIKTEX_REL_FONTCACHE_DIR            "Libraries/MiKTeX/FontCache")
 set(MIKTEX_REL_FONTCONFIG_DIR           "Libraries/3rd/fontconfig")
 set(MIKTEX_REL_FREEGLUT_DIR             "Libraries/3rd/freeglut")
 set(MIKTEX_REL_FREETYPE2_DIR            "Libraries/3rd/freetype2")